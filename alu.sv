@@ -26,6 +26,9 @@
 import riscv_defines::*;
 
 module riscv_alu
+#(
+  parameter FAST_DIV = 0    // radix-4 divider with dividend leading zero skipping
+)
 (
   input  logic                     clk,
   input  logic                     rst_n,
@@ -815,6 +818,7 @@ module riscv_alu
   logic        div_op_a_signed;
   logic        div_op_b_signed;
   logic [5:0]  div_shift_int;
+  logic [5:0]  div_shift_norm;
 
   assign div_signed = operator_i[0];
 
@@ -822,14 +826,38 @@ module riscv_alu
   assign div_op_b_signed = operand_b_i[31] & div_signed;
 
   assign div_shift_int = ff_no_one ? 6'd31 : clb_result;
-  assign div_shift = div_shift_int + (div_op_a_signed ? 6'd0 : 6'd1);
+  assign div_shift_norm = div_shift_int + (div_op_a_signed ? 6'd0 : 6'd1);
+
+  // With non-negative operands the quotient bits above the leading one of the
+  // dividend are zero: start with the divisor shifted only as far as the
+  // dividend's leading one, which skips those iterations
+  generate
+    if (FAST_DIV) begin : g_div_skip
+      // inputs A and B are swapped, as for the divider
+      riscv_alu_div_skip div_skip_i
+      (
+        .OpA_DI       ( operand_b_i       ),
+        .OpASign_SI   ( div_op_b_signed   ),
+        .OpBSign_SI   ( div_op_a_signed   ),
+        .OpBIsZero_SI ( (cnt_result == 0) ),
+        .OpBShift_DI  ( div_shift_norm    ),
+        .OpBShift_DO  ( div_shift         )
+      );
+    end else begin : g_no_div_skip
+      assign div_shift = div_shift_norm;
+    end
+  endgenerate
 
   assign div_valid = (operator_i == ALU_DIV) || (operator_i == ALU_DIVU) ||
                      (operator_i == ALU_REM) || (operator_i == ALU_REMU);
 
 
   // inputs A and B are swapped
-  riscv_alu_div div_i
+  riscv_alu_div
+  #(
+    .C_RADIX4     ( FAST_DIV          )
+  )
+  div_i
   (
     .Clk_CI       ( clk               ),
     .Rst_RBI      ( rst_n             ),
@@ -15,6 +15,8 @@
 ///////////////////////////////////////////////////////////////////////////////
 //
 // Description: this is a simple serial divider for signed integers (int32).
+//              With C_RADIX4 two divide steps are chained per cycle, which
+//              halves the DIVIDE phase; results are bit-identical.
 //
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -26,7 +28,8 @@
 module riscv_alu_div
 #(
    parameter C_WIDTH     = 32,
-   parameter C_LOG_WIDTH = 6
+   parameter C_LOG_WIDTH = 6,
+   parameter C_RADIX4    = 0
 )
 (
     input  logic                    Clk_CI,
@@ -66,8 +69,14 @@ module riscv_alu_div
   logic [C_WIDTH-1:0] BMux_D;
   logic [C_WIDTH-1:0] OutMux_D;
 
+  logic [C_WIDTH-1:0] AStep_D;
+  logic [C_WIDTH-1:0] BStep_D;
+  logic [C_WIDTH-1:0] AStepSub_D;
+  logic               ABComp2_S;
+
   logic [C_LOG_WIDTH-1:0] Cnt_DP, Cnt_DN;
-  logic CntZero_S;
+  logic CntZero_S, CntOne_S;
+  logic DoubleStep_S;
 
   logic ARegEn_S, BRegEn_S, ResRegEn_S, ABComp_S, PmSel_S, LoadEn_S;
 
@@ -99,14 +108,22 @@ module riscv_alu_div
   assign AddTmp_D    = (LoadEn_S) ? 0 : AReg_DP;
   assign AddOut_D    = (PmSel_S)  ? AddTmp_D + AddMux_D : AddTmp_D - $signed(AddMux_D);
 
+  // second divide step of the cycle, operates on the result of the first one
+  assign AStep_D     = (ABComp_S) ? AddOut_D : AReg_DP;
+  assign BStep_D     = {CompInv_SP, (BReg_DP[$high(BReg_DP):1])};
+  assign ABComp2_S   = ((AStep_D == BStep_D) | ((AStep_D > BStep_D) ^ CompInv_SP)) & ((|AStep_D) | OpBIsZero_SI);
+  assign AStepSub_D  = AStep_D - $signed(BStep_D);
+
   ///////////////////////////////////////////////////////////////////////////////
   // counter
   ///////////////////////////////////////////////////////////////////////////////
 
-  assign Cnt_DN      = (LoadEn_S)   ? OpBShift_DI :
-                       (~CntZero_S) ? Cnt_DP - 1  : Cnt_DP;
+  assign Cnt_DN      = (LoadEn_S)     ? OpBShift_DI :
+                       (DoubleStep_S) ? ((CntOne_S) ? '0 : Cnt_DP - 2) :
+                       (~CntZero_S)   ? Cnt_DP - 1  : Cnt_DP;
 
   assign CntZero_S   = ~(|Cnt_DP);
+  assign CntOne_S    = (Cnt_DP == 1);
 
   ///////////////////////////////////////////////////////////////////////////////
   // FSM
@@ -124,6 +141,7 @@ module riscv_alu_div
     ARegEn_S       = 1'b0;
     BRegEn_S       = 1'b0;
     ResRegEn_S     = 1'b0;
+    DoubleStep_S   = 1'b0;
 
     case (State_SP)
       /////////////////////////////////
@@ -144,10 +162,11 @@ module riscv_alu_div
         ARegEn_S     = ABComp_S;
         BRegEn_S     = 1'b1;
         ResRegEn_S   = 1'b1;
+        DoubleStep_S = (C_RADIX4 != 0) & ~CntZero_S;
 
         // calculation finished
         // one more divide cycle (32nd divide cycle)
-        if (CntZero_S) begin
+        if (CntZero_S || (DoubleStep_S && CntOne_S)) begin
           State_SN   = FINISH;
         end
       end
@@ -175,10 +194,13 @@ module riscv_alu_div
   assign CompInv_SN = (LoadEn_S) ? OpBSign_SI   : CompInv_SP;
   assign ResInv_SN  = (LoadEn_S) ? (~OpBIsZero_SI | OpCode_SI[1]) & OpCode_SI[0] & (OpA_DI[$high(OpA_DI)] ^ OpBSign_SI) : ResInv_SP;
 
-  assign AReg_DN   = (ARegEn_S)   ? AddOut_D : AReg_DP;
-  assign BReg_DN   = (BRegEn_S)   ? BMux_D   : BReg_DP;
-  assign ResReg_DN = (LoadEn_S)   ? '0       :
-                     (ResRegEn_S) ? {ABComp_S, ResReg_DP[$high(ResReg_DP):1]} : ResReg_DP;
+  assign AReg_DN   = (DoubleStep_S) ? ((ABComp2_S) ? AStepSub_D : AStep_D) :
+                     (ARegEn_S)     ? AddOut_D : AReg_DP;
+  assign BReg_DN   = (DoubleStep_S) ? {CompInv_SP, CompInv_SP, (BReg_DP[$high(BReg_DP):2])} :
+                     (BRegEn_S)     ? BMux_D   : BReg_DP;
+  assign ResReg_DN = (LoadEn_S)     ? '0       :
+                     (DoubleStep_S) ? {ABComp2_S, ABComp_S, ResReg_DP[$high(ResReg_DP):2]} :
+                     (ResRegEn_S)   ? {ABComp_S, ResReg_DP[$high(ResReg_DP):1]} : ResReg_DP;
 
   always_ff @(posedge Clk_CI or negedge Rst_RBI) begin : p_regs
     if(~Rst_RBI) begin
@@ -214,3 +236,41 @@ module riscv_alu_div
 `endif
 
 endmodule // serDiv
+
+
+///////////////////////////////////////////////////////////////////////////////
+// Dividend zero skipping (riscv_alu with FAST_DIV): with non-negative
+// operands the quotient bits above the leading one of the dividend are zero,
+// so the divisor is normalized only up to that bit. Returns the shift to use
+// in place of OpBShift_DI, the full normalizing shift of the divisor.
+///////////////////////////////////////////////////////////////////////////////
+
+module riscv_alu_div_skip
+#(
+   parameter C_WIDTH     = 32,
+   parameter C_LOG_WIDTH = 6
+)
+(
+    input  logic [C_WIDTH-1:0]      OpA_DI,       // dividend
+    input  logic                    OpASign_SI,   // gate this to 0 in case of unsigned ops
+    input  logic                    OpBSign_SI,   // gate this to 0 in case of unsigned ops
+    input  logic                    OpBIsZero_SI,
+    input  logic [C_LOG_WIDTH-1:0]  OpBShift_DI,
+    output logic [C_LOG_WIDTH-1:0]  OpBShift_DO
+  );
+
+  logic                   Skip_S;
+  logic [C_LOG_WIDTH-1:0] ALz_D;
+
+  // leading zeros of the dividend, C_WIDTH when it is zero
+  always_comb begin : p_lz
+    ALz_D = C_WIDTH;
+    for (int i = 0; i < C_WIDTH; i++)
+      if (OpA_DI[i]) ALz_D = C_WIDTH-1-i;
+  end
+
+  assign Skip_S      = ~OpASign_SI & ~OpBSign_SI & ~OpBIsZero_SI;
+  assign OpBShift_DO = ~Skip_S               ? OpBShift_DI         :
+                       (OpBShift_DI > ALz_D) ? OpBShift_DI - ALz_D : '0;
+
+endmodule // riscv_alu_div_skip
@@ -66,6 +66,7 @@ module riscv_controller
 
   // jump/branch signals
   input  logic        branch_taken_ex_i,          // branch taken signal from EX ALU
+  input  logic        branch_redirect_id_i,       // branch predicted taken in ID, fetch its target
   input  logic [1:0]  jump_in_id_i,               // jump is being calculated in ALU
   input  logic [1:0]  jump_in_dec_i,              // jump is being calculated in ALU
 
@@ -101,6 +102,8 @@ module riscv_controller
   input logic         reg_d_ex_is_reg_a_i,
   input logic         reg_d_ex_is_reg_b_i,
   input logic         reg_d_ex_is_reg_c_i,
+  input logic         reg_d_ex_is_reg_pair_i,     // rs1+1/rs2+1 of an 8 lane dot product
+  input logic         ld_fwd_ok_i,                // load data can be forwarded in EX instead
   input logic         reg_d_wb_is_reg_a_i,
   input logic         reg_d_wb_is_reg_b_i,
   input logic         reg_d_wb_is_reg_c_i,
@@ -271,9 +274,9 @@ module riscv_controller
 
           // handle unconditional jumps
           // we can jump directly since we know the address already
-          // we don't need to worry about conditional branches here as they
-          // will be evaluated in the EX stage
-          if (jump_in_dec_i == BRANCH_JALR || jump_in_dec_i == BRANCH_JAL) begin
+          // conditional branches are evaluated in the EX stage, the ones
+          // predicted taken are fetched from here like a jump
+          if (jump_in_dec_i == BRANCH_JALR || jump_in_dec_i == BRANCH_JAL || branch_redirect_id_i) begin
             pc_mux_o = PC_JUMP;
 
             // if there is a jr stall, wait for it to be gone
@@ -494,9 +497,10 @@ module riscv_controller
     if (illegal_insn_i)
       deassert_we_o = 1'b1;
 
-    // Stall because of load operation
-    if ((data_req_ex_i == 1'b1) && (regfile_we_ex_i == 1'b1) &&
-        ((reg_d_ex_is_reg_a_i == 1'b1) || (reg_d_ex_is_reg_b_i == 1'b1) || (reg_d_ex_is_reg_c_i == 1'b1)) )
+    // Stall because of load operation, unless the data is forwarded in EX
+    if ((data_req_ex_i == 1'b1) && (regfile_we_ex_i == 1'b1) && (ld_fwd_ok_i == 1'b0) &&
+        ((reg_d_ex_is_reg_a_i == 1'b1) || (reg_d_ex_is_reg_b_i == 1'b1) || (reg_d_ex_is_reg_c_i == 1'b1) ||
+         (reg_d_ex_is_reg_pair_i == 1'b1)) )
     begin
       deassert_we_o   = 1'b1;
       load_stall_o    = 1'b1;
@@ -588,8 +592,8 @@ module riscv_controller
   // Assertions
   //----------------------------------------------------------------------------
 
-  // make sure that taken branches do not happen back-to-back, as this is not
-  // possible without branch prediction in the IF stage
+  // make sure that branch redirects from EX do not happen back-to-back, the
+  // instruction following a redirect is always a bubble
   assert property (
     @(posedge clk) (branch_taken_ex_i) |=> (~branch_taken_ex_i) ) else $warning("Two branches back-to-back are taken");
 `endif
@@ -35,7 +35,8 @@ module riscv_cs_registers
 #(
   parameter N_HWLP       = 2,
   parameter N_HWLP_BITS  = $clog2(N_HWLP),
-  parameter N_EXT_CNT    = 0
+  parameter N_EXT_CNT    = 0,
+  parameter PERF_CNT64   = 0    // 64 bit PCCRs, upper halves at 0x7E0 + i
 )
 (
   // Clock and Reset
@@ -87,16 +88,20 @@ module riscv_cs_registers
   input  logic                 jump_i,            // jump instruction seen   (j, jr, jal, jalr)
   input  logic                 branch_i,          // branch instruction seen (bf, bnf)
   input  logic                 branch_taken_i,    // branch was taken
+  input  logic                 branch_mispred_i,  // branch went the other way than predicted
+  input  logic                 btb_miss_i,        // branch predicted taken in ID, not by the BTB
   input  logic                 ld_stall_i,        // load use hazard
   input  logic                 jr_stall_i,        // jump register use hazard
 
   input  logic                 mem_load_i,        // load from memory in this cycle
   input  logic                 mem_store_i,       // store to memory in this cycle
 
-  input  logic [N_EXT_CNT-1:0] ext_counters_i
+  input  logic [N_EXT_CNT-1:0] ext_counters_i,
+  output logic                 perf_irq_o         // counter overflow interrupt (level)
 );
 
-  localparam N_PERF_COUNTERS = 11 + N_EXT_CNT;
+  localparam N_PERF_COUNTERS = 13 + N_EXT_CNT;
+  localparam PERF_CNT_W      = PERF_CNT64 ? 64 : 32;
 
 `ifdef ASIC_SYNTHESIS
   localparam N_PERF_REGS     = 1;
@@ -109,16 +114,24 @@ module riscv_cs_registers
   logic [N_PERF_COUNTERS-1:0]    PCCR_in;  // input signals for each counter category
   logic [N_PERF_COUNTERS-1:0]    PCCR_inc, PCCR_inc_q; // should the counter be increased?
 
-  logic [N_PERF_REGS-1:0] [31:0] PCCR_q, PCCR_n; // performance counters counter register
+  logic [N_PERF_REGS-1:0] [PERF_CNT_W-1:0] PCCR_q, PCCR_n; // performance counters counter register
+  logic [N_PERF_REGS-1:0] [31:0] PCPRE_q, PCPRE_n; // value loaded on an overflow with interrupt enabled
   logic [1:0]                    PCMR_n, PCMR_q; // mode register, controls saturation and global enable
   logic [N_PERF_COUNTERS-1:0]    PCER_n, PCER_q; // selected counter input
+  logic [N_PERF_COUNTERS-1:0]    PCOIE_n, PCOIE_q; // overflow interrupt enable
+  logic [N_PERF_COUNTERS-1:0]    PCOVF_n, PCOVF_q; // sticky overflow flags
+  logic [N_PERF_COUNTERS-1:0]    pccr_ovf;         // counter wraps this cycle
 
   logic [31:0]                   perf_rdata;
   logic [4:0]                    pccr_index;
   logic                          pccr_all_sel;
   logic                          is_pccr;
+  logic                          is_pccrh;
+  logic                          is_pcpre;
   logic                          is_pcer;
   logic                          is_pcmr;
+  logic                          is_pcoie;
+  logic                          is_pcovf;
 
   // CSR update logic
   logic [31:0] csr_wdata_int;
@@ -161,6 +174,8 @@ module riscv_cs_registers
       12'hF01: csr_rdata_int = 32'h00_00_80_00;
       // mhartid: unique hardware thread id
       12'hF10: csr_rdata_int = {21'b0, cluster_id_i[5:0], 1'b0, core_id_i[3:0]};
+      // mhartid at its privileged-spec address
+      12'hF14: csr_rdata_int = {21'b0, cluster_id_i[5:0], 1'b0, core_id_i[3:0]};
 
       // hardware loops
       12'h7B0: csr_rdata_int = hwlp_start_i[0];
@@ -259,7 +274,7 @@ module riscv_cs_registers
     csr_rdata_o = csr_rdata_int;
 
     // performance counters
-    if (is_pccr || is_pcer || is_pcmr)
+    if (is_pccr || is_pccrh || is_pcpre || is_pcer || is_pcmr || is_pcoie || is_pcovf)
       csr_rdata_o = perf_rdata;
   end
 
@@ -311,6 +326,8 @@ module riscv_cs_registers
   assign PCCR_in[8]  = branch_i                   & id_valid_q; // nr of branches (conditional)
   assign PCCR_in[9]  = branch_i & branch_taken_i  & id_valid_q; // nr of taken branches (conditional)
   assign PCCR_in[10] = id_valid_i & is_decoding_i & is_compressed_i;  // compressed instruction counter
+  assign PCCR_in[11] = branch_mispred_i           & id_valid_q; // nr of mispredicted branches, flushed in EX
+  assign PCCR_in[12] = btb_miss_i                 & id_valid_q; // nr of predicted taken branches fetched from ID
 
   // assign external performance counters
   generate
@@ -322,11 +339,19 @@ module riscv_cs_registers
   endgenerate
 
   // address decoder for performance counter registers
+  //   0x780 + i  PCCR i, bits [31:0]     0x79F  write all PCCRs [31:0]
+  //   0x7E0 + i  PCCR i, bits [63:32]    0x7FF  write all PCCRs [63:32] (PERF_CNT64)
+  //   0xBE0 + i  PCPRE i, preload
+  //   0x7A0 PCER, 0x7A1 PCMR, 0x7A2 PCOIE, 0x7A3 PCOVF
   always_comb
   begin
     is_pccr      = 1'b0;
+    is_pccrh     = 1'b0;
+    is_pcpre     = 1'b0;
     is_pcmr      = 1'b0;
     is_pcer      = 1'b0;
+    is_pcoie     = 1'b0;
+    is_pcovf     = 1'b0;
     pccr_all_sel = 1'b0;
     pccr_index   = '0;
     perf_rdata   = '0;
@@ -342,10 +367,22 @@ module riscv_cs_registers
           is_pcmr = 1'b1;
           perf_rdata[1:0] = PCMR_q;
         end
+        12'h7A2: begin
+          is_pcoie = 1'b1;
+          perf_rdata[N_PERF_COUNTERS-1:0] = PCOIE_q;
+        end
+        12'h7A3: begin
+          is_pcovf = 1'b1;
+          perf_rdata[N_PERF_COUNTERS-1:0] = PCOVF_q;
+        end
         12'h79F: begin
           is_pccr = 1'b1;
           pccr_all_sel = 1'b1;
         end
+        12'h7FF: begin
+          is_pccrh = PERF_CNT64;
+          pccr_all_sel = 1'b1;
+        end
         default:;
       endcase
 
@@ -355,14 +392,65 @@ module riscv_cs_registers
 
         pccr_index = csr_addr_i[4:0];
 `ifdef  ASIC_SYNTHESIS
-        perf_rdata = PCCR_q[0];
+        perf_rdata = PCCR_q[0][31:0];
 `else
-        perf_rdata = PCCR_q[csr_addr_i[4:0]];
+        perf_rdata = PCCR_q[csr_addr_i[4:0]][31:0];
+`endif
+      end
+
+      // 7E0 to 7FF, upper halves of the 64 bit counters
+      if (PERF_CNT64 && csr_addr_i[11:5] == 7'b0111111) begin
+        is_pccrh    = 1'b1;
+
+        pccr_index = csr_addr_i[4:0];
+`ifdef  ASIC_SYNTHESIS
+        perf_rdata = PCCR_q[0][PERF_CNT_W-1:PERF_CNT_W-32];
+`else
+        perf_rdata = PCCR_q[csr_addr_i[4:0]][PERF_CNT_W-1:PERF_CNT_W-32];
+`endif
+      end
+
+      // BE0 to BFF, overflow preloads
+      if (csr_addr_i[11:5] == 7'b1011111) begin
+        is_pcpre    = 1'b1;
+
+        pccr_index = csr_addr_i[4:0];
+`ifdef  ASIC_SYNTHESIS
+        perf_rdata = PCPRE_q[0];
+`else
+        perf_rdata = PCPRE_q[csr_addr_i[4:0]];
 `endif
       end
     end
   end
 
+  // CSR write to one 32 bit half of a counter
+  function automatic logic [31:0] perf_csr_op(input logic [31:0] q);
+    perf_csr_op = q;
+    unique case (csr_op_i)
+      CSR_OP_NONE:   ;
+      CSR_OP_WRITE:  perf_csr_op = csr_wdata_i;
+      CSR_OP_SET:    perf_csr_op = csr_wdata_i | q;
+      CSR_OP_CLEAR:  perf_csr_op = ~(csr_wdata_i) & q;
+    endcase
+  endfunction
+
+  // Counter increment. A counter that wraps sets its PCOVF flag; with its
+  // overflow interrupt enabled it restarts from the sign extended preload, so
+  // a preload of -N interrupts every N events. Otherwise it saturates or wraps
+  // as selected by PCMR[1].
+  function automatic logic [PERF_CNT_W-1:0] perf_inc(input logic [PERF_CNT_W-1:0] q,
+                                                     input logic                  oie,
+                                                     input logic [31:0]           pre);
+    if (q != '1)
+      perf_inc = q + 1;
+    else if (oie)
+      perf_inc = PERF_CNT_W'(signed'(pre));
+    else if (PCMR_q[1])
+      perf_inc = q;
+    else
+      perf_inc = '0;
+  endfunction
 
   // performance counter counter update logic
 `ifdef ASIC_SYNTHESIS
@@ -372,18 +460,20 @@ module riscv_cs_registers
   always_comb
   begin
     PCCR_n[0]   = PCCR_q[0];
+    PCPRE_n[0]  = PCPRE_q[0];
+    pccr_ovf    = '0;
 
-    if ((PCCR_inc_q[0] == 1'b1) && ((PCCR_q[0] != 32'hFFFFFFFF) || (PCMR_q[1] == 1'b0)))
-      PCCR_n[0] = PCCR_q[0] + 1;
-
-    if (is_pccr == 1'b1) begin
-      unique case (csr_op_i)
-        CSR_OP_NONE:   ;
-        CSR_OP_WRITE:  PCCR_n[0] = csr_wdata_i;
-        CSR_OP_SET:    PCCR_n[0] = csr_wdata_i | PCCR_q[0];
-        CSR_OP_CLEAR:  PCCR_n[0] = csr_wdata_i & ~(PCCR_q[0]);
-      endcase
+    if (PCCR_inc_q[0] == 1'b1) begin
+      pccr_ovf[0] = (PCCR_q[0] == '1);
+      PCCR_n[0]   = perf_inc(PCCR_q[0], PCOIE_q[0], PCPRE_q[0]);
     end
+
+    if (is_pccr == 1'b1)
+      PCCR_n[0][31:0] = perf_csr_op(PCCR_q[0][31:0]);
+    if (is_pccrh == 1'b1)
+      PCCR_n[0][PERF_CNT_W-1:PERF_CNT_W-32] = perf_csr_op(PCCR_q[0][PERF_CNT_W-1:PERF_CNT_W-32]);
+    if (is_pcpre == 1'b1)
+      PCPRE_n[0] = perf_csr_op(PCPRE_q[0]);
   end
 `else
   always_comb
@@ -393,34 +483,40 @@ module riscv_cs_registers
       PCCR_inc[i] = PCCR_in[i] & PCER_q[i] & PCMR_q[0];
 
       PCCR_n[i]   = PCCR_q[i];
+      PCPRE_n[i]  = PCPRE_q[i];
+      pccr_ovf[i] = 1'b0;
 
-      if ((PCCR_inc_q[i] == 1'b1) && ((PCCR_q[i] != 32'hFFFFFFFF) || (PCMR_q[1] == 1'b0)))
-        PCCR_n[i] = PCCR_q[i] + 1;
+      if (PCCR_inc_q[i] == 1'b1) begin
+        pccr_ovf[i] = (PCCR_q[i] == '1);
+        PCCR_n[i]   = perf_inc(PCCR_q[i], PCOIE_q[i], PCPRE_q[i]);
+      end
 
-      if (is_pccr == 1'b1 && (pccr_all_sel == 1'b1 || pccr_index == i)) begin
-        unique case (csr_op_i)
-          CSR_OP_NONE:   ;
-          CSR_OP_WRITE:  PCCR_n[i] = csr_wdata_i;
-          CSR_OP_SET:    PCCR_n[i] = csr_wdata_i | PCCR_q[i];
-          CSR_OP_CLEAR:  PCCR_n[i] = csr_wdata_i & ~(PCCR_q[i]);
-        endcase
+      if (pccr_all_sel == 1'b1 || pccr_index == i) begin
+        if (is_pccr == 1'b1)
+          PCCR_n[i][31:0] = perf_csr_op(PCCR_q[i][31:0]);
+        if (is_pccrh == 1'b1)
+          PCCR_n[i][PERF_CNT_W-1:PERF_CNT_W-32] = perf_csr_op(PCCR_q[i][PERF_CNT_W-1:PERF_CNT_W-32]);
+        if (is_pcpre == 1'b1)
+          PCPRE_n[i] = perf_csr_op(PCPRE_q[i]);
       end
     end
   end
 `endif
 
-  // update PCMR and PCER
+  // update PCMR, PCER, PCOIE and PCOVF
   always_comb
   begin
-    PCMR_n = PCMR_q;
-    PCER_n = PCER_q;
+    PCMR_n  = PCMR_q;
+    PCER_n  = PCER_q;
+    PCOIE_n = PCOIE_q;
+    PCOVF_n = PCOVF_q | pccr_ovf;
 
     if (is_pcmr) begin
       unique case (csr_op_i)
         CSR_OP_NONE:   ;
         CSR_OP_WRITE:  PCMR_n = csr_wdata_i[1:0];
         CSR_OP_SET:    PCMR_n = csr_wdata_i[1:0] | PCMR_q;
-        CSR_OP_CLEAR:  PCMR_n = csr_wdata_i[1:0] & ~(PCMR_q);
+        CSR_OP_CLEAR:  PCMR_n = ~(csr_wdata_i[1:0]) & PCMR_q;
       endcase
     end
 
@@ -429,11 +525,32 @@ module riscv_cs_registers
         CSR_OP_NONE:   ;
         CSR_OP_WRITE:  PCER_n = csr_wdata_i[N_PERF_COUNTERS-1:0];
         CSR_OP_SET:    PCER_n = csr_wdata_i[N_PERF_COUNTERS-1:0] | PCER_q;
-        CSR_OP_CLEAR:  PCER_n = csr_wdata_i[N_PERF_COUNTERS-1:0] & ~(PCER_q);
+        CSR_OP_CLEAR:  PCER_n = ~(csr_wdata_i[N_PERF_COUNTERS-1:0]) & PCER_q;
+      endcase
+    end
+
+    if (is_pcoie) begin
+      unique case (csr_op_i)
+        CSR_OP_NONE:   ;
+        CSR_OP_WRITE:  PCOIE_n = csr_wdata_i[N_PERF_COUNTERS-1:0];
+        CSR_OP_SET:    PCOIE_n = csr_wdata_i[N_PERF_COUNTERS-1:0] | PCOIE_q;
+        CSR_OP_CLEAR:  PCOIE_n = ~(csr_wdata_i[N_PERF_COUNTERS-1:0]) & PCOIE_q;
+      endcase
+    end
+
+    // an overflow in the same cycle as the clear is not lost
+    if (is_pcovf) begin
+      unique case (csr_op_i)
+        CSR_OP_NONE:   ;
+        CSR_OP_WRITE:  PCOVF_n = csr_wdata_i[N_PERF_COUNTERS-1:0] | pccr_ovf;
+        CSR_OP_SET:    PCOVF_n = csr_wdata_i[N_PERF_COUNTERS-1:0] | PCOVF_q | pccr_ovf;
+        CSR_OP_CLEAR:  PCOVF_n = (~(csr_wdata_i[N_PERF_COUNTERS-1:0]) & PCOVF_q) | pccr_ovf;
       endcase
     end
   end
 
+  assign perf_irq_o = |(PCOVF_q & PCOIE_q);
+
   // Performance Counter Registers
   always_ff @(posedge clk, negedge rst_n)
   begin
@@ -441,12 +558,15 @@ module riscv_cs_registers
     begin
       id_valid_q <= 1'b0;
 
-      PCER_q <= '0;
-      PCMR_q <= 2'h3;
+      PCER_q  <= '0;
+      PCMR_q  <= 2'h3;
+      PCOIE_q <= '0;
+      PCOVF_q <= '0;
 
       for(int i = 0; i < N_PERF_REGS; i++)
       begin
         PCCR_q[i]     <= '0;
+        PCPRE_q[i]    <= '0;
         PCCR_inc_q[i] <= '0;
       end
     end
@@ -454,12 +574,15 @@ module riscv_cs_registers
     begin
       id_valid_q <= id_valid_i;
 
-      PCER_q <= PCER_n;
-      PCMR_q <= PCMR_n;
+      PCER_q  <= PCER_n;
+      PCMR_q  <= PCMR_n;
+      PCOIE_q <= PCOIE_n;
+      PCOVF_q <= PCOVF_n;
 
       for(int i = 0; i < N_PERF_REGS; i++)
       begin
         PCCR_q[i]     <= PCCR_n[i];
+        PCPRE_q[i]    <= PCPRE_n[i];
         PCCR_inc_q[i] <= PCCR_inc[i];
       end
 
@@ -27,6 +27,9 @@
 import riscv_defines::*;
 
 module riscv_decoder
+#(
+  parameter COPROC = 0    // a coprocessor is attached, OPCODE_COP is legal
+)
 (
   // singals running to/from controller
   input  logic        deassert_we_i,           // deassert we, we are stalled or not active
@@ -63,7 +66,7 @@ module riscv_decoder
   output logic [1:0]  regc_mux_o,              // register c selection: S3, RD or 0
 
   // MUL related control signals
-  output logic [2:0]  mult_operator_o,         // Multiplication operation selection
+  output logic [3:0]  mult_operator_o,         // Multiplication operation selection
   output logic        mult_int_en_o,           // perform integer multiplication
   output logic        mult_dot_en_o,           // perform dot multiplication
   output logic [0:0]  mult_imm_mux_o,          // Multiplication immediate mux selector
@@ -95,6 +98,9 @@ module riscv_decoder
   output logic        hwloop_start_mux_sel_o,  // selects hwloop start address input
   output logic        hwloop_cnt_mux_sel_o,    // selects hwloop counter input
 
+  // coprocessor signals
+  output logic        cop_en_o,                // issue the instruction to the coprocessor
+
   // jump/branches
   output logic [1:0]  jump_in_dec_o,           // jump_in_id without deassert
   output logic [1:0]  jump_in_id_o,            // jump is being calculated in ALU
@@ -106,6 +112,7 @@ module riscv_decoder
   logic       regfile_alu_we;
   logic       data_req;
   logic [2:0] hwloop_we;
+  logic       cop_en;
 
   logic       ebrk_insn;
   logic       mret_insn;
@@ -159,6 +166,8 @@ module riscv_decoder
     hwloop_start_mux_sel_o      = 1'b0;
     hwloop_cnt_mux_sel_o        = 1'b0;
 
+    cop_en                      = 1'b0;
+
     csr_access_o                = 1'b0;
     csr_op                      = CSR_OP_NONE;
 
@@ -682,8 +691,12 @@ module riscv_decoder
         rega_used_o         = 1'b1;
         imm_b_mux_sel_o     = IMMB_VS;
 
-        // vector size
-        if (instr_rdata_i[12]) begin
+        // vector size, funct3 010 (.n) and 011 (.c) are the nibble and crumb
+        // forms of the dot products
+        if (instr_rdata_i[14:13] == 2'b01) begin
+          alu_vec_mode_o  = VEC_MODE8;
+          mult_operator_o = instr_rdata_i[12] ? MUL_DOT2 : MUL_DOT4;
+        end else if (instr_rdata_i[12]) begin
           alu_vec_mode_o  = VEC_MODE8;
           mult_operator_o = MUL_DOT8;
         end else begin
@@ -805,6 +818,32 @@ module riscv_decoder
             regc_mux_o        = REGC_RD;
           end
 
+          // 8 lane dot products, rd += rs1 . rs2 + (rs1+1) . (rs2+1), bytes only
+          6'b10100_1: begin // pv.sdot8up
+            mult_dot_en_o     = 1'b1;
+            mult_dot_signed_o = 2'b00;
+            mult_operator_o   = MUL_DOT8P;
+            regc_used_o       = 1'b1;
+            regc_mux_o        = REGC_RD;
+            if (instr_rdata_i[14:12] != 3'b001) illegal_insn_o = 1'b1;
+          end
+          6'b10101_1: begin // pv.sdot8usp
+            mult_dot_en_o     = 1'b1;
+            mult_dot_signed_o = 2'b01;
+            mult_operator_o   = MUL_DOT8P;
+            regc_used_o       = 1'b1;
+            regc_mux_o        = REGC_RD;
+            if (instr_rdata_i[14:12] != 3'b001) illegal_insn_o = 1'b1;
+          end
+          6'b10111_1: begin // pv.sdot8sp
+            mult_dot_en_o     = 1'b1;
+            mult_dot_signed_o = 2'b11;
+            mult_operator_o   = MUL_DOT8P;
+            regc_used_o       = 1'b1;
+            regc_mux_o        = REGC_RD;
+            if (instr_rdata_i[14:12] != 3'b001) illegal_insn_o = 1'b1;
+          end
+
           // comparisons, always have bit 26 set
           6'b00000_1: begin alu_operator_o = ALU_EQ;  imm_b_mux_sel_o     = IMMB_VS; end // pv.cmpeq
           6'b00001_1: begin alu_operator_o = ALU_NE;  imm_b_mux_sel_o     = IMMB_VS; end // pv.cmpne
@@ -819,6 +858,10 @@ module riscv_decoder
 
           default: illegal_insn_o = 1'b1;
         endcase
+
+        // only the dot products have nibble and crumb forms
+        if ((instr_rdata_i[14:13] == 2'b01) && ~mult_dot_en_o)
+          illegal_insn_o = 1'b1;
       end
 
 
@@ -954,6 +997,35 @@ module riscv_decoder
         endcase
       end
 
+
+      /////////////////////////////////////////////
+      //   ____ ___  ____  ____   ___   ____     //
+      //  / ___/ _ \|  _ \|  _ \ / _ \ / ___|    //
+      // | |  | | | | |_) | |_) | | | | |        //
+      // | |__| |_| |  __/|  _ <| |_| | |___     //
+      //  \____\___/|_|   |_| \_\\___/ \____|    //
+      //                                         //
+      /////////////////////////////////////////////
+
+      OPCODE_COP: begin
+        // R-type, funct7 and funct3 go to the coprocessor as its operation,
+        // rs1 and rs2 are the operands and its result is written to rd
+        if (COPROC != 0) begin
+          cop_en              = 1'b1;
+          alu_operator_o      = ALU_ADD;
+          regfile_alu_we      = 1'b1;
+          rega_used_o         = 1'b1;
+          regb_used_o         = 1'b1;
+
+          unique case ({instr_rdata_i[31:25], instr_rdata_i[14:12]})
+            COP_NPU_LDW, COP_NPU_PUSH, COP_NPU_ACC: ;
+            default: illegal_insn_o = 1'b1;
+          endcase
+        end else begin
+          illegal_insn_o      = 1'b1;
+        end
+      end
+
       default: begin
         illegal_insn_o = 1'b1;
       end
@@ -994,6 +1066,7 @@ module riscv_decoder
   assign regfile_alu_we_o  = (deassert_we_i) ? 1'b0          : regfile_alu_we;
   assign data_req_o        = (deassert_we_i) ? 1'b0          : data_req;
   assign hwloop_we_o       = (deassert_we_i) ? 3'b0          : hwloop_we;
+  assign cop_en_o          = (deassert_we_i) ? 1'b0          : cop_en;
   assign csr_op_o          = (deassert_we_i) ? CSR_OP_NONE  : csr_op;
   assign jump_in_id_o      = (deassert_we_i) ? BRANCH_NONE  : jump_in_id;
   assign ebrk_insn_o       = (deassert_we_i) ? 1'b0          : ebrk_insn;
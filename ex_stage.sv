@@ -30,6 +30,10 @@ import riscv_defines::*;
 
 
 module riscv_ex_stage
+#(
+  parameter FAST_DIV  = 0,
+  parameter MULH_MODE = 0
+)
 (
   input  logic        clk,
   input  logic        rst_n,
@@ -45,7 +49,7 @@ module riscv_ex_stage
   input  logic [ 1:0] alu_vec_mode_i,
 
   // Multiplier signals
-  input  logic [ 2:0] mult_operator_i,
+  input  logic [ 3:0] mult_operator_i,
   input  logic [31:0] mult_operand_a_i,
   input  logic [31:0] mult_operand_b_i,
   input  logic [31:0] mult_operand_c_i,
@@ -57,10 +61,16 @@ module riscv_ex_stage
   input  logic [31:0] mult_dot_op_a_i,
   input  logic [31:0] mult_dot_op_b_i,
   input  logic [31:0] mult_dot_op_c_i,
+  input  logic [31:0] mult_dot_op_a_pair_i,
+  input  logic [31:0] mult_dot_op_b_pair_i,
   input  logic [ 1:0] mult_dot_signed_i,
 
   output logic        mult_multicycle_o,
 
+  // early load forwarding
+  input  logic [ 2:0] ld_fwd_i,       // operand a/b/c is the data of the load in WB
+  input  logic [31:0] lsu_rdata_i,    // load data, valid with rvalid and held afterwards
+
   // input from ID stage
   input  logic        branch_in_ex_i,
   input  logic [4:0]  regfile_alu_waddr_i,
@@ -74,6 +84,16 @@ module riscv_ex_stage
   input  logic        csr_access_i,
   input  logic [31:0] csr_rdata_i,
 
+  // Coprocessor
+  input  logic        cop_en_i,
+  input  logic [9:0]  cop_op_i,
+  output logic        cop_valid_o,
+  input  logic        cop_ready_i,
+  output logic [9:0]  cop_op_o,
+  output logic [31:0] cop_operand_a_o,
+  output logic [31:0] cop_operand_b_o,
+  input  logic [31:0] cop_result_i,
+
   // Output of EX stage pipeline
   output logic [4:0]  regfile_waddr_wb_o,
   output logic        regfile_we_wb_o,
@@ -103,10 +123,43 @@ module riscv_ex_stage
 
   logic        alu_ready;
   logic        mult_ready;
+  logic        cop_ready;
+
+  logic [31:0] alu_operand_a, alu_operand_b, alu_operand_c;
+  logic [31:0] mult_operand_a, mult_operand_b, mult_operand_c;
+  logic [31:0] mult_dot_op_a, mult_dot_op_b, mult_dot_op_c;
+
+
+  // Early load forwarding: ID let this instruction follow a load it depends
+  // on. The load is in WB, so EX cannot finish before its data arrives, and
+  // the LSU keeps the data until the next load returns.
+  assign alu_operand_a  = ld_fwd_i[0] ? lsu_rdata_i : alu_operand_a_i;
+  assign alu_operand_b  = ld_fwd_i[1] ? lsu_rdata_i : alu_operand_b_i;
+  assign alu_operand_c  = ld_fwd_i[2] ? lsu_rdata_i : alu_operand_c_i;
+  assign mult_operand_a = ld_fwd_i[0] ? lsu_rdata_i : mult_operand_a_i;
+  assign mult_operand_b = ld_fwd_i[1] ? lsu_rdata_i : mult_operand_b_i;
+  assign mult_operand_c = ld_fwd_i[2] ? lsu_rdata_i : mult_operand_c_i;
+  assign mult_dot_op_a  = ld_fwd_i[0] ? lsu_rdata_i : mult_dot_op_a_i;
+  assign mult_dot_op_b  = ld_fwd_i[1] ? lsu_rdata_i : mult_dot_op_b_i;
+  assign mult_dot_op_c  = ld_fwd_i[2] ? lsu_rdata_i : mult_dot_op_c_i;
+
+
+  // Coprocessor issue: the instruction is offered once it could also leave
+  // EX, i.e. a load it depends on has its data and WB is free, and stays
+  // offered with the same operands until the coprocessor accepts it. The
+  // result comes with ready and takes the ALU write port, so it is
+  // forwarded like any ALU result.
+  assign cop_valid_o     = cop_en_i & lsu_ready_ex_i & wb_ready_i;
+  assign cop_op_o        = cop_op_i;
+  assign cop_operand_a_o = alu_operand_a;
+  assign cop_operand_b_o = alu_operand_b;
+
+  assign cop_ready       = ~cop_en_i | cop_ready_i;
 
 
-  // EX stage result mux (ALU, MAC unit, CSR)
-  assign alu_csr_result         = csr_access_i ? csr_rdata_i : alu_result;
+  // EX stage result mux (ALU, MAC unit, CSR, coprocessor)
+  assign alu_csr_result         = csr_access_i ? csr_rdata_i :
+                                  cop_en_i     ? cop_result_i : alu_result;
 
   assign regfile_alu_wdata_fw_o = mult_en_i ? mult_result : alu_csr_result;
 
@@ -129,15 +182,19 @@ module riscv_ex_stage
   //                        //
   ////////////////////////////
 
-  riscv_alu alu_i
+  riscv_alu
+  #(
+    .FAST_DIV            ( FAST_DIV        )
+  )
+  alu_i
   (
     .clk                 ( clk             ),
     .rst_n               ( rst_n           ),
 
     .operator_i          ( alu_operator_i  ),
-    .operand_a_i         ( alu_operand_a_i ),
-    .operand_b_i         ( alu_operand_b_i ),
-    .operand_c_i         ( alu_operand_c_i ),
+    .operand_a_i         ( alu_operand_a   ),
+    .operand_b_i         ( alu_operand_b   ),
+    .operand_c_i         ( alu_operand_c   ),
 
     .vector_mode_i       ( alu_vec_mode_i  ),
     .bmask_a_i           ( bmask_a_i       ),
@@ -161,7 +218,11 @@ module riscv_ex_stage
   //                                                            //
   ////////////////////////////////////////////////////////////////
 
-  riscv_mult mult_i
+  riscv_mult
+  #(
+    .MULH_MODE       ( MULH_MODE            )
+  )
+  mult_i
   (
     .clk             ( clk                  ),
     .rst_n           ( rst_n                ),
@@ -172,14 +233,16 @@ module riscv_ex_stage
     .short_subword_i ( mult_sel_subword_i   ),
     .short_signed_i  ( mult_signed_mode_i   ),
 
-    .op_a_i          ( mult_operand_a_i     ),
-    .op_b_i          ( mult_operand_b_i     ),
-    .op_c_i          ( mult_operand_c_i     ),
+    .op_a_i          ( mult_operand_a       ),
+    .op_b_i          ( mult_operand_b       ),
+    .op_c_i          ( mult_operand_c       ),
     .imm_i           ( mult_imm_i           ),
 
-    .dot_op_a_i      ( mult_dot_op_a_i      ),
-    .dot_op_b_i      ( mult_dot_op_b_i      ),
-    .dot_op_c_i      ( mult_dot_op_c_i      ),
+    .dot_op_a_i      ( mult_dot_op_a        ),
+    .dot_op_b_i      ( mult_dot_op_b        ),
+    .dot_op_c_i      ( mult_dot_op_c        ),
+    .dot_op_a_pair_i ( mult_dot_op_a_pair_i ),
+    .dot_op_b_pair_i ( mult_dot_op_b_pair_i ),
     .dot_signed_i    ( mult_dot_signed_i    ),
 
     .result_o        ( mult_result          ),
@@ -219,7 +282,7 @@ module riscv_ex_stage
   // As valid always goes to the right and ready to the left, and we are able
   // to finish branches without going to the WB stage, ex_valid does not
   // depend on ex_ready.
-  assign ex_ready_o = (alu_ready & mult_ready & lsu_ready_ex_i & wb_ready_i) | branch_in_ex_i;
-  assign ex_valid_o = (alu_ready & mult_ready & lsu_ready_ex_i & wb_ready_i);
+  assign ex_ready_o = (alu_ready & mult_ready & cop_ready & lsu_ready_ex_i & wb_ready_i) | branch_in_ex_i;
+  assign ex_valid_o = (alu_ready & mult_ready & cop_ready & lsu_ready_ex_i & wb_ready_i);
 
 endmodule
@@ -36,8 +36,11 @@ import riscv_defines::*;
 
 module riscv_id_stage
 #(
-  parameter N_HWLP      = 2,
-  parameter N_HWLP_BITS = $clog2(N_HWLP)
+  parameter N_HWLP         = 2,
+  parameter N_HWLP_BITS    = $clog2(N_HWLP),
+  parameter BRANCH_PREDICT = 0,    // predict backward conditional branches taken
+  parameter LOAD_FWD       = 0,    // forward load data into EX operands, no load-use stall
+  parameter COPROC         = 0     // a coprocessor is attached to EX
 )
 (
     input  logic        clk,
@@ -62,6 +65,12 @@ module riscv_id_stage
     input  logic        branch_decision_i,
     output logic [31:0] jump_target_o,
 
+    // Branch prediction
+    input  logic        btb_hit_i,            // the BTB knows the instruction in ID
+    input  logic        btb_taken_i,          // ... and fetch already follows its target
+    output logic        branch_redirect_ex_o, // branch in EX was mispredicted, fetch is redirected
+    output logic [31:0] branch_target_ex_o,   // target of the branch in EX, for the BTB
+
     // IF and ID stage signals
     output logic        clear_instr_valid_o,
     output logic        pc_set_o,
@@ -109,7 +118,7 @@ module riscv_id_stage
 
 
     // MUL
-    output logic [ 2:0] mult_operator_ex_o,
+    output logic [ 3:0] mult_operator_ex_o,
     output logic [31:0] mult_operand_a_ex_o,
     output logic [31:0] mult_operand_b_ex_o,
     output logic [31:0] mult_operand_c_ex_o,
@@ -121,12 +130,20 @@ module riscv_id_stage
     output logic [31:0] mult_dot_op_a_ex_o,
     output logic [31:0] mult_dot_op_b_ex_o,
     output logic [31:0] mult_dot_op_c_ex_o,
+    output logic [31:0] mult_dot_op_a_pair_ex_o,
+    output logic [31:0] mult_dot_op_b_pair_ex_o,
     output logic [ 1:0] mult_dot_signed_ex_o,
 
+    output logic [ 2:0] ld_fwd_ex_o,          // operand a/b/c in EX is the data of the load in WB
+
     // CSR ID/EX
     output logic        csr_access_ex_o,
     output logic [1:0]  csr_op_ex_o,
 
+    // coprocessor ID/EX, the operands are alu operand a and b
+    output logic        cop_en_ex_o,
+    output logic [9:0]  cop_op_ex_o,          // {funct7, funct3}
+
     // hwloop signals
     output logic [N_HWLP-1:0] [31:0] hwlp_start_o,
     output logic [N_HWLP-1:0] [31:0] hwlp_end_o,
@@ -195,6 +212,7 @@ module riscv_id_stage
 
     // Performance Counters
     output logic        perf_jump_o,          // we are executing a jump instruction
+    output logic        perf_btb_miss_o,      // branch in EX was predicted taken in ID, not by the BTB
     output logic        perf_jr_stall_o,      // jump-register-hazard
     output logic        perf_ld_stall_o       // load-use-hazard
 );
@@ -216,6 +234,10 @@ module riscv_id_stage
   logic        bmask_needed_dec;
 
   logic        branch_taken_ex;
+  logic        branch_pred_id, branch_pred_ex;
+  logic        branch_btb_ex;
+  logic        branch_redirect_id;
+  logic [31:0] pc_fallthrough_id;
   logic [1:0]  jump_in_id;
   logic [1:0]  jump_in_dec;
 
@@ -258,6 +280,8 @@ module riscv_id_stage
   logic [4:0]  regfile_addr_ra_id;
   logic [4:0]  regfile_addr_rb_id;
   logic [4:0]  regfile_addr_rc_id;
+  logic [4:0]  regfile_addr_ra_pair_id;   // rs1+1 and rs2+1 of the 8 lane dot products
+  logic [4:0]  regfile_addr_rb_pair_id;
 
   logic [4:0]  regfile_waddr_id;
   logic [4:0]  regfile_alu_waddr_id;
@@ -266,6 +290,8 @@ module riscv_id_stage
   logic [31:0] regfile_data_ra_id;
   logic [31:0] regfile_data_rb_id;
   logic [31:0] regfile_data_rc_id;
+  logic [31:0] regfile_data_ra_pair_id;
+  logic [31:0] regfile_data_rb_pair_id;
 
   // ALU Control
   logic [ALU_OP_WIDTH-1:0] alu_operator;
@@ -279,7 +305,7 @@ module riscv_id_stage
   logic [1:0]  jump_target_mux_sel;
 
   // Multiplier Control
-  logic [2:0]  mult_operator;    // multiplication operation selection
+  logic [3:0]  mult_operator;    // multiplication operation selection
   logic        mult_en;          // multiplication is used instead of ALU
   logic        mult_int_en;      // use integer multiplier
   logic        mult_sel_subword; // Select a subword when doing multiplications
@@ -317,6 +343,9 @@ module riscv_id_stage
   logic        csr_access;
   logic [1:0]  csr_op;
 
+  // Coprocessor
+  logic        cop_en;
+
   logic        prepost_useincr;
 
   // Forwarding
@@ -326,6 +355,9 @@ module riscv_id_stage
   logic [31:0] operand_a_fw_id;
   logic [31:0] operand_b_fw_id;
   logic [31:0] operand_c_fw_id;
+  logic [31:0] operand_a_pair_fw_id;
+  logic [31:0] operand_b_pair_fw_id;
+  logic        dot_pair_used;
 
   logic [31:0] operand_b, operand_b_vec;
 
@@ -350,12 +382,15 @@ module riscv_id_stage
   logic        reg_d_ex_is_reg_a_id;
   logic        reg_d_ex_is_reg_b_id;
   logic        reg_d_ex_is_reg_c_id;
+  logic        ld_fwd_ok_id;     // the load-use hazard is resolved in EX
+  logic [2:0]  ld_fwd_id;
   logic        reg_d_wb_is_reg_a_id;
   logic        reg_d_wb_is_reg_b_id;
   logic        reg_d_wb_is_reg_c_id;
   logic        reg_d_alu_is_reg_a_id;
   logic        reg_d_alu_is_reg_b_id;
   logic        reg_d_alu_is_reg_c_id;
+  logic        reg_d_ex_is_reg_pair_id;
 
 
   assign instr = instr_rdata_i;
@@ -393,6 +428,11 @@ module riscv_id_stage
   assign regfile_addr_ra_id = instr[`REG_S1];
   assign regfile_addr_rb_id = instr[`REG_S2];
 
+  // second registers of the pairs read by the 8 lane dot products
+  assign regfile_addr_ra_pair_id = instr[`REG_S1] + 5'd1;
+  assign regfile_addr_rb_pair_id = instr[`REG_S2] + 5'd1;
+  assign dot_pair_used           = mult_dot_en && (mult_operator == MUL_DOT8P);
+
   // register C mux
   always_comb
   begin
@@ -425,13 +465,67 @@ module riscv_id_stage
   assign reg_d_alu_is_reg_b_id = (regfile_alu_waddr_fw_i == regfile_addr_rb_id) && (regb_used_dec == 1'b1) && (regfile_addr_rb_id != '0);
   assign reg_d_alu_is_reg_c_id = (regfile_alu_waddr_fw_i == regfile_addr_rc_id) && (regc_used_dec == 1'b1) && (regfile_addr_rc_id != '0);
 
+  // the pair registers are forwarded here, the controller only needs to know
+  // about loads in EX writing one of them
+  assign reg_d_ex_is_reg_pair_id = dot_pair_used &&
+                                   (((regfile_waddr_ex_o == regfile_addr_ra_pair_id) && (regfile_addr_ra_pair_id != '0)) ||
+                                    ((regfile_waddr_ex_o == regfile_addr_rb_pair_id) && (regfile_addr_rb_pair_id != '0)));
+
+  // Early load forwarding (LOAD_FWD): an instruction reading the load in EX
+  // moves on with it and takes the data in EX, the cycle it arrives from
+  // memory. Only single cycle ALU/MUL operations qualify whose every use of
+  // the register is a plain operand slot; memory accesses, branches, CSRs,
+  // hwloop setups, divisions, mulh, scalar replication and the dot product
+  // pairs keep the load-use stall.
+  assign ld_fwd_id[0] = (reg_d_ex_is_reg_a_id && (alu_op_a_mux_sel == OP_A_REGA_OR_FWD)) ||
+                        (reg_d_ex_is_reg_b_id && (alu_op_a_mux_sel == OP_A_REGB_OR_FWD));
+  assign ld_fwd_id[1] = (reg_d_ex_is_reg_b_id && (alu_op_b_mux_sel == OP_B_REGB_OR_FWD)) ||
+                        (reg_d_ex_is_reg_c_id && (alu_op_b_mux_sel == OP_B_REGC_OR_FWD));
+  assign ld_fwd_id[2] = (reg_d_ex_is_reg_c_id && (alu_op_c_mux_sel == OP_C_REGC_OR_FWD)) ||
+                        (reg_d_ex_is_reg_b_id && (alu_op_c_mux_sel == OP_C_REGB_OR_FWD));
+
+  always_comb
+  begin
+    ld_fwd_ok_id = (LOAD_FWD != 0);
+
+    if (data_req_id || csr_access || (|hwloop_we_int) || (jump_in_dec != BRANCH_NONE) || reg_d_ex_is_reg_pair_id)
+      ld_fwd_ok_id = 1'b0;
+
+    if ((~mult_en) && ((alu_operator == ALU_DIV) || (alu_operator == ALU_DIVU) ||
+                       (alu_operator == ALU_REM) || (alu_operator == ALU_REMU)))
+      ld_fwd_ok_id = 1'b0;
+
+    if (mult_int_en && (mult_operator == MUL_H))
+      ld_fwd_ok_id = 1'b0;
+
+    if (ld_fwd_id[1] && scalar_replication)
+      ld_fwd_ok_id = 1'b0;
+
+    // rs1 only reaches EX through operand a, rs2 and rs3 through any slot
+    if (reg_d_ex_is_reg_a_id && (alu_op_a_mux_sel != OP_A_REGA_OR_FWD))
+      ld_fwd_ok_id = 1'b0;
+
+    if (reg_d_ex_is_reg_b_id && (alu_op_a_mux_sel != OP_A_REGB_OR_FWD) &&
+        (alu_op_b_mux_sel != OP_B_REGB_OR_FWD) && (alu_op_c_mux_sel != OP_C_REGB_OR_FWD))
+      ld_fwd_ok_id = 1'b0;
+
+    if (reg_d_ex_is_reg_c_id && (alu_op_b_mux_sel != OP_B_REGC_OR_FWD) &&
+        (alu_op_c_mux_sel != OP_C_REGC_OR_FWD))
+      ld_fwd_ok_id = 1'b0;
+  end
+
 
 
   // kill instruction in the IF/ID stage by setting the instr_valid_id control
   // signal to 0 for instructions that are done
   assign clear_instr_valid_o = id_ready_o | halt_id;
 
-  assign branch_taken_ex = branch_in_ex_o & branch_decision_i;
+  // the branch in EX only redirects fetch when it went the other way than
+  // predicted, without prediction this is every taken branch
+  assign branch_taken_ex = branch_in_ex_o & (branch_decision_i ^ branch_pred_ex);
+
+  assign branch_redirect_ex_o = branch_taken_ex;
+  assign perf_btb_miss_o      = branch_in_ex_o & branch_pred_ex & (~branch_btb_ex);
 
 
   assign mult_en = mult_int_en | mult_dot_en;
@@ -505,7 +599,26 @@ module riscv_id_stage
     endcase
   end
 
-  assign jump_target_o = jump_target;
+  //////////////////////////////////////////////////////////////////////////////
+  // branch prediction
+  //
+  // A conditional branch follows the BTB when it has an entry, else backward
+  // branches (negative offset) are predicted taken with BRANCH_PREDICT. A
+  // taken prediction the BTB did not already fetch redirects from ID like a
+  // jal; a BTB redirect on something that is no branch is undone the same
+  // way. The branch carries the other path to EX in operand c, which is
+  // where PC_BRANCH fetches from when the prediction was wrong.
+  //////////////////////////////////////////////////////////////////////////////
+
+  assign pc_fallthrough_id  = pc_id_i + (is_compressed_i ? 32'd2 : 32'd4);
+
+  assign branch_pred_id     = (jump_in_dec == BRANCH_COND) &&
+                              (btb_hit_i ? btb_taken_i : ((BRANCH_PREDICT != 0) && instr[31]));
+
+  assign branch_redirect_id = (branch_pred_id && (~btb_taken_i)) ||
+                              (btb_taken_i && (jump_in_dec == BRANCH_NONE));
+
+  assign jump_target_o = (jump_in_dec == BRANCH_NONE) ? pc_fallthrough_id : jump_target;
 
 
   ////////////////////////////////////////////////////////
@@ -634,7 +747,7 @@ module riscv_id_stage
     case (alu_op_c_mux_sel)
       OP_C_REGC_OR_FWD:  alu_operand_c = operand_c_fw_id;
       OP_C_REGB_OR_FWD:  alu_operand_c = operand_b_fw_id;
-      OP_C_JT:           alu_operand_c = jump_target;
+      OP_C_JT:           alu_operand_c = branch_pred_id ? pc_fallthrough_id : jump_target;
       default:            alu_operand_c = operand_c_fw_id;
     endcase // case (alu_op_c_mux_sel)
   end
@@ -650,6 +763,24 @@ module riscv_id_stage
     endcase; // case (operand_c_fw_mux_sel)
   end
 
+  // Operand pair forwarding for the 8 lane dot products, EX before WB as in
+  // the controller's forwarding unit
+  always_comb
+  begin : operand_pair_fw_mux
+    operand_a_pair_fw_id = regfile_data_ra_pair_id;
+    operand_b_pair_fw_id = regfile_data_rb_pair_id;
+
+    if (regfile_we_wb_i && (regfile_waddr_wb_i == regfile_addr_ra_pair_id) && (regfile_addr_ra_pair_id != '0))
+      operand_a_pair_fw_id = regfile_wdata_wb_i;
+    if (regfile_we_wb_i && (regfile_waddr_wb_i == regfile_addr_rb_pair_id) && (regfile_addr_rb_pair_id != '0))
+      operand_b_pair_fw_id = regfile_wdata_wb_i;
+
+    if (regfile_alu_we_fw_i && (regfile_alu_waddr_fw_i == regfile_addr_ra_pair_id) && (regfile_addr_ra_pair_id != '0))
+      operand_a_pair_fw_id = regfile_alu_wdata_fw_i;
+    if (regfile_alu_we_fw_i && (regfile_alu_waddr_fw_i == regfile_addr_rb_pair_id) && (regfile_addr_rb_pair_id != '0))
+      operand_b_pair_fw_id = regfile_alu_wdata_fw_i;
+  end
+
 
   ///////////////////////////////////////////////////////////////////////////
   //  ___                              _ _       _              ___ ____   //
@@ -718,6 +849,12 @@ module riscv_id_stage
     .raddr_c_i    ( (dbg_reg_rreq_i == 1'b0) ? regfile_addr_rc_id : dbg_reg_raddr_i ),
     .rdata_c_o    ( regfile_data_rc_id ),
 
+    // Read ports d and e
+    .raddr_d_i    ( regfile_addr_ra_pair_id ),
+    .rdata_d_o    ( regfile_data_ra_pair_id ),
+    .raddr_e_i    ( regfile_addr_rb_pair_id ),
+    .rdata_e_o    ( regfile_data_rb_pair_id ),
+
     // Write port a
     .waddr_a_i    ( regfile_waddr_wb_i ),
     .wdata_a_i    ( regfile_wdata_wb_i ),
@@ -741,7 +878,11 @@ module riscv_id_stage
   //                                           //
   ///////////////////////////////////////////////
 
-  riscv_decoder decoder_i
+  riscv_decoder
+  #(
+    .COPROC                          ( COPROC                    )
+  )
+  decoder_i
   (
     // controller related signals
     .deassert_we_i                   ( deassert_we               ),
@@ -810,6 +951,9 @@ module riscv_id_stage
     .hwloop_start_mux_sel_o          ( hwloop_start_mux_sel      ),
     .hwloop_cnt_mux_sel_o            ( hwloop_cnt_mux_sel        ),
 
+    // coprocessor signals
+    .cop_en_o                        ( cop_en                    ),
+
     // jump/branches
     .jump_in_dec_o                   ( jump_in_dec               ),
     .jump_in_id_o                    ( jump_in_id                ),
@@ -866,6 +1010,7 @@ module riscv_id_stage
 
     // jump/branch control
     .branch_taken_ex_i              ( branch_taken_ex        ),
+    .branch_redirect_id_i           ( branch_redirect_id     ),
     .jump_in_id_i                   ( jump_in_id             ),
     .jump_in_dec_i                  ( jump_in_dec            ),
 
@@ -897,6 +1042,8 @@ module riscv_id_stage
     .reg_d_ex_is_reg_a_i            ( reg_d_ex_is_reg_a_id   ),
     .reg_d_ex_is_reg_b_i            ( reg_d_ex_is_reg_b_id   ),
     .reg_d_ex_is_reg_c_i            ( reg_d_ex_is_reg_c_id   ),
+    .reg_d_ex_is_reg_pair_i         ( reg_d_ex_is_reg_pair_id ),
+    .ld_fwd_ok_i                    ( ld_fwd_ok_id           ),
     .reg_d_wb_is_reg_a_i            ( reg_d_wb_is_reg_a_id   ),
     .reg_d_wb_is_reg_b_i            ( reg_d_wb_is_reg_b_id   ),
     .reg_d_wb_is_reg_c_i            ( reg_d_wb_is_reg_c_id   ),
@@ -1046,6 +1193,8 @@ module riscv_id_stage
       mult_dot_op_a_ex_o          <= '0;
       mult_dot_op_b_ex_o          <= '0;
       mult_dot_op_c_ex_o          <= '0;
+      mult_dot_op_a_pair_ex_o     <= '0;
+      mult_dot_op_b_pair_ex_o     <= '0;
       mult_dot_signed_ex_o        <= '0;
 
       regfile_waddr_ex_o          <= 5'b0;
@@ -1058,6 +1207,9 @@ module riscv_id_stage
       csr_access_ex_o             <= 1'b0;
       csr_op_ex_o                 <= CSR_OP_NONE;
 
+      cop_en_ex_o                 <= 1'b0;
+      cop_op_ex_o                 <= '0;
+
       data_we_ex_o                <= 1'b0;
       data_type_ex_o              <= 2'b0;
       data_sign_ext_ex_o          <= 1'b0;
@@ -1070,6 +1222,11 @@ module riscv_id_stage
       pc_ex_o                     <= '0;
 
       branch_in_ex_o              <= 1'b0;
+      branch_pred_ex              <= 1'b0;
+      branch_btb_ex               <= 1'b0;
+      branch_target_ex_o          <= '0;
+
+      ld_fwd_ex_o                 <= '0;
 
     end
     else if (data_misaligned_i) begin
@@ -1128,6 +1285,10 @@ module riscv_id_stage
           mult_dot_op_b_ex_o        <= alu_operand_b;
           mult_dot_op_c_ex_o        <= alu_operand_c;
         end
+        if (dot_pair_used) begin
+          mult_dot_op_a_pair_ex_o   <= operand_a_pair_fw_id;
+          mult_dot_op_b_pair_ex_o   <= operand_b_pair_fw_id;
+        end
 
         regfile_we_ex_o             <= regfile_we_id;
         if (regfile_we_id) begin
@@ -1144,6 +1305,11 @@ module riscv_id_stage
         csr_access_ex_o             <= csr_access;
         csr_op_ex_o                 <= csr_op;
 
+        cop_en_ex_o                 <= cop_en;
+        if (cop_en) begin
+          cop_op_ex_o               <= {instr[31:25], instr[14:12]};
+        end
+
         data_req_ex_o               <= data_req_id;
         if (data_req_id)
         begin // only needed for LSU when there is an active request
@@ -1162,7 +1328,16 @@ module riscv_id_stage
           pc_ex_o                   <= pc_id_i;
         end
 
+        if (jump_in_id == BRANCH_COND) begin
+          branch_target_ex_o        <= jump_target;
+        end
+
         branch_in_ex_o              <= jump_in_id == BRANCH_COND;
+        branch_pred_ex              <= branch_pred_id;
+        branch_btb_ex               <= btb_taken_i;
+
+        // only set when the hazard was not stalled, i.e. the load moves to WB
+        ld_fwd_ex_o                 <= (data_req_ex_o & regfile_we_ex_o & ld_fwd_ok_id) ? ld_fwd_id : 3'b000;
       end else if(ex_ready_i) begin
         // EX stage is ready but we don't have a new instruction for it,
         // so we set all write enables to 0, but unstall the pipe
@@ -1173,12 +1348,16 @@ module riscv_id_stage
 
         csr_op_ex_o                 <= CSR_OP_NONE;
 
+        cop_en_ex_o                 <= 1'b0;
+
         data_req_ex_o               <= 1'b0;
         data_load_event_ex_o        <= 1'b0;
 
         data_misaligned_ex_o        <= 1'b0;
 
         branch_in_ex_o              <= 1'b0;
+
+        ld_fwd_ex_o                 <= '0;
       end
     end
   end
@@ -31,7 +31,8 @@ import riscv_defines::*;
 module riscv_if_stage
 #(
   parameter N_HWLP      = 2,
-  parameter RDATA_WIDTH = 32
+  parameter RDATA_WIDTH = 32,
+  parameter BTB_ENTRIES = 0    // branch target buffer entries (power of 2, >= 2), 0: none
 )
 (
     input  logic        clk,
@@ -59,6 +60,8 @@ module riscv_if_stage
     output logic              illegal_c_insn_id_o,   // compressed decoder thinks this is an invalid instruction
     output logic       [31:0] pc_if_o,
     output logic       [31:0] pc_id_o,
+    output logic              btb_hit_id_o,          // the BTB knows the instruction in ID
+    output logic              btb_taken_id_o,        // ... and redirected fetch to its target
 
     // Forwarding ports - control signals
     input  logic        clear_instr_valid_i,   // clear instruction valid bit in IF/ID pipe
@@ -72,6 +75,12 @@ module riscv_if_stage
     input  logic [31:0] jump_target_id_i,      // jump target address
     input  logic [31:0] jump_target_ex_i,      // jump target address
 
+    // branch target buffer update, from the branch in EX
+    input  logic        btb_update_i,
+    input  logic [31:0] btb_update_pc_i,
+    input  logic [31:0] btb_update_target_i,
+    input  logic        btb_update_taken_i,
+
     // from hwloop controller
     input  logic [N_HWLP-1:0] [31:0] hwlp_start_i,          // hardware loop start addresses
     input  logic [N_HWLP-1:0] [31:0] hwlp_end_i,            // hardware loop end addresses
@@ -115,6 +124,13 @@ module riscv_if_stage
   logic       [31:0] hwlp_target;
   logic [N_HWLP-1:0] hwlp_dec_cnt, hwlp_dec_cnt_if;
 
+  // branch target buffer, redirects fetch through the hwloop port
+  logic              btb_hit;
+  logic              btb_jump;
+  logic       [31:0] btb_target;
+  logic              fetch_jump;
+  logic       [31:0] fetch_jump_target;
+
 
   // exception PC selection mux
   always_comb
@@ -162,8 +178,8 @@ module riscv_if_stage
         .branch_i          ( branch_req                  ),
         .addr_i            ( {fetch_addr_n[31:1], 1'b0}  ),
 
-        .hwloop_i          ( hwlp_jump                   ),
-        .hwloop_target_i   ( hwlp_target                 ),
+        .hwloop_i          ( fetch_jump                  ),
+        .hwloop_target_i   ( fetch_jump_target           ),
 
         .ready_i           ( fetch_ready                 ),
         .valid_o           ( fetch_valid                 ),
@@ -193,8 +209,8 @@ module riscv_if_stage
         .branch_i          ( branch_req                  ),
         .addr_i            ( {fetch_addr_n[31:1], 1'b0}  ),
 
-        .hwloop_i          ( hwlp_jump                   ),
-        .hwloop_target_i   ( hwlp_target                 ),
+        .hwloop_i          ( fetch_jump                  ),
+        .hwloop_target_i   ( fetch_jump_target           ),
 
         .ready_i           ( fetch_ready                 ),
         .valid_o           ( fetch_valid                 ),
@@ -296,6 +312,85 @@ module riscv_if_stage
   );
 
 
+  //////////////////////////////////////////////////////////////////////////////
+  // branch target buffer
+  //
+  // direct mapped on pc[BTB_IDX:1] with a full tag, a target and a 2 bit
+  // counter per entry. A taken prediction for the instruction in IF fetches
+  // the target right after it, the same way a hardware loop end does; hwloops
+  // win when both apply. Taken branches allocate an entry, known ones train
+  // their counter. The redirect is held until the instruction leaves IF, an
+  // update from EX must not change a request the prefetcher already follows.
+  //////////////////////////////////////////////////////////////////////////////
+
+  generate
+    if (BTB_ENTRIES > 0) begin : g_btb
+      localparam BTB_IDX = $clog2(BTB_ENTRIES);
+
+      logic [BTB_ENTRIES-1:0]        btb_valid_q;
+      logic [BTB_ENTRIES-1:0] [30:0] btb_tag_q;
+      logic [BTB_ENTRIES-1:0] [31:0] btb_target_q;
+      logic [BTB_ENTRIES-1:0]  [1:0] btb_cnt_q;
+
+      logic [BTB_IDX-1:0] rd_idx, wr_idx;
+      logic               lookup_hit;
+      logic               hold_q;
+      logic        [31:0] hold_target_q;
+
+      assign rd_idx     = fetch_addr[BTB_IDX:1];
+      assign wr_idx     = btb_update_pc_i[BTB_IDX:1];
+      assign lookup_hit = btb_valid_q[rd_idx] && (btb_tag_q[rd_idx] == fetch_addr[31:1]);
+
+      assign btb_hit    = hold_q | lookup_hit;
+      assign btb_jump   = (hold_q | (lookup_hit & btb_cnt_q[rd_idx][1])) & (~hwlp_jump);
+      assign btb_target = hold_q ? hold_target_q : btb_target_q[rd_idx];
+
+      always_ff @(posedge clk, negedge rst_n)
+      begin
+        if (rst_n == 1'b0)
+        begin
+          btb_valid_q   <= '0;
+          btb_tag_q     <= '0;
+          btb_target_q  <= '0;
+          btb_cnt_q     <= '0;
+          hold_q        <= 1'b0;
+          hold_target_q <= '0;
+        end
+        else
+        begin
+          if (btb_update_i) begin
+            if (btb_valid_q[wr_idx] && (btb_tag_q[wr_idx] == btb_update_pc_i[31:1])) begin
+              if (btb_update_taken_i && (btb_cnt_q[wr_idx] != 2'b11))
+                btb_cnt_q[wr_idx] <= btb_cnt_q[wr_idx] + 2'b01;
+              else if ((~btb_update_taken_i) && (btb_cnt_q[wr_idx] != 2'b00))
+                btb_cnt_q[wr_idx] <= btb_cnt_q[wr_idx] - 2'b01;
+            end else if (btb_update_taken_i) begin
+              btb_valid_q[wr_idx]  <= 1'b1;
+              btb_tag_q[wr_idx]    <= btb_update_pc_i[31:1];
+              btb_target_q[wr_idx] <= btb_update_target_i;
+              btb_cnt_q[wr_idx]    <= 2'b10; // weakly taken
+            end
+          end
+
+          if (pc_set_i | if_valid_o)
+            hold_q <= 1'b0;
+          else if (btb_jump) begin
+            hold_q        <= 1'b1;
+            hold_target_q <= btb_target;
+          end
+        end
+      end
+    end else begin : g_no_btb
+      assign btb_hit    = 1'b0;
+      assign btb_jump   = 1'b0;
+      assign btb_target = '0;
+    end
+  endgenerate
+
+  assign fetch_jump        = hwlp_jump | btb_jump;
+  assign fetch_jump_target = hwlp_jump ? hwlp_target : btb_target;
+
+
   assign pc_if_o         = fetch_addr;
 
   assign if_busy_o       = prefetch_busy;
@@ -329,7 +424,8 @@ module riscv_if_stage
     end
     else
     begin
-      if (hwlp_jump)
+      // a BTB target is served like a hwloop start, with nothing to decrement
+      if (fetch_jump)
         hwlp_dec_cnt_if <= hwlp_dec_cnt;
     end
   end
@@ -346,6 +442,8 @@ module riscv_if_stage
       pc_id_o               <= '0;
       is_hwlp_id_q          <= 1'b0;
       hwlp_dec_cnt_id_o     <= '0;
+      btb_hit_id_o          <= 1'b0;
+      btb_taken_id_o        <= 1'b0;
     end
     else
     begin
@@ -358,6 +456,8 @@ module riscv_if_stage
         is_compressed_id_o  <= instr_compressed_int;
         pc_id_o             <= pc_if_o;
         is_hwlp_id_q        <= fetch_is_hwlp;
+        btb_hit_id_o        <= btb_hit;
+        btb_taken_id_o      <= btb_jump;
 
         if (fetch_is_hwlp)
           hwlp_dec_cnt_id_o   <= hwlp_dec_cnt_if;
@@ -388,6 +488,10 @@ module riscv_if_stage
   assert property (
     @(posedge clk) (req_i) |-> (~fetch_addr_n[0]) )
     else $warning("There was a request while the fetch_addr_n LSB is set");
+
+  // the BTB is indexed with pc[BTB_IDX:1]
+  initial assert ((BTB_ENTRIES == 0) || ((BTB_ENTRIES > 1) && (BTB_ENTRIES == 2**$clog2(BTB_ENTRIES))))
+    else $error("BTB_ENTRIES must be 0 or a power of 2 of at least 2");
 `endif
 
 endmodule
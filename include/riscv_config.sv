@@ -26,5 +26,12 @@
 `ifndef PULP_FPGA_EMUL
 `define TRACE_EXECUTION
 `endif
+// lockstep checker, the Verilator model sets it with "make SIMCHECK=1"
 //`define SIMCHECKER
 `endif
+
+// binary tracer (riscv_tracer_bin.sv) for Verilator, where the text tracer is
+// compiled out; it only writes records when the run is given +trace_bin
+`ifdef VERILATOR
+`define TRACE_BINARY
+`endif
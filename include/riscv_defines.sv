@@ -57,6 +57,14 @@ parameter OPCODE_PULP_OP    = 7'h5b;
 parameter OPCODE_VECOP      = 7'h57;
 parameter OPCODE_HWLOOP     = 7'h7b;
 
+// coprocessor instructions, reserved in the base opcode map
+parameter OPCODE_COP        = 7'h77;
+
+// coprocessor operations {funct7, funct3}, those of npu_coprocessor
+parameter COP_NPU_LDW  = 10'b0000000_000;
+parameter COP_NPU_PUSH = 10'b0000000_001;
+parameter COP_NPU_ACC  = 10'b0000000_010;
+
 parameter REGC_S1   = 2'b10;
 parameter REGC_RD   = 2'b01;
 parameter REGC_ZERO = 2'b11;
@@ -153,13 +161,16 @@ parameter ALU_PCKLO = 6'b111000;
 parameter ALU_PCKHI = 6'b111001;
 
 
-parameter MUL_MAC32 = 3'b000;
-parameter MUL_MSU32 = 3'b001;
-parameter MUL_I     = 3'b010;
-parameter MUL_IR    = 3'b011;
-parameter MUL_DOT8  = 3'b100;
-parameter MUL_DOT16 = 3'b101;
-parameter MUL_H     = 3'b110;
+parameter MUL_MAC32 = 4'b0000;
+parameter MUL_MSU32 = 4'b0001;
+parameter MUL_I     = 4'b0010;
+parameter MUL_IR    = 4'b0011;
+parameter MUL_DOT8  = 4'b0100;
+parameter MUL_DOT16 = 4'b0101;
+parameter MUL_H     = 4'b0110;
+parameter MUL_DOT8P = 4'b0111;   // 8 lanes from the pairs rs1, rs1+1 and rs2, rs2+1
+parameter MUL_DOT4  = 4'b1000;   // 8 nibble lanes
+parameter MUL_DOT2  = 4'b1001;   // 16 crumb lanes
 
 // vector modes
 parameter VEC_MODE32 = 2'b00;
@@ -26,12 +26,15 @@ import riscv_defines::*;
 
 
 module riscv_mult
+#(
+  parameter MULH_MODE = 0   // 0: iterative (4 extra cycles), 1: single cycle, 2: two cycles
+)
 (
   input  logic        clk,
   input  logic        rst_n,
 
   input  logic        enable_i,
-  input  logic [ 2:0] operator_i,
+  input  logic [ 3:0] operator_i,
 
   // integer and short multiplier
   input  logic        short_subword_i,
@@ -49,6 +52,8 @@ module riscv_mult
   input  logic [31:0] dot_op_a_i,
   input  logic [31:0] dot_op_b_i,
   input  logic [31:0] dot_op_c_i,
+  input  logic [31:0] dot_op_a_pair_i,  // rs1+1 and rs2+1 for MUL_DOT8P
+  input  logic [31:0] dot_op_b_pair_i,
 
   output logic [31:0] result_o,
 
@@ -88,6 +93,11 @@ module riscv_mult
   logic        mulh_ready;
   enum logic [2:0] {IDLE, STEP0, STEP1, STEP2, FINISH} mulh_CS, mulh_NS;
 
+  logic [32:0] mulh_op_a;
+  logic [32:0] mulh_op_b;
+  logic [65:0] mulh_full;
+  logic [31:0] mulh_result;
+
   // prepare the rounding value
   assign short_round_tmp = (32'h00000001) << imm_i;
   assign short_round = (operator_i == MUL_IR) ? {1'b0, short_round_tmp[31:1]} : '0;
@@ -113,81 +123,151 @@ module riscv_mult
   assign short_shift_arith = mulh_active ? mulh_shift_arith : short_signed_i[0];
   assign short_shift_ext   = mulh_active ? 1'b1             : short_signed_i[0];
 
-  always_comb
-  begin
-    mulh_NS          = mulh_CS;
-    mulh_imm         = 5'd0;
-    mulh_subword     = 2'b00;
-    mulh_signed      = 2'b00;
-    mulh_shift_arith = 1'b0;
-    mulh_ready       = 1'b0;
-    mulh_active      = 1'b1;
-    mulh_save        = 1'b0;
-
-    case (mulh_CS)
-      IDLE: begin
-        mulh_active = 1'b0;
-        mulh_ready  = 1'b1;
-
-        if ((operator_i == MUL_H) && enable_i) begin
-          mulh_ready  = 1'b0;
-          mulh_NS     = STEP0;
-        end
-      end
-
-      STEP0: begin
-        mulh_imm         = 5'd16;
+  // mulh: the iterative version reuses the 16x16 short multiplier in four
+  // steps, the others have a full 33x33 multiplier (registered for MULH_MODE 2)
+  assign mulh_op_a = {short_signed_i[0] & op_a_i[31], op_a_i};
+  assign mulh_op_b = {short_signed_i[1] & op_b_i[31], op_b_i};
+
+  generate
+    if (MULH_MODE == 0) begin : g_mulh_iter
+      always_comb
+      begin
+        mulh_NS          = mulh_CS;
+        mulh_imm         = 5'd0;
+        mulh_subword     = 2'b00;
+        mulh_signed      = 2'b00;
         mulh_shift_arith = 1'b0;
+        mulh_ready       = 1'b0;
         mulh_active      = 1'b1;
-        mulh_save        = 1'b1;
-        mulh_NS          = STEP1;
-      end
-
-      STEP1: begin
-        mulh_signed  = {1'b0, short_signed_i[0]};
-
-        mulh_subword = 2'b01;
-        mulh_save    = 1'b1;
-        mulh_NS      = STEP2;
+        mulh_save        = 1'b0;
+
+        case (mulh_CS)
+          IDLE: begin
+            mulh_active = 1'b0;
+            mulh_ready  = 1'b1;
+
+            if ((operator_i == MUL_H) && enable_i) begin
+              mulh_ready  = 1'b0;
+              mulh_NS     = STEP0;
+            end
+          end
+
+          STEP0: begin
+            mulh_imm         = 5'd16;
+            mulh_shift_arith = 1'b0;
+            mulh_active      = 1'b1;
+            mulh_save        = 1'b1;
+            mulh_NS          = STEP1;
+          end
+
+          STEP1: begin
+            mulh_signed  = {1'b0, short_signed_i[0]};
+
+            mulh_subword = 2'b01;
+            mulh_save    = 1'b1;
+            mulh_NS      = STEP2;
+          end
+
+          STEP2: begin
+            mulh_signed      = {short_signed_i[1], 1'b0};
+
+            mulh_subword     = 2'b10;
+            mulh_shift_arith = short_signed_i[0];
+            mulh_imm         = 5'd16;
+            mulh_save        = 1'b1;
+            mulh_NS          = FINISH;
+          end
+
+          FINISH: begin
+            mulh_signed = short_signed_i;
+
+            mulh_subword = 2'b11;
+            mulh_ready   = 1'b1;
+
+            if (ex_ready_i)
+              mulh_NS = IDLE;
+          end
+        endcase
       end
 
-      STEP2: begin
-        mulh_signed      = {short_signed_i[1], 1'b0};
-
-        mulh_subword     = 2'b10;
-        mulh_shift_arith = short_signed_i[0];
-        mulh_imm         = 5'd16;
-        mulh_save        = 1'b1;
-        mulh_NS          = FINISH;
+      always_ff @(posedge clk, negedge rst_n)
+      begin
+        if (~rst_n)
+        begin
+          mulh_CS      <= IDLE;
+          mulh_carry_q <= 1'b0;
+        end else begin
+          mulh_CS      <= mulh_NS;
+
+          if (mulh_save)
+            mulh_carry_q <= short_result[32];
+          else if (ex_ready_i) // clear carry when we are going to the next instruction
+            mulh_carry_q <= 1'b0;
+        end
       end
 
-      FINISH: begin
-        mulh_signed = short_signed_i;
+      assign mulh_full   = '0;
+      assign mulh_result = short_result[31:0];
+    end else begin : g_mulh_full
+      logic [31:0] mulh_result_q;
+
+      assign mulh_full = $signed(mulh_op_a) * $signed(mulh_op_b);
+
+      assign mulh_imm         = 5'd0;
+      assign mulh_subword     = 2'b00;
+      assign mulh_signed      = 2'b00;
+      assign mulh_shift_arith = 1'b0;
+      assign mulh_active      = 1'b0;
+      assign mulh_save        = 1'b0;
+      assign mulh_carry_q     = 1'b0;
+
+      if (MULH_MODE == 1) begin : g_mulh_1cycle
+        assign mulh_NS     = IDLE;
+        assign mulh_CS     = IDLE;
+        assign mulh_ready  = 1'b1;
+        assign mulh_result = mulh_full[63:32];
+      end else begin : g_mulh_2cycle
+        // IDLE computes and registers the product, FINISH returns it
+        always_comb
+        begin
+          mulh_NS    = mulh_CS;
+          mulh_ready = 1'b1;
+
+          case (mulh_CS)
+            IDLE: begin
+              if ((operator_i == MUL_H) && enable_i) begin
+                mulh_ready = 1'b0;
+                mulh_NS    = FINISH;
+              end
+            end
+
+            FINISH: begin
+              if (ex_ready_i)
+                mulh_NS = IDLE;
+            end
+
+            default: mulh_NS = IDLE;
+          endcase
+        end
 
-        mulh_subword = 2'b11;
-        mulh_ready   = 1'b1;
+        always_ff @(posedge clk, negedge rst_n)
+        begin
+          if (~rst_n)
+          begin
+            mulh_CS       <= IDLE;
+            mulh_result_q <= '0;
+          end else begin
+            mulh_CS       <= mulh_NS;
+
+            if ((mulh_CS == IDLE) && (operator_i == MUL_H) && enable_i)
+              mulh_result_q <= mulh_full[63:32];
+          end
+        end
 
-        if (ex_ready_i)
-          mulh_NS = IDLE;
+        assign mulh_result = mulh_result_q;
       end
-    endcase
-  end
-
-  always_ff @(posedge clk, negedge rst_n)
-  begin
-    if (~rst_n)
-    begin
-      mulh_CS      <= IDLE;
-      mulh_carry_q <= 1'b0;
-    end else begin
-      mulh_CS      <= mulh_NS;
-
-      if (mulh_save)
-        mulh_carry_q <= short_result[32];
-      else if (ex_ready_i) // clear carry when we are going to the next instruction
-        mulh_carry_q <= 1'b0;
     end
-  end
+  endgenerate
 
   // 32x32 = 32-bit multiplier
   logic [31:0] int_op_a_msu;
@@ -216,6 +296,21 @@ module riscv_mult
   logic [3:0][17:0] dot_char_mul;
   logic [31:0]      dot_char_result;
 
+  logic [3:0][ 8:0] dot_pair_op_a;
+  logic [3:0][ 8:0] dot_pair_op_b;
+  logic [3:0][17:0] dot_pair_mul;
+  logic [31:0]      dot_pair_result;
+
+  logic [7:0][ 4:0] dot_nibble_op_a;
+  logic [7:0][ 4:0] dot_nibble_op_b;
+  logic [7:0][ 9:0] dot_nibble_mul;
+  logic [31:0]      dot_nibble_result;
+
+  logic [15:0][2:0] dot_crumb_op_a;
+  logic [15:0][2:0] dot_crumb_op_b;
+  logic [15:0][5:0] dot_crumb_mul;
+  logic [31:0]      dot_crumb_result;
+
   logic [1:0][16:0] dot_short_op_a;
   logic [1:0][16:0] dot_short_op_b;
   logic [1:0][33:0] dot_short_mul;
@@ -241,6 +336,50 @@ module riscv_mult
                             $signed(dot_char_mul[2]) + $signed(dot_char_mul[3]) +
                             $signed(dot_op_c_i);
 
+  // upper 4 lanes of the 8 lane dot product, added on top of dot_char_result
+  assign dot_pair_op_a[0] = {dot_signed_i[1] & dot_op_a_pair_i[ 7], dot_op_a_pair_i[ 7: 0]};
+  assign dot_pair_op_a[1] = {dot_signed_i[1] & dot_op_a_pair_i[15], dot_op_a_pair_i[15: 8]};
+  assign dot_pair_op_a[2] = {dot_signed_i[1] & dot_op_a_pair_i[23], dot_op_a_pair_i[23:16]};
+  assign dot_pair_op_a[3] = {dot_signed_i[1] & dot_op_a_pair_i[31], dot_op_a_pair_i[31:24]};
+
+  assign dot_pair_op_b[0] = {dot_signed_i[0] & dot_op_b_pair_i[ 7], dot_op_b_pair_i[ 7: 0]};
+  assign dot_pair_op_b[1] = {dot_signed_i[0] & dot_op_b_pair_i[15], dot_op_b_pair_i[15: 8]};
+  assign dot_pair_op_b[2] = {dot_signed_i[0] & dot_op_b_pair_i[23], dot_op_b_pair_i[23:16]};
+  assign dot_pair_op_b[3] = {dot_signed_i[0] & dot_op_b_pair_i[31], dot_op_b_pair_i[31:24]};
+
+  assign dot_pair_mul[0]  = $signed(dot_pair_op_a[0]) * $signed(dot_pair_op_b[0]);
+  assign dot_pair_mul[1]  = $signed(dot_pair_op_a[1]) * $signed(dot_pair_op_b[1]);
+  assign dot_pair_mul[2]  = $signed(dot_pair_op_a[2]) * $signed(dot_pair_op_b[2]);
+  assign dot_pair_mul[3]  = $signed(dot_pair_op_a[3]) * $signed(dot_pair_op_b[3]);
+
+  assign dot_pair_result  = $signed(dot_char_result) +
+                            $signed(dot_pair_mul[0]) + $signed(dot_pair_mul[1]) +
+                            $signed(dot_pair_mul[2]) + $signed(dot_pair_mul[3]);
+
+
+  // nibble and crumb lanes, same signedness rules as the char lanes
+  always_comb
+  begin
+    dot_nibble_result = dot_op_c_i;
+    for (int i = 0; i < 8; i++) begin
+      dot_nibble_op_a[i] = {dot_signed_i[1] & dot_op_a_i[4*i+3], dot_op_a_i[4*i +: 4]};
+      dot_nibble_op_b[i] = {dot_signed_i[0] & dot_op_b_i[4*i+3], dot_op_b_i[4*i +: 4]};
+      dot_nibble_mul[i]  = $signed(dot_nibble_op_a[i]) * $signed(dot_nibble_op_b[i]);
+      dot_nibble_result  = $signed(dot_nibble_result) + $signed(dot_nibble_mul[i]);
+    end
+  end
+
+  always_comb
+  begin
+    dot_crumb_result = dot_op_c_i;
+    for (int i = 0; i < 16; i++) begin
+      dot_crumb_op_a[i] = {dot_signed_i[1] & dot_op_a_i[2*i+1], dot_op_a_i[2*i +: 2]};
+      dot_crumb_op_b[i] = {dot_signed_i[0] & dot_op_b_i[2*i+1], dot_op_b_i[2*i +: 2]};
+      dot_crumb_mul[i]  = $signed(dot_crumb_op_a[i]) * $signed(dot_crumb_op_b[i]);
+      dot_crumb_result  = $signed(dot_crumb_result) + $signed(dot_crumb_mul[i]);
+    end
+  end
+
 
   assign dot_short_op_a[0] = {dot_signed_i[1] & dot_op_a_i[15], dot_op_a_i[15: 0]};
   assign dot_short_op_a[1] = {dot_signed_i[1] & dot_op_a_i[31], dot_op_a_i[31:16]};
@@ -270,10 +409,14 @@ module riscv_mult
     unique case (operator_i)
       MUL_MAC32, MUL_MSU32: result_o = int_result[31:0];
 
-      MUL_I, MUL_IR, MUL_H: result_o = short_result[31:0];
+      MUL_I, MUL_IR: result_o = short_result[31:0];
+      MUL_H:         result_o = mulh_result;
 
       MUL_DOT8:  result_o = dot_char_result[31:0];
       MUL_DOT16: result_o = dot_short_result[31:0];
+      MUL_DOT8P: result_o = dot_pair_result[31:0];
+      MUL_DOT4:  result_o = dot_nibble_result[31:0];
+      MUL_DOT2:  result_o = dot_crumb_result[31:0];
 
       default: ; // default case to suppress unique warning
     endcase
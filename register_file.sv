@@ -48,6 +48,13 @@ module riscv_register_file
   input  logic [ADDR_WIDTH-1:0]  raddr_c_i,
   output logic [DATA_WIDTH-1:0]  rdata_c_o,
 
+  //Read ports R4/R5, second registers of the dot product pairs
+  input  logic [ADDR_WIDTH-1:0]  raddr_d_i,
+  output logic [DATA_WIDTH-1:0]  rdata_d_o,
+
+  input  logic [ADDR_WIDTH-1:0]  raddr_e_i,
+  output logic [DATA_WIDTH-1:0]  rdata_e_o,
+
   // Write port W1
   input  logic [ADDR_WIDTH-1:0]   waddr_a_i,
   input  logic [DATA_WIDTH-1:0]   wdata_a_i,
@@ -85,6 +92,8 @@ module riscv_register_file
   assign rdata_a_o = mem[raddr_a_i];
   assign rdata_b_o = mem[raddr_b_i];
   assign rdata_c_o = mem[raddr_c_i];
+  assign rdata_d_o = mem[raddr_d_i];
+  assign rdata_e_o = mem[raddr_e_i];
 
 
   //-----------------------------------------------------------------------------
@@ -31,7 +31,15 @@ import riscv_defines::*;
 module riscv_core
 #(
   parameter N_EXT_PERF_COUNTERS = 0,
-  parameter INSTR_RDATA_WIDTH   = 32
+  parameter INSTR_RDATA_WIDTH   = 32,
+  parameter PERF_CNT64          = 0,   // 64 bit performance counters
+  parameter PERF_IRQ_ID         = 31,  // irq line raised by counter overflows
+  parameter FAST_DIV            = 0,   // radix-4, zero skipping divider
+  parameter MULH_MODE           = 0,   // mulh: 0 iterative, 1 single cycle, 2 two cycles
+  parameter BRANCH_PREDICT      = 0,   // predict backward branches taken in ID
+  parameter BTB_ENTRIES         = 0,   // branch target buffer entries in IF, 0: none
+  parameter LOAD_FWD            = 0,   // forward load data into EX, no load-use stall
+  parameter COPROC              = 0    // a coprocessor is attached, OPCODE_COP is legal
 )
 (
   // Clock and Reset
@@ -64,6 +72,15 @@ module riscv_core
   input  logic [31:0] data_rdata_i,
   input  logic        data_err_i,
 
+  // Coprocessor interface: valid holds op and operands until ready, which
+  // also returns the result
+  output logic        cop_valid_o,
+  input  logic        cop_ready_i,
+  output logic [9:0]  cop_op_o,        // {funct7, funct3}
+  output logic [31:0] cop_operand_a_o, // rs1
+  output logic [31:0] cop_operand_b_o, // rs2
+  input  logic [31:0] cop_result_i,    // written to rd
+
   // Interrupt inputs
   input  logic [31:0] irq_i,                 // level sensitive IR lines
 
@@ -120,6 +137,10 @@ module riscv_core
   logic [31:0] jump_target_id, jump_target_ex;
   logic        branch_in_ex;
   logic        branch_decision;
+  logic        branch_redirect_ex;  // mispredicted branch in EX
+  logic [31:0] branch_target_ex;
+  logic        btb_hit_id;
+  logic        btb_taken_id;
 
   logic        ctrl_busy;
   logic        if_busy;
@@ -139,7 +160,7 @@ module riscv_core
   logic [ 1:0] alu_vec_mode_ex;
 
   // Multiplier Control
-  logic [ 2:0] mult_operator_ex;
+  logic [ 3:0] mult_operator_ex;
   logic [31:0] mult_operand_a_ex;
   logic [31:0] mult_operand_b_ex;
   logic [31:0] mult_operand_c_ex;
@@ -150,8 +171,12 @@ module riscv_core
   logic [31:0] mult_dot_op_a_ex;
   logic [31:0] mult_dot_op_b_ex;
   logic [31:0] mult_dot_op_c_ex;
+  logic [31:0] mult_dot_op_a_pair_ex;
+  logic [31:0] mult_dot_op_b_pair_ex;
   logic [ 1:0] mult_dot_signed_ex;
 
+  logic [ 2:0] ld_fwd_ex;
+
   // Register Write Control
   logic [4:0]  regfile_waddr_ex;
   logic        regfile_we_ex;
@@ -170,6 +195,10 @@ module riscv_core
   logic        csr_access_ex;
   logic  [1:0] csr_op_ex;
 
+  // Coprocessor control
+  logic        cop_en_ex;
+  logic  [9:0] cop_op_ex;
+
   logic        csr_access;
   logic  [1:0] csr_op;
   logic [11:0] csr_addr;
@@ -207,6 +236,8 @@ module riscv_core
   // Interrupts
   logic        irq_enable;
   logic [31:0] mepc;
+  logic        perf_irq;
+  logic [31:0] irq_int;
 
   logic [5:0]  exc_cause;
   logic        save_exc_cause;
@@ -255,6 +286,7 @@ module riscv_core
   // Performance Counters
   logic        perf_imiss;
   logic        perf_jump;
+  logic        perf_btb_miss;
   logic        perf_jr_stall;
   logic        perf_ld_stall;
 
@@ -308,7 +340,8 @@ module riscv_core
   riscv_if_stage
   #(
     .N_HWLP              ( N_HWLP            ),
-    .RDATA_WIDTH         ( INSTR_RDATA_WIDTH )
+    .RDATA_WIDTH         ( INSTR_RDATA_WIDTH ),
+    .BTB_ENTRIES         ( BTB_ENTRIES       )
   )
   if_stage_i
   (
@@ -337,6 +370,8 @@ module riscv_core
     .illegal_c_insn_id_o ( illegal_c_insn_id ),
     .pc_if_o             ( pc_if             ),
     .pc_id_o             ( pc_id             ),
+    .btb_hit_id_o        ( btb_hit_id        ),
+    .btb_taken_id_o      ( btb_taken_id      ),
 
     // control signals
     .clear_instr_valid_i ( clear_instr_valid ),
@@ -359,6 +394,12 @@ module riscv_core
     .jump_target_id_i    ( jump_target_id    ),
     .jump_target_ex_i    ( jump_target_ex    ),
 
+    // BTB update from the branch in EX
+    .btb_update_i        ( branch_in_ex      ),
+    .btb_update_pc_i     ( pc_ex             ),
+    .btb_update_target_i ( branch_target_ex  ),
+    .btb_update_taken_i  ( branch_decision   ),
+
     // pipeline stalls
     .halt_if_i           ( halt_if           ),
     .if_ready_o          ( if_ready          ),
@@ -380,7 +421,10 @@ module riscv_core
   /////////////////////////////////////////////////
   riscv_id_stage
   #(
-    .N_HWLP                       ( N_HWLP               )
+    .N_HWLP                       ( N_HWLP               ),
+    .BRANCH_PREDICT               ( BRANCH_PREDICT       ),
+    .LOAD_FWD                     ( LOAD_FWD             ),
+    .COPROC                       ( COPROC               )
   )
   id_stage_i
   (
@@ -406,6 +450,11 @@ module riscv_core
     .branch_decision_i            ( branch_decision      ),
     .jump_target_o                ( jump_target_id       ),
 
+    .btb_hit_i                    ( btb_hit_id           ),
+    .btb_taken_i                  ( btb_taken_id         ),
+    .branch_redirect_ex_o         ( branch_redirect_ex   ),
+    .branch_target_ex_o           ( branch_target_ex     ),
+
     // IF and ID control signals
     .clear_instr_valid_o          ( clear_instr_valid    ),
     .pc_set_o                     ( pc_set               ),
@@ -462,12 +511,20 @@ module riscv_core
     .mult_dot_op_a_ex_o           ( mult_dot_op_a_ex     ), // from ID to EX stage
     .mult_dot_op_b_ex_o           ( mult_dot_op_b_ex     ), // from ID to EX stage
     .mult_dot_op_c_ex_o           ( mult_dot_op_c_ex     ), // from ID to EX stage
+    .mult_dot_op_a_pair_ex_o      ( mult_dot_op_a_pair_ex ), // from ID to EX stage
+    .mult_dot_op_b_pair_ex_o      ( mult_dot_op_b_pair_ex ), // from ID to EX stage
     .mult_dot_signed_ex_o         ( mult_dot_signed_ex   ), // from ID to EX stage
 
+    .ld_fwd_ex_o                  ( ld_fwd_ex            ), // from ID to EX stage
+
     // CSR ID/EX
     .csr_access_ex_o              ( csr_access_ex        ),
     .csr_op_ex_o                  ( csr_op_ex            ),
 
+    // coprocessor ID/EX
+    .cop_en_ex_o                  ( cop_en_ex            ),
+    .cop_op_ex_o                  ( cop_op_ex            ),
+
     // hardware loop signals to IF hwlp controller
     .hwlp_start_o                 ( hwlp_start           ),
     .hwlp_end_o                   ( hwlp_end             ),
@@ -492,7 +549,7 @@ module riscv_core
     .data_misaligned_i            ( data_misaligned      ),
 
     // Interrupt Signals
-    .irq_i                        ( irq_i                ), // incoming interrupts
+    .irq_i                        ( irq_int              ), // incoming interrupts
     .irq_enable_i                 ( irq_enable           ), // global interrupt enable
     .exc_cause_o                  ( exc_cause            ),
     .save_exc_cause_o             ( save_exc_cause       ),
@@ -533,6 +590,7 @@ module riscv_core
 
     // Performance Counters
     .perf_jump_o                  ( perf_jump            ),
+    .perf_btb_miss_o              ( perf_btb_miss        ),
     .perf_jr_stall_o              ( perf_jr_stall        ),
     .perf_ld_stall_o              ( perf_ld_stall        )
   );
@@ -546,7 +604,12 @@ module riscv_core
   //  |_____/_/\_\ |____/ |_/_/   \_\____|_____|     //
   //                                                 //
   /////////////////////////////////////////////////////
-  riscv_ex_stage  ex_stage_i
+  riscv_ex_stage
+  #(
+    .FAST_DIV                   ( FAST_DIV                     ),
+    .MULH_MODE                  ( MULH_MODE                    )
+  )
+  ex_stage_i
   (
     // Global signals: Clock and active low asynchronous reset
     .clk                        ( clk                          ),
@@ -574,14 +637,30 @@ module riscv_core
     .mult_dot_op_a_i            ( mult_dot_op_a_ex             ), // from ID/EX pipe registers
     .mult_dot_op_b_i            ( mult_dot_op_b_ex             ), // from ID/EX pipe registers
     .mult_dot_op_c_i            ( mult_dot_op_c_ex             ), // from ID/EX pipe registers
+    .mult_dot_op_a_pair_i       ( mult_dot_op_a_pair_ex        ), // from ID/EX pipe registers
+    .mult_dot_op_b_pair_i       ( mult_dot_op_b_pair_ex        ), // from ID/EX pipe registers
     .mult_dot_signed_i          ( mult_dot_signed_ex           ), // from ID/EX pipe registers
 
     .mult_multicycle_o          ( mult_multicycle              ), // to ID/EX pipe registers
 
+    // early load forwarding
+    .ld_fwd_i                   ( ld_fwd_ex                    ), // from ID/EX pipe registers
+    .lsu_rdata_i                ( regfile_wdata                ), // from LSU
+
     // interface with CSRs
     .csr_access_i               ( csr_access_ex                ),
     .csr_rdata_i                ( csr_rdata                    ),
 
+    // coprocessor
+    .cop_en_i                   ( cop_en_ex                    ), // from ID/EX pipe registers
+    .cop_op_i                   ( cop_op_ex                    ), // from ID/EX pipe registers
+    .cop_valid_o                ( cop_valid_o                  ),
+    .cop_ready_i                ( cop_ready_i                  ),
+    .cop_op_o                   ( cop_op_o                     ),
+    .cop_operand_a_o            ( cop_operand_a_o              ),
+    .cop_operand_b_o            ( cop_operand_b_o              ),
+    .cop_result_i               ( cop_result_i                 ),
+
     // From ID Stage: Regfile control signals
     .branch_in_ex_i             ( branch_in_ex                 ),
     .regfile_alu_waddr_i        ( regfile_alu_waddr_ex         ),
@@ -681,7 +760,8 @@ module riscv_core
 
   riscv_cs_registers
   #(
-    .N_EXT_CNT       ( N_EXT_PERF_COUNTERS   )
+    .N_EXT_CNT       ( N_EXT_PERF_COUNTERS   ),
+    .PERF_CNT64      ( PERF_CNT64            )
   )
   cs_registers_i
   (
@@ -733,15 +813,21 @@ module riscv_core
     .jump_i                  ( perf_jump          ),
     .branch_i                ( branch_in_ex       ),
     .branch_taken_i          ( branch_decision    ),
+    .branch_mispred_i        ( branch_redirect_ex ),
+    .btb_miss_i              ( perf_btb_miss      ),
     .ld_stall_i              ( perf_ld_stall      ),
     .jr_stall_i              ( perf_jr_stall      ),
 
     .mem_load_i              ( data_req_o & data_gnt_i & (~data_we_o) ),
     .mem_store_i             ( data_req_o & data_gnt_i & data_we_o    ),
 
-    .ext_counters_i          ( ext_perf_counters_i                    )
+    .ext_counters_i          ( ext_perf_counters_i                    ),
+    .perf_irq_o              ( perf_irq                               )
   );
 
+  // counter overflows share the external interrupt lines
+  assign irq_int = irq_i | (32'(perf_irq) << PERF_IRQ_ID);
+
   // Mux for CSR access through Debug Unit
   assign csr_access   = (dbg_csr_req == 1'b0) ? csr_access_ex : 1'b1;
   assign csr_addr     = (dbg_csr_req == 1'b0) ? csr_addr_int     : dbg_csr_addr;
@@ -814,7 +900,7 @@ module riscv_core
     .sleeping_i        ( sleeping           ),
 
     .branch_in_ex_i    ( branch_in_ex       ),
-    .branch_taken_i    ( branch_decision    ),
+    .branch_taken_i    ( branch_redirect_ex ), // fetch was redirected by the branch
 
     .jump_addr_o       ( dbg_jump_addr      ), // PC from debug unit
     .jump_req_o        ( dbg_jump_req       )  // set PC to new value
@@ -876,6 +962,45 @@ module riscv_core
   );
 `endif
 
+`ifdef TRACE_BINARY
+  riscv_tracer_bin riscv_tracer_bin_i
+  (
+    .clk            ( clk_i                                ), // always-running clock for tracing
+    .rst_n          ( rst_ni                               ),
+
+    .fetch_enable   ( fetch_enable_i                       ),
+    .core_id        ( core_id_i                            ),
+    .cluster_id     ( cluster_id_i                         ),
+
+    .pc             ( id_stage_i.pc_id_i                   ),
+    .instr          ( id_stage_i.instr                     ),
+    .id_valid       ( id_stage_i.id_valid_o                ),
+    .is_decoding    ( id_stage_i.is_decoding_o             ),
+    .is_illegal     ( id_stage_i.illegal_insn_dec          ),
+    .pipe_flush     ( id_stage_i.controller_i.pipe_flush_i ),
+
+    .ex_valid       ( ex_valid                             ),
+    .ex_reg_addr    ( regfile_alu_waddr_fw                 ),
+    .ex_reg_we      ( regfile_alu_we_fw                    ),
+    .ex_reg_wdata   ( regfile_alu_wdata_fw                 ),
+
+    .ex_data_addr   ( data_addr_o                          ),
+    .ex_data_req    ( data_req_o                           ),
+    .ex_data_gnt    ( data_gnt_i                           ),
+    .ex_data_we     ( data_we_o                            ),
+
+    .lsu_misaligned ( data_misaligned                      ),
+    .wb_bypass      ( ex_stage_i.branch_in_ex_i            ),
+
+    .wb_valid       ( wb_valid                             ),
+    .wb_reg_addr    ( regfile_waddr_fw_wb_o                ),
+    .wb_reg_we      ( regfile_we_wb                        ),
+    .wb_reg_wdata   ( regfile_wdata                        ),
+
+    .wb_data_rvalid ( data_rvalid_i                        )
+  );
+`endif
+
 `ifdef SIMCHECKER
   logic is_interrupt;
   assign is_interrupt = (pc_mux_id == PC_EXCEPTION) && (exc_pc_mux_id == EXC_PC_IRQ);
@@ -0,0 +1,266 @@
+// Copyright 2015 ETH Zurich and University of Bologna.
+// Copyright and related rights are licensed under the Solderpad Hardware
+// License, Version 0.51 (the “License”); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+// http://solderpad.org/licenses/SHL-0.51. Unless required by applicable law
+// or agreed to in writing, software, hardware and materials distributed under
+// this License is distributed on an “AS IS” BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+////////////////////////////////////////////////////////////////////////////////
+// Design Name:    RISC-V Retire Tracker                                      //
+// Project Name:   RI5CY                                                      //
+// Language:       SystemVerilog                                              //
+//                                                                            //
+// Description:    Follows every instruction from ID through EX and WB and    //
+//                 hands over one record per instruction, in program order,   //
+//                 once it is complete: its register writes and its data      //
+//                 accesses. Plain registers instead of classes and           //
+//                 mailboxes so that it runs under Verilator. Shared by       //
+//                 riscv_tracer_bin and riscv_simchecker.                     //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+module riscv_retire_tracker
+#(
+  parameter INFO_WIDTH = 1    // caller data latched with the instruction in ID
+)
+(
+  // Clock and Reset
+  input  logic                  clk,
+  input  logic                  rst_n,
+
+  input  logic [31:0]           pc,
+  input  logic [31:0]           instr,
+  input  logic [INFO_WIDTH-1:0] info,
+  input  logic                  id_valid,
+  input  logic                  is_decoding,
+  input  logic                  is_illegal,
+  input  logic                  pipe_flush,
+
+  input  logic                  ex_valid,
+  input  logic [ 4:0]           ex_reg_addr,
+  input  logic                  ex_reg_we,
+  input  logic [31:0]           ex_reg_wdata,
+
+  input  logic                  ex_data_req,
+  input  logic                  ex_data_gnt,
+  input  logic                  ex_data_we,
+  input  logic [31:0]           ex_data_addr,
+  input  logic [31:0]           ex_data_wdata,
+
+  input  logic                  lsu_misaligned,
+  input  logic                  wb_bypass,
+
+  input  logic                  wb_valid,
+  input  logic [ 4:0]           wb_reg_addr,
+  input  logic                  wb_reg_we,
+  input  logic [31:0]           wb_reg_wdata,
+
+  input  logic                  wb_data_rvalid,
+  input  logic [31:0]           wb_data_rdata,
+
+  // the oldest instruction, valid while retire_o is set
+  output logic                  retire_o,
+  output logic [31:0]           cycle_o,
+  output logic [31:0]           pc_o,
+  output logic [31:0]           instr_o,
+  output logic [INFO_WIDTH-1:0] info_o,
+  output logic                  ex_we_o,
+  output logic [ 4:0]           ex_waddr_o,
+  output logic [31:0]           ex_wdata_o,
+  output logic                  wb_we_o,
+  output logic [ 4:0]           wb_waddr_o,
+  output logic [31:0]           wb_wdata_o,
+  output logic [ 1:0]           n_acc_o,
+  output logic [ 1:0]           acc_we_o,
+  output logic [ 1:0][31:0]     acc_addr_o,
+  output logic [ 1:0][31:0]     acc_data_o
+);
+
+  // A record collects what one instruction did: the last write of the EX
+  // register port (ALU result, post-increment address), the last write of the
+  // WB port (load data) and its data accesses, two when misaligned. Load data
+  // and the responses to stores arrive in order, each goes to the oldest
+  // record still waiting for one.
+  typedef struct packed {
+    logic [31:0]           cycle;
+    logic [31:0]           pc;
+    logic [31:0]           instr;
+    logic [INFO_WIDTH-1:0] info;
+    logic                  ex_we;
+    logic [ 4:0]           ex_waddr;
+    logic [31:0]           ex_wdata;
+    logic                  wb_we;
+    logic [ 4:0]           wb_waddr;
+    logic [31:0]           wb_wdata;
+    logic                  load;
+    logic [ 1:0]           n_acc;
+    logic [ 1:0]           n_rvalid;
+    logic [ 1:0]           acc_we;
+    logic [ 1:0][31:0]     acc_addr;
+    logic [ 1:0][31:0]     acc_data;   // store data, or load data once it arrived
+  } rec_t;
+
+  // Instructions between EX and the oldest one not written back yet. The LSU
+  // has one access outstanding, so at most one instruction waits in WB, and
+  // only branches leave EX past it, at most one per cycle until its data
+  // arrives. The RAM and the peripherals answer the cycle after the grant,
+  // the depth leaves room for TCDM conflicts and a few wait states on top.
+  // ram.sv takes any +data_lat/+slow_lat/+wait_pct, so this is no bound:
+  // a run that exceeds it stops with $fatal below instead of misaligning
+  // every later record.
+  localparam WB_LATENCY = 7;
+  localparam WB_DEPTH   = 1 + WB_LATENCY;
+
+  logic [31:0] cycles;
+
+  logic                        ex_busy_q;
+  rec_t                        ex_q, ex_n;
+  rec_t                        wb_q [WB_DEPTH];
+  rec_t                        wb_n [WB_DEPTH];
+  rec_t                        wb_head;
+  logic [$clog2(WB_DEPTH)-1:0] wb_rptr_q, wb_wptr_q;
+  logic [$clog2(WB_DEPTH):0]   wb_cnt_q;
+  logic                        id_log, ex_done, ex_push, wb_done;
+
+  // - special case for WFI because we don't wait for unstalling there
+  // - special case for illegal instructions, since they will not go through
+  //   the pipe
+  assign id_log  = (id_valid && is_decoding) || pipe_flush || (is_decoding && is_illegal);
+  assign ex_done = ex_busy_q && ((ex_valid && !lsu_misaligned) || wb_bypass);
+
+  // instructions that never finish in EX (illegal, WFI, ...) leave it when
+  // the next one comes
+  assign ex_push = ex_done || (ex_busy_q && id_log);
+
+  always_comb
+  begin : rec_update
+    logic [$clog2(WB_DEPTH)-1:0] idx;
+    logic                        rvalid_free, wb_we_free;
+
+    ex_n = ex_q;
+    if (ex_reg_we) begin
+      ex_n.ex_we    = 1'b1;
+      ex_n.ex_waddr = ex_reg_addr;
+      ex_n.ex_wdata = ex_reg_wdata;
+    end
+    if (ex_data_req && ex_data_gnt && (ex_q.n_acc != 2'd2)) begin
+      ex_n.acc_we[ex_q.n_acc[0]]   = ex_data_we;
+      ex_n.acc_addr[ex_q.n_acc[0]] = ex_data_addr;
+      ex_n.acc_data[ex_q.n_acc[0]] = ex_data_wdata;
+      ex_n.load                    = ex_q.load | ~ex_data_we;
+      ex_n.n_acc                   = ex_q.n_acc + 2'd1;
+    end
+
+    rvalid_free = wb_data_rvalid;
+    wb_we_free  = wb_reg_we;
+
+    for (int i = 0; i < WB_DEPTH; i++) begin
+      idx       = wb_rptr_q + i;
+      wb_n[idx] = wb_q[idx];
+
+      if (i < wb_cnt_q) begin
+        if (rvalid_free && (wb_q[idx].n_rvalid != wb_q[idx].n_acc)) begin
+          if (!wb_q[idx].acc_we[wb_q[idx].n_rvalid[0]])
+            wb_n[idx].acc_data[wb_q[idx].n_rvalid[0]] = wb_data_rdata;
+          wb_n[idx].n_rvalid = wb_q[idx].n_rvalid + 2'd1;
+          rvalid_free        = 1'b0;
+        end
+
+        if (wb_we_free && wb_q[idx].load) begin
+          wb_n[idx].wb_we    = 1'b1;
+          wb_n[idx].wb_waddr = wb_reg_addr;
+          wb_n[idx].wb_wdata = wb_reg_wdata;
+          wb_we_free         = 1'b0;
+        end
+      end
+    end
+
+    // the first half of a misaligned access completes while still in EX
+    if (rvalid_free && ex_busy_q && (ex_q.n_rvalid != ex_q.n_acc)) begin
+      if (!ex_q.acc_we[ex_q.n_rvalid[0]])
+        ex_n.acc_data[ex_q.n_rvalid[0]] = wb_data_rdata;
+      ex_n.n_rvalid = ex_q.n_rvalid + 2'd1;
+    end
+  end
+
+  // the oldest record is handed over once all its responses are in, loads
+  // also wait for the write back of their data
+  assign wb_head = wb_n[wb_rptr_q];
+  assign wb_done = (wb_cnt_q != 0) && (wb_head.n_rvalid == wb_head.n_acc) &&
+                   (!wb_head.load || wb_valid);
+
+  always_ff @(posedge clk, negedge rst_n)
+  begin
+    if (rst_n == 1'b0)
+    begin
+      cycles    <= '0;
+      ex_busy_q <= 1'b0;
+      ex_q      <= '0;
+      wb_rptr_q <= '0;
+      wb_wptr_q <= '0;
+      wb_cnt_q  <= '0;
+      for (int i = 0; i < WB_DEPTH; i++)
+        wb_q[i] <= '0;
+    end
+    else
+    begin
+      cycles <= cycles + 1;
+
+      if (id_log) begin
+        ex_busy_q     <= 1'b1;
+        ex_q          <= '0;
+        ex_q.cycle    <= cycles;
+        ex_q.pc       <= pc;
+        ex_q.instr    <= instr;
+        ex_q.info     <= info;
+      end else if (ex_done) begin
+        ex_busy_q     <= 1'b0;
+      end else begin
+        ex_q          <= ex_n;
+      end
+
+      for (int i = 0; i < WB_DEPTH; i++)
+        wb_q[i] <= wb_n[i];
+
+      if (ex_push) begin
+        wb_q[wb_wptr_q] <= ex_n;
+        wb_wptr_q       <= wb_wptr_q + 1;
+      end
+
+      if (wb_done)
+        wb_rptr_q       <= wb_rptr_q + 1;
+
+      wb_cnt_q <= wb_cnt_q + ex_push - wb_done;
+    end
+  end
+
+  assign retire_o   = wb_done;
+  assign cycle_o    = wb_head.cycle;
+  assign pc_o       = wb_head.pc;
+  assign instr_o    = wb_head.instr;
+  assign info_o     = wb_head.info;
+  assign ex_we_o    = wb_head.ex_we;
+  assign ex_waddr_o = wb_head.ex_waddr;
+  assign ex_wdata_o = wb_head.ex_wdata;
+  assign wb_we_o    = wb_head.wb_we;
+  assign wb_waddr_o = wb_head.wb_waddr;
+  assign wb_wdata_o = wb_head.wb_wdata;
+  assign n_acc_o    = wb_head.n_acc;
+  assign acc_we_o   = wb_head.acc_we;
+  assign acc_addr_o = wb_head.acc_addr;
+  assign acc_data_o = wb_head.acc_data;
+
+`ifndef SYNTHESIS
+  // a record dropped here would shift every later one by an instruction;
+  // not an assertion, Verilator only evaluates those with --assert
+  always_ff @(posedge clk)
+  begin : p_overflow
+    if (rst_n && ex_push && !wb_done && (wb_cnt_q == WB_DEPTH))
+      $fatal(1, "riscv_retire_tracker: more than %0d instructions between EX and WB, raise WB_LATENCY", WB_DEPTH);
+  end
+`endif
+
+endmodule
@@ -18,6 +18,10 @@
 // Language:       SystemVerilog                                              //
 //                                                                            //
 // Description:    Compares the executed instructions with a golden model     //
+//                 (verilator-model/simchecker_dpi.cpp). Follows every        //
+//                 instruction through EX and WB with riscv_retire_tracker,   //
+//                 like riscv_tracer_bin, and hands over its register writes  //
+//                 and data accesses through DPI.                             //
 //                                                                            //
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -33,6 +37,7 @@ import "DPI-C" function int     riscv_checker_step(input chandle cpu, input long
 import "DPI-C" function void    riscv_checker_irq(input chandle cpu, input int irq, input int irq_no);
 import "DPI-C" function void    riscv_checker_mem_access(input chandle cpu, input int we, input logic [31:0] addr, input logic [31:0] data);
 import "DPI-C" function void    riscv_checker_reg_access(input chandle cpu, input logic [31:0] addr, input logic [31:0] data);
+import "DPI-C" function void    riscv_checker_final(input chandle cpu);
 `endif
 
 module riscv_simchecker
@@ -84,195 +89,88 @@ module riscv_simchecker
 );
 
 `ifdef SIMCHECKER
-  // DPI stuff
-  chandle dpi_simdata;
-
-  // SV-only stuff
-  typedef struct {
-    logic [ 4:0] addr;
-    logic [31:0] value;
-  } reg_t;
-
-  typedef struct {
-    logic [31:0] addr;
-    logic        we;
-    logic [ 3:0] be;
-    logic [31:0] wdata;
-    logic [31:0] rdata;
-  } mem_acc_t;
-
-  class instr_trace_t;
-    time         simtime;
-    int          cycles;
-    logic [31:0] pc;
-    logic [31:0] instr;
-    logic        irq;
-    logic [ 4:0] irq_no;
-    logic        wb_bypass;
-    reg_t        regs_write[$];
-    mem_acc_t    mem_access[$];
-
-    function new ();
-      irq        = 1'b0;
-      wb_bypass  = 1'b1;
-      regs_write = {};
-      mem_access = {};
-    endfunction
-  endclass
-
-  mailbox rdata_stack = new (4);
-  integer rdata_writes = 0;
-
-  integer      cycles;
+  chandle      dpi_simdata;
+  logic        opened;
 
   logic [15:0] instr_compressed_id;
   logic        is_irq_if, is_irq_id;
   logic [ 4:0] irq_no_id, irq_no_if;
 
-  mailbox instr_ex = new (4);
-  mailbox instr_wb = new (4);
-
-  // simchecker initialization
-  initial
-  begin
-    wait(rst_n == 1'b1);
-    wait(fetch_enable == 1'b1);
-
-    dpi_simdata = riscv_checker_init(boot_addr, core_id, cluster_id);
-  end
-
-  // virtual ID/EX pipeline
-  initial
-  begin
-    instr_trace_t trace;
-    mem_acc_t     mem_acc;
-    reg_t         reg_write;
-
-    while(1) begin
-      instr_ex.get(trace);
-
-      // wait until we are going to the next stage
-      do begin
-        @(negedge clk);
-
-        reg_write.addr  = ex_reg_addr;
-        reg_write.value = ex_reg_wdata;
-
-        if (ex_reg_we)
-          trace.regs_write.push_back(reg_write);
-
-        // look for data accesses and log them
-        if (ex_data_req && ex_data_gnt) begin
-          mem_acc.addr = ex_data_addr;
-          mem_acc.we   = ex_data_we;
-
-          if (mem_acc.we)
-            mem_acc.wdata = ex_data_wdata;
-          else
-            mem_acc.wdata = 'x;
-
-          trace.mem_access.push_back(mem_acc);
-        end
-      end while ((!ex_valid || lsu_misaligned) && (!wb_bypass));
-
-      trace.wb_bypass = wb_bypass;
-
-      instr_wb.put(trace);
-    end
-  end
-
-  // virtual EX/WB pipeline
-  initial
-  begin
-    instr_trace_t trace;
-    reg_t         reg_write;
-    logic [31:0]  tmp_discard;
-
-    while(1) begin
-      instr_wb.get(trace);
-
-      if (!trace.wb_bypass) begin
-        // wait until we are going to the next stage
-        do begin
-          @(negedge clk);
-          #1;
-
-          // pop rdata from stack when there were pending writes
-          while(rdata_stack.num() > 0 && rdata_writes > 0) begin
-            rdata_writes--;
-            rdata_stack.get(tmp_discard);
-          end
-
-        end while (!wb_valid);
-
-        reg_write.addr  = wb_reg_addr;
-        reg_write.value = wb_reg_wdata;
-
-        if (wb_reg_we)
-          trace.regs_write.push_back(reg_write);
-
-        // take care of rdata
-        foreach(trace.mem_access[i]) begin
-          if (trace.mem_access[i].we) begin
-            // for writes we don't need to wait for the rdata, so if it has
-            // not appeared yet, we count it and remove it later from out
-            // stack
-            if (rdata_stack.num() > 0)
-              rdata_stack.get(tmp_discard);
-            else
-              rdata_writes++;
-
-          end else begin
-            if (rdata_stack.num() == 0)
-              $warning("rdata stack is empty, but we are waiting for a read");
-
-            if (rdata_writes > 0)
-              $warning("rdata_writes is > 0, but we are waiting for a read");
-
-            rdata_stack.get(trace.mem_access[i].rdata);
-          end
-        end
-      end
-
-      // instruction is ready now, all data is inserted
-      foreach(trace.mem_access[i]) begin
-        if (trace.mem_access[i].we)
-          riscv_checker_mem_access(dpi_simdata, trace.mem_access[i].we, trace.mem_access[i].addr, trace.mem_access[i].wdata);
-        else
-          riscv_checker_mem_access(dpi_simdata, trace.mem_access[i].we, trace.mem_access[i].addr, trace.mem_access[i].rdata);
-      end
-
-      foreach(trace.regs_write[i]) begin
-        riscv_checker_reg_access(dpi_simdata, trace.regs_write[i].addr, trace.regs_write[i].value);
-      end
-
-      riscv_checker_irq(dpi_simdata, trace.irq, trace.irq_no);
-
-      if (riscv_checker_step(dpi_simdata, trace.simtime, trace.cycles, trace.pc, trace.instr))
-        $display("%t: Cluster %d, Core %d: Mismatch between simulator and RTL detected", trace.simtime, cluster_id, core_id);
-    end
-  end
-
-  // cycle counter
-  always_ff @(posedge clk, negedge rst_n)
-  begin
-    if (rst_n == 1'b0)
-      cycles = 0;
-    else
-      cycles = cycles + 1;
-  end
-
-  // create rdata stack
-  initial
-  begin
-    while(1) begin
-      @(negedge clk);
-
-      if (wb_data_rvalid) begin
-        rdata_stack.put(wb_data_rdata);
-      end
-    end
-  end
+  // simtime, irq and irq_no of the instruction travel with it
+  localparam INFO_WIDTH = 64 + 1 + 5;
+
+  logic [31:0]           id_instr;
+  logic                  retire;
+  logic [31:0]           rt_cycle, rt_pc, rt_instr;
+  logic [INFO_WIDTH-1:0] rt_info;
+  logic                  rt_ex_we, rt_wb_we;
+  logic [ 4:0]           rt_ex_waddr, rt_wb_waddr;
+  logic [31:0]           rt_ex_wdata, rt_wb_wdata;
+  logic [ 1:0]           rt_n_acc, rt_acc_we;
+  logic [ 1:0][31:0]     rt_acc_addr, rt_acc_data;
+  logic [63:0]           rt_simtime;
+  logic                  rt_irq;
+  logic [ 4:0]           rt_irq_no;
+
+  assign id_instr = is_compressed ? {instr_compressed_id, instr_compressed_id} : instr;
+
+  riscv_retire_tracker
+  #(
+    .INFO_WIDTH ( INFO_WIDTH )
+  )
+  tracker_i
+  (
+    .clk            ( clk                                          ),
+    .rst_n          ( rst_n                                        ),
+
+    .pc             ( pc                                           ),
+    .instr          ( id_instr                                     ),
+    .info           ( {64'($time), is_irq_id, irq_no_id}           ),
+    .id_valid       ( id_valid                                     ),
+    .is_decoding    ( is_decoding                                  ),
+    .is_illegal     ( is_illegal                                   ),
+    .pipe_flush     ( pipe_flush                                   ),
+
+    .ex_valid       ( ex_valid                                     ),
+    .ex_reg_addr    ( ex_reg_addr                                  ),
+    .ex_reg_we      ( ex_reg_we                                    ),
+    .ex_reg_wdata   ( ex_reg_wdata                                 ),
+
+    .ex_data_req    ( ex_data_req                                  ),
+    .ex_data_gnt    ( ex_data_gnt                                  ),
+    .ex_data_we     ( ex_data_we                                   ),
+    .ex_data_addr   ( ex_data_addr                                 ),
+    .ex_data_wdata  ( ex_data_wdata                                ),
+
+    .lsu_misaligned ( lsu_misaligned                               ),
+    .wb_bypass      ( wb_bypass                                    ),
+
+    .wb_valid       ( wb_valid                                     ),
+    .wb_reg_addr    ( wb_reg_addr                                  ),
+    .wb_reg_we      ( wb_reg_we                                    ),
+    .wb_reg_wdata   ( wb_reg_wdata                                 ),
+
+    .wb_data_rvalid ( wb_data_rvalid                               ),
+    .wb_data_rdata  ( wb_data_rdata                                ),
+
+    .retire_o       ( retire                                       ),
+    .cycle_o        ( rt_cycle                                     ),
+    .pc_o           ( rt_pc                                        ),
+    .instr_o        ( rt_instr                                     ),
+    .info_o         ( rt_info                                      ),
+    .ex_we_o        ( rt_ex_we                                     ),
+    .ex_waddr_o     ( rt_ex_waddr                                  ),
+    .ex_wdata_o     ( rt_ex_wdata                                  ),
+    .wb_we_o        ( rt_wb_we                                     ),
+    .wb_waddr_o     ( rt_wb_waddr                                  ),
+    .wb_wdata_o     ( rt_wb_wdata                                  ),
+    .n_acc_o        ( rt_n_acc                                     ),
+    .acc_we_o       ( rt_acc_we                                    ),
+    .acc_addr_o     ( rt_acc_addr                                  ),
+    .acc_data_o     ( rt_acc_data                                  )
+  );
+
+  assign {rt_simtime, rt_irq, rt_irq_no} = rt_info;
 
   always_ff @(posedge clk)
   begin
@@ -293,38 +191,38 @@ module riscv_simchecker
     end
   end
 
-  // log execution
-  initial
+  // the checker is created once the core runs, it returns null unless the run
+  // is given +simcheck or +simregion
+  always @(posedge clk)
   begin
-    instr_trace_t trace;
-
-    while(1) begin
-      @(negedge clk);
-
-      // - special case for WFI because we don't wait for unstalling there
-      // - special case for illegal instructions, since they will not go through
-      //   the pipe
-      if ((id_valid && is_decoding) || pipe_flush || (is_decoding && is_illegal))
-      begin
-        trace = new ();
-
-        trace.simtime    = $time;
-        trace.cycles      = cycles;
-        trace.pc         = pc;
-
-        if (is_compressed)
-          trace.instr = {instr_compressed_id, instr_compressed_id};
-        else
-          trace.instr = instr;
-
-        if (is_irq_id) begin
-          trace.irq    = 1'b1;
-          trace.irq_no = irq_no_id;
-        end
-
-        instr_ex.put(trace);
-      end
+    if (!rst_n)
+      opened <= 1'b0;
+    else if (!opened && fetch_enable) begin
+      dpi_simdata = riscv_checker_init(boot_addr, 32'(core_id), 32'(cluster_id));
+      opened <= 1'b1;
     end
+
+    if (rst_n && opened && retire && (dpi_simdata != null)) begin
+      for (int i = 0; i < 2; i++)
+        if (i < rt_n_acc)
+          riscv_checker_mem_access(dpi_simdata, 32'(rt_acc_we[i]), rt_acc_addr[i], rt_acc_data[i]);
+
+      if (rt_ex_we)
+        riscv_checker_reg_access(dpi_simdata, 32'(rt_ex_waddr), rt_ex_wdata);
+      if (rt_wb_we)
+        riscv_checker_reg_access(dpi_simdata, 32'(rt_wb_waddr), rt_wb_wdata);
+
+      riscv_checker_irq(dpi_simdata, 32'(rt_irq), 32'(rt_irq_no));
+
+      if (riscv_checker_step(dpi_simdata, rt_simtime, rt_cycle, rt_pc, rt_instr))
+        $display("%t: Cluster %d, Core %d: Mismatch between simulator and RTL detected", rt_simtime, cluster_id, core_id);
+    end
+  end
+
+  final
+  begin
+    if (dpi_simdata != null)
+      riscv_checker_final(dpi_simdata);
   end
 `endif
 
@@ -0,0 +1,173 @@
+// Copyright 2015 ETH Zurich and University of Bologna.
+// Copyright and related rights are licensed under the Solderpad Hardware
+// License, Version 0.51 (the “License”); you may not use this file except in
+// compliance with the License.  You may obtain a copy of the License at
+// http://solderpad.org/licenses/SHL-0.51. Unless required by applicable law
+// or agreed to in writing, software, hardware and materials distributed under
+// this License is distributed on an “AS IS” BASIS, WITHOUT WARRANTIES OR
+// CONDITIONS OF ANY KIND, either express or implied. See the License for the
+// specific language governing permissions and limitations under the License.
+
+////////////////////////////////////////////////////////////////////////////////
+// Design Name:    RISC-V Binary Tracer                                       //
+// Project Name:   RI5CY                                                      //
+// Language:       SystemVerilog                                              //
+//                                                                            //
+// Description:    Streams one fixed size record per executed instruction     //
+//                 through DPI (cycle, pc, instr, rd and its value, first     //
+//                 data address). Follows the instructions through EX and WB  //
+//                 with riscv_retire_tracker, plain registers instead of the  //
+//                 classes and mailboxes of riscv_tracer, so Verilator runs   //
+//                 it at full speed.                                          //
+//                 The records are formatted offline, see                     //
+//                 verilator-model/trace_decode.py.                           //
+//                                                                            //
+////////////////////////////////////////////////////////////////////////////////
+
+`include "riscv_config.sv"
+
+`ifdef TRACE_BINARY
+import "DPI-C" function chandle riscv_trace_open(input int cluster_id, input int core_id);
+import "DPI-C" function void    riscv_trace_record(input chandle trace, input int cycle, input int pc,
+                                                   input int instr, input int wdata, input int addr,
+                                                   input int rd_flags);
+import "DPI-C" function void    riscv_trace_close(input chandle trace);
+`endif
+
+module riscv_tracer_bin
+(
+  // Clock and Reset
+  input  logic        clk,
+  input  logic        rst_n,
+
+  input  logic        fetch_enable,
+  input  logic [3:0]  core_id,
+  input  logic [5:0]  cluster_id,
+
+  input  logic [31:0] pc,
+  input  logic [31:0] instr,
+  input  logic        id_valid,
+  input  logic        is_decoding,
+  input  logic        is_illegal,
+  input  logic        pipe_flush,
+
+  input  logic        ex_valid,
+  input  logic [ 4:0] ex_reg_addr,
+  input  logic        ex_reg_we,
+  input  logic [31:0] ex_reg_wdata,
+
+  input  logic        ex_data_req,
+  input  logic        ex_data_gnt,
+  input  logic        ex_data_we,
+  input  logic [31:0] ex_data_addr,
+
+  input  logic        lsu_misaligned,
+  input  logic        wb_bypass,
+
+  input  logic        wb_valid,
+  input  logic [ 4:0] wb_reg_addr,
+  input  logic        wb_reg_we,
+  input  logic [31:0] wb_reg_wdata,
+
+  input  logic        wb_data_rvalid
+);
+
+`ifdef TRACE_BINARY
+  // rd_flags: [4:0] rd, [8] rd written (wdata valid), [9] data access (addr
+  // valid), [10] the access was a store
+
+  chandle      trace;
+  logic        opened;
+
+  logic              retire;
+  logic [31:0]       rt_cycle, rt_pc, rt_instr;
+  logic              rt_ex_we, rt_wb_we;
+  logic [ 4:0]       rt_ex_waddr, rt_wb_waddr;
+  logic [31:0]       rt_ex_wdata, rt_wb_wdata;
+  logic [ 1:0]       rt_n_acc, rt_acc_we;
+  logic [ 1:0][31:0] rt_acc_addr;
+
+  logic              rd_ex, rd_wb;
+  logic [31:0]       wdata;
+
+  riscv_retire_tracker tracker_i
+  (
+    .clk            ( clk            ),
+    .rst_n          ( rst_n          ),
+
+    .pc             ( pc             ),
+    .instr          ( instr          ),
+    .info           ( 1'b0           ),
+    .id_valid       ( id_valid       ),
+    .is_decoding    ( is_decoding    ),
+    .is_illegal     ( is_illegal     ),
+    .pipe_flush     ( pipe_flush     ),
+
+    .ex_valid       ( ex_valid       ),
+    .ex_reg_addr    ( ex_reg_addr    ),
+    .ex_reg_we      ( ex_reg_we      ),
+    .ex_reg_wdata   ( ex_reg_wdata   ),
+
+    .ex_data_req    ( ex_data_req    ),
+    .ex_data_gnt    ( ex_data_gnt    ),
+    .ex_data_we     ( ex_data_we     ),
+    .ex_data_addr   ( ex_data_addr   ),
+    .ex_data_wdata  ( '0             ),
+
+    .lsu_misaligned ( lsu_misaligned ),
+    .wb_bypass      ( wb_bypass      ),
+
+    .wb_valid       ( wb_valid       ),
+    .wb_reg_addr    ( wb_reg_addr    ),
+    .wb_reg_we      ( wb_reg_we      ),
+    .wb_reg_wdata   ( wb_reg_wdata   ),
+
+    .wb_data_rvalid ( wb_data_rvalid ),
+    .wb_data_rdata  ( '0             ),
+
+    .retire_o       ( retire         ),
+    .cycle_o        ( rt_cycle       ),
+    .pc_o           ( rt_pc          ),
+    .instr_o        ( rt_instr       ),
+    .info_o         (                ),
+    .ex_we_o        ( rt_ex_we       ),
+    .ex_waddr_o     ( rt_ex_waddr    ),
+    .ex_wdata_o     ( rt_ex_wdata    ),
+    .wb_we_o        ( rt_wb_we       ),
+    .wb_waddr_o     ( rt_wb_waddr    ),
+    .wb_wdata_o     ( rt_wb_wdata    ),
+    .n_acc_o        ( rt_n_acc       ),
+    .acc_we_o       ( rt_acc_we      ),
+    .acc_addr_o     ( rt_acc_addr    ),
+    .acc_data_o     (                )
+  );
+
+  // as riscv_tracer: the value written to rd, from WB if it was loaded, and
+  // the first data access
+  assign rd_ex = rt_ex_we && (rt_ex_waddr == rt_instr[11:7]);
+  assign rd_wb = rt_wb_we && (rt_wb_waddr == rt_instr[11:7]);
+  assign wdata = rd_wb ? rt_wb_wdata : rt_ex_wdata;
+
+  // the writer is opened once the core runs, it returns null without +trace_bin
+  always @(posedge clk)
+  begin
+    if (!rst_n)
+      opened <= 1'b0;
+    else if (!opened && fetch_enable) begin
+      trace  = riscv_trace_open(32'(cluster_id), 32'(core_id));
+      opened <= 1'b1;
+    end
+
+    if (rst_n && opened && retire && (trace != null))
+      riscv_trace_record(trace, rt_cycle, rt_pc, rt_instr, wdata, rt_acc_addr[0],
+                         {21'b0, rt_acc_we[0], rt_n_acc != 2'd0, rd_ex || rd_wb, 3'b0, rt_instr[11:7]});
+  end
+
+  final
+  begin
+    if (trace != null)
+      riscv_trace_close(trace);
+  end
+`endif
+
+endmodule
@@ -5,6 +5,11 @@
 ///////////////////////////////////////////////////////////////////////////////
 //
 // Description: this is a simple serial divider for signed integers (int32).
+//              The radix-2 divider is checked against the reference results;
+//              the radix-4 divider (C_RADIX4) and the radix-4 divider with the
+//              ALU's dividend zero skipping (FAST_DIV) run the same stimuli,
+//              must produce identical results and their latency
+//              distributions are reported after every test.
 //
 ///////////////////////////////////////////////////////////////////////////////
 //
@@ -51,6 +56,20 @@ module tb;
   logic                   OutVld_SO;
   logic [C_WIDTH-1:0]     Res_DO;
 
+  // radix-4 and radix-4 with dividend zero skipping
+  logic                   InVldAux_SI;
+  logic                   OutVldR4_SO,  OutVldFast_SO;
+  logic [C_WIDTH-1:0]     ResR4_DO,     ResFast_DO;
+  logic [C_WIDTH-1:0]     OpBFast_DI;
+  logic [C_LOG_WIDTH-1:0] OpBShiftFast_DI;
+
+  // latency histograms, load cycle to result cycle
+  localparam C_NUM_IMPL = 3;
+  localparam C_MAX_LAT  = 40;
+  longint                 LatHist_T[C_NUM_IMPL][C_MAX_LAT+1];
+  int                     LatCur_T[C_NUM_IMPL];
+  logic [C_NUM_IMPL-1:0]  LatBusy_T;
+
 ///////////////////////////////////////////////////////////////////////////////
 // TB signal declarations
 ///////////////////////////////////////////////////////////////////////////////
@@ -127,6 +146,87 @@ module tb;
   assign OpBIsZero_SI = ~(|OpB_DI);
   riscv_alu_div #(.C_WIDTH(C_WIDTH), .C_LOG_WIDTH(C_LOG_WIDTH)) i_mut (.*);
 
+  // the other implementations start together with the radix-2 one and then
+  // hold their result until it is checked
+  assign InVldAux_SI = i_mut.LoadEn_S;
+
+  riscv_alu_div #(.C_WIDTH(C_WIDTH), .C_LOG_WIDTH(C_LOG_WIDTH), .C_RADIX4(1)) i_mut_r4 (
+    .Clk_CI, .Rst_RBI, .OpA_DI, .OpB_DI, .OpBShift_DI, .OpBIsZero_SI, .OpBSign_SI, .OpCode_SI,
+    .InVld_SI  ( InVldAux_SI ),
+    .OutRdy_SI,
+    .OutVld_SO ( OutVldR4_SO ),
+    .Res_DO    ( ResR4_DO    )
+  );
+
+  riscv_alu_div #(.C_WIDTH(C_WIDTH), .C_LOG_WIDTH(C_LOG_WIDTH), .C_RADIX4(1)) i_mut_fast (
+    .Clk_CI, .Rst_RBI, .OpA_DI, .OpBIsZero_SI, .OpBSign_SI, .OpCode_SI,
+    .OpB_DI      ( OpBFast_DI      ),
+    .OpBShift_DI ( OpBShiftFast_DI ),
+    .InVld_SI    ( InVldAux_SI     ),
+    .OutRdy_SI,
+    .OutVld_SO   ( OutVldFast_SO   ),
+    .Res_DO      ( ResFast_DO      )
+  );
+
+  // dividend zero skipping of riscv_alu (FAST_DIV), the stimuli come with the
+  // divisor already normalized, so undo the part of the shift it skips
+  riscv_alu_div_skip #(.C_WIDTH(C_WIDTH), .C_LOG_WIDTH(C_LOG_WIDTH)) i_skip (
+    .OpA_DI,
+    .OpASign_SI   ( OpCode_SI[0] & OpA_DI[$high(OpA_DI)] ),
+    .OpBSign_SI,
+    .OpBIsZero_SI,
+    .OpBShift_DI,
+    .OpBShift_DO  ( OpBShiftFast_DI )
+  );
+
+  assign OpBFast_DI = OpB_DI >> (OpBShift_DI - OpBShiftFast_DI);
+
+  always @(posedge Clk_CI)
+  begin : p_lat
+    logic [C_NUM_IMPL-1:0] load, vld;
+
+    load = {i_mut_fast.LoadEn_S, i_mut_r4.LoadEn_S, i_mut.LoadEn_S};
+    vld  = {OutVldFast_SO, OutVldR4_SO, OutVld_SO};
+
+    for (int i = 0; i < C_NUM_IMPL; i++) begin
+      if (load[i]) begin
+        LatBusy_T[i] <= 1'b1;
+        LatCur_T[i]  <= 1;
+      end else if (LatBusy_T[i] === 1'b1) begin
+        if (vld[i]) begin
+          LatHist_T[i][(LatCur_T[i] + 1 > C_MAX_LAT) ? C_MAX_LAT : LatCur_T[i] + 1]++;
+          LatBusy_T[i] <= 1'b0;
+        end else begin
+          LatCur_T[i]  <= LatCur_T[i] + 1;
+        end
+      end
+    end
+  end
+
+  task automatic printLatency();
+    string names[C_NUM_IMPL] = '{"radix-2", "radix-4", "radix-4 + zero skipping"};
+    for (int i = 0; i < C_NUM_IMPL; i++) begin
+      longint n = 0, sum = 0;
+      int     lo = C_MAX_LAT, hi = 0;
+      for (int l = 0; l <= C_MAX_LAT; l++) begin
+        if (LatHist_T[i][l] > 0) begin
+          n   += LatHist_T[i][l];
+          sum += LatHist_T[i][l] * l;
+          if (l < lo) lo = l;
+          if (l > hi) hi = l;
+        end
+      end
+      if (n == 0) continue;
+      $display("%-24s %0d divisions, latency min %0d / mean %0.2f / max %0d cycles",
+               names[i], n, lo, real'(sum) / real'(n), hi);
+      for (int l = lo; l <= hi; l++)
+        if (LatHist_T[i][l] > 0)
+          $display("    %2d cycles: %0d", l, LatHist_T[i][l]);
+      for (int l = 0; l <= C_MAX_LAT; l++)
+        LatHist_T[i][l] = 0;
+    end
+  endtask
+
 ///////////////////////////////////////////////////////////////////////////////
 // application process
 ///////////////////////////////////////////////////////////////////////////////
@@ -186,6 +286,11 @@ module tb;
 
     `include "tb_rem.sv"
 
+    ///////////////////////////////////////////////
+    // latency benchmark, small quotients
+
+    `include "tb_bench.sv"
+
     ///////////////////////////////////////////////
 
     applWaitCyc(Clk_CI,400);
@@ -211,6 +316,10 @@ module tb;
     longint acqCnt, errCnt, res, act;
 
     OutRdy_SI  = 0;
+    LatBusy_T  = '0;
+    for (int i = 0; i < C_NUM_IMPL; i++)
+      for (int l = 0; l <= C_MAX_LAT; l++)
+        LatHist_T[i][l] = 0;
     EndOfSim_T = 0;
 
     acqWait(Clk_CI,StimStart_T);
@@ -324,11 +433,25 @@ module tb;
             $display("vector %d> %d mod %d = %d == %d ",acqCnt,OpA_tmp,OpB_tmp,res,act);
           end
         end
+        // the faster implementations have to match bit by bit
+        if((ResR4_DO !== Res_DO) || (ResFast_DO !== Res_DO))
+        begin
+          $display("vector %d> radix-2 %h, radix-4 %h, skipping %h -> mismatch!",acqCnt,Res_DO,ResR4_DO,ResFast_DO);
+          errCnt++;
+          $stop();
+        end
+
         // status
         acqCnt++;
       end
       while (acqCnt < NumStim_T);
 
+      // wait for the last division of the test to be recorded
+      acqWaitCyc(Clk_CI,2);
+      $display("");
+      $display("latency, %s", TestName_T);
+      printLatency();
+
 
     end
     ///////////////////////////////////////////////
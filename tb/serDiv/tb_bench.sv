@@ -0,0 +1,65 @@
+///////////////////////////////////////////////
+// latency benchmark: the divisions of the
+// firmware, requantization (v / H_DIV with a
+// small quotient) and printf's divide by 10
+
+// init
+NumStim_T   = 2000;
+
+TestName_T  = "udiv benchmark (v / H_DIV, x / 10)";
+
+AcqTrig_T     <= 1;
+applWaitCyc(Clk_CI,2);
+AcqTrig_T     <= 0;
+applWaitCyc(Clk_CI,2);
+
+///////////////////////////////////////////////
+applWait(Clk_CI, OutVld_SO);
+
+OpBSign_SI  = 0;
+OpCode_SI   = 0;
+
+////////////////////
+// hidden neuron requantization, quotient 0..127
+
+for (k = 0; k < 1000; k++) begin
+
+    ok = randomize(OpB_T) with {OpB_T>=16; OpB_T<=512;};
+    ok = randomize(OpA_T) with {OpA_T>=0; OpA_T<=127*OpB_T;};
+
+    OpA_DI      = OpA_T;
+    OpBShift_DI = 32-$clog2(OpB_T+1);
+    OpB_DI      = OpB_T << OpBShift_DI;
+    InVld_SI    = 1;
+
+    applWaitCyc(Clk_CI,1);
+    applWait(Clk_CI, OutVld_SO);
+
+    InVld_SI    = 0;
+
+end
+
+////////////////////
+// decimal formatting, x / 10 over all magnitudes
+
+for (k = 0; k < 1000; k++) begin
+
+    ok = randomize(j) with {j>=1; j<=C_WIDTH;};
+    ok = randomize(OpA_T) with {OpA_T>=0; OpA_T<2**j;};
+    OpB_T       = 10;
+
+    OpA_DI      = OpA_T;
+    OpBShift_DI = 32-$clog2(OpB_T+1);
+    OpB_DI      = OpB_T << OpBShift_DI;
+    InVld_SI    = 1;
+
+    applWaitCyc(Clk_CI,1);
+    applWait(Clk_CI, OutVld_SO);
+
+    InVld_SI    = 0;
+
+end
+
+applWaitCyc(Clk_CI, 100);
+
+///////////////////////////////////////////////
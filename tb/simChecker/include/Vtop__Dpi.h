@@ -0,0 +1,21 @@
+// Stand-in for the DPI header Verilator generates from riscv_simchecker.sv,
+// the prototypes must match the imports there.
+
+#ifndef TB_VTOP_DPI_H
+#define TB_VTOP_DPI_H
+
+#include <cstdint>
+
+typedef struct { uint32_t aval; uint32_t bval; } svLogicVecVal;
+
+extern "C" {
+void *riscv_checker_init(int boot_addr, int core_id, int cluster_id);
+int   riscv_checker_step(void *cpu, long long simtime, int cycle, const svLogicVecVal *pc,
+                         const svLogicVecVal *instr);
+void  riscv_checker_irq(void *cpu, int irq, int irq_no);
+void  riscv_checker_mem_access(void *cpu, int we, const svLogicVecVal *addr, const svLogicVecVal *data);
+void  riscv_checker_reg_access(void *cpu, const svLogicVecVal *addr, const svLogicVecVal *data);
+void  riscv_checker_final(void *cpu);
+}
+
+#endif
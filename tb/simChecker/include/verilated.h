@@ -0,0 +1,29 @@
+// Stand-in for Verilator's verilated.h: the plusargs simchecker_dpi.cpp asks
+// for come from a string the testbench sets instead of the command line.
+
+#ifndef TB_VERILATED_H
+#define TB_VERILATED_H
+
+#include <cstring>
+
+struct Verilated {
+    static const char *args;
+
+    // "+name..." of the first plusarg starting with name, "" if none
+    static const char *commandArgsPlusMatch(const char *name) {
+        static char buf[64];
+        buf[0] = 0;
+        for (const char *s = args; (s = strchr(s, '+')) != nullptr; s++) {
+            if (strncmp(s + 1, name, strlen(name)) == 0) {
+                size_t n = strcspn(s, " ");
+                if (n >= sizeof(buf)) n = sizeof(buf) - 1;
+                memcpy(buf, s, n);
+                buf[n] = 0;
+                break;
+            }
+        }
+        return buf;
+    }
+};
+
+#endif
@@ -0,0 +1,3 @@
+#!/bin/bash
+
+g++ -std=c++14 -Wall -O2 -I../include ../tb.cpp -o ./tb || exit 1
@@ -0,0 +1,33 @@
+#!/bin/bash
+
+######################
+# helper function
+LIGHT_GREEN_COL="\033[1;32m"
+LIGHT_RED_COL="\033[1;31m"
+NO_COL="\033[0m"
+function check_exitcode() {
+
+    if [ $1 -ne 0 ] ; then
+        echo -en "$LIGHT_RED_COL$2 [ FAILED ]$NO_COL \n";
+        exit 1;
+    else
+        echo -en "$LIGHT_GREEN_COL$2 [ OK ]$NO_COL \n";
+    fi
+}
+######################
+
+
+######################
+#compile sourcefiles
+######################
+
+./compile.sh
+check_exitcode $? "compile sources"
+
+
+######################
+#run the checks
+######################
+
+./tb
+check_exitcode $? "simchecker checks"
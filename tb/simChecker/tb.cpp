@@ -0,0 +1,209 @@
+///////////////////////////////////////////////////////////////////////////////
+// File       : TB for the lockstep instruction checker
+///////////////////////////////////////////////////////////////////////////////
+//
+// Description: drives verilator-model/simchecker_dpi.cpp through its DPI
+//              entry points the way riscv_simchecker.sv does, one retired
+//              instruction at a time with the register writes and data
+//              accesses the RTL would report, and checks that correct
+//              instructions pass and wrong results or next pcs are flagged.
+//              Runs on the host, no simulator needed.
+//
+///////////////////////////////////////////////////////////////////////////////
+
+#include "verilated.h"
+#include "../../verilator-model/simchecker_dpi.cpp"
+
+#include <initializer_list>
+
+const char *Verilated::args = "";
+
+static void *cpu;
+static int   num_fail;
+
+static svLogicVecVal vec(uint32_t v) {
+    svLogicVecVal r = { v, 0 };
+    return r;
+}
+
+// one retired instruction, returns the checker's verdict (0 ok, 1 mismatch)
+static int step(uint32_t pc, uint32_t instr, std::initializer_list<RegWrite> regs,
+                std::initializer_list<MemAccess> accs = {}, bool irq = false) {
+    for (const MemAccess &m : accs) {
+        svLogicVecVal a = vec(m.addr), d = vec(m.data);
+        riscv_checker_mem_access(cpu, m.we, &a, &d);
+    }
+    for (const RegWrite &r : regs) {
+        svLogicVecVal a = vec(r.addr), d = vec(r.value);
+        riscv_checker_reg_access(cpu, &a, &d);
+    }
+    riscv_checker_irq(cpu, irq, 0);
+    svLogicVecVal p = vec(pc), i = vec(instr);
+    return riscv_checker_step(cpu, 0, 0, &p, &i);
+}
+
+#define EXPECT(res, call) do {                                           \
+    if ((call) != (res)) {                                               \
+        printf("tb.cpp:%d: expected %s: %s\n", __LINE__,                 \
+               (res) ? "mismatch" : "pass", #call);                      \
+        num_fail++;                                                      \
+    }                                                                    \
+} while (0)
+
+#define PASS(call) EXPECT(0, call)
+#define FAIL(call) EXPECT(1, call)
+
+// the value of rs set up by an unmodelled csr read, which is taken over
+static void set_reg(uint32_t pc, uint32_t rd, uint32_t value) {
+    PASS(step(pc, 0xb0002073 | (rd << 7), {{rd, value}}));
+}
+
+static void test_alu_and_control(void) {
+    Verilated::args = "+simcheck";
+    cpu = riscv_checker_init(0x80, 0, 0);
+
+    PASS(step(0x80, enc_i(0x13, 0, 1, 0, 5), {{1, 5}}));                  // addi x1, x0, 5
+    FAIL(step(0x84, enc_i(0x13, 0, 2, 1, 3), {{2, 9}}));                  // addi x2, x1, 3 is 8
+
+    // c.li x2, -3 expands to addi x2, x0, -3
+    uint32_t cli = (2 << 13) | (1 << 12) | (2 << 7) | (0x1d << 2) | 1;
+    if (expand_rvc(cli) != enc_i(0x13, 0, 2, 0, -3)) {
+        printf("tb.cpp:%d: c.li expanded to %08x\n", __LINE__, expand_rvc(cli));
+        num_fail++;
+    }
+    PASS(step(0x88, cli | (cli << 16), {{2, (uint32_t)-3}}));
+
+    // beq x1, x1, +16 is taken, falling through is a next pc mismatch
+    PASS(step(0x8a, enc_b(0, 1, 1, 16), {}));
+    PASS(step(0x9a, enc_i(0x13, 0, 0, 0, 0), {}));
+    PASS(step(0x9e, enc_b(0, 1, 1, 16), {}));
+    FAIL(step(0xa2, enc_i(0x13, 0, 0, 0, 0), {}));
+
+    // mulh x6, x5, x1 and div x6, x5, x0
+    PASS(step(0xa6, enc_r(0x33, 0, 0, 5, 0, 0), {{5, 0}}));
+    PASS(step(0xaa, enc_r(0x33, 1, 1, 6, 5, 1), {{6, 0}}));
+    PASS(step(0xae, enc_r(0x33, 4, 1, 6, 5, 0), {{6, 0xffffffff}}));
+
+    // an interrupt may go anywhere
+    PASS(step(0x1000, enc_i(0x13, 0, 0, 0, 0), {}, {}, true));
+
+    riscv_checker_final(cpu);
+}
+
+static void test_loads_stores(void) {
+    Verilated::args = "+simcheck";
+    cpu = riscv_checker_init(0x80, 0, 0);
+
+    PASS(step(0x80, enc_i(0x13, 0, 1, 0, 5), {{1, 5}}));
+
+    // lw x3, 2(x1) at 7 is misaligned, two accesses at 4 and 8
+    PASS(step(0x84, enc_i(0x03, 2, 3, 1, 2), {{3, 0x44332211}},
+              {{false, 7, 0x11ffffff}, {false, 8, 0xaa443322}}));
+    FAIL(step(0x88, enc_i(0x03, 2, 3, 1, 2), {{3, 0x44332212}},
+              {{false, 7, 0x11ffffff}, {false, 8, 0xaa443322}}));
+
+    // lbu and lb pick and extend their byte
+    PASS(step(0x8c, enc_i(0x03, 4, 4, 1, 1), {{4, 0x80}}, {{false, 6, 0x00800000}}));
+    PASS(step(0x90, enc_i(0x03, 0, 4, 1, 1), {{4, 0xffffff80}}, {{false, 6, 0x00800000}}));
+    FAIL(step(0x94, enc_i(0x03, 0, 4, 1, 1), {{4, 0x80}}, {{false, 6, 0x00800000}}));
+
+    // sh x1, 2(x1) at 7 stores x1 = 5 in two halves, the second one is wrong
+    PASS(step(0x98, enc_s(1, 1, 1, 2), {}, {{true, 7, 0x05000000}, {true, 8, 0x00000000}}));
+    FAIL(step(0x9c, enc_s(1, 1, 1, 2), {}, {{true, 7, 0x05000000}, {true, 8, 0x00000001}}));
+
+    // sw x1, 0(x1) to the wrong address
+    FAIL(step(0xa0, enc_s(2, 1, 1, 0), {}, {{true, 4, 5}}));
+
+    // p.lw x4, 4(x1!) post increments x1 to 9 from a misaligned address
+    PASS(step(0xa4, enc_i(0x0b, 2, 4, 1, 4), {{1, 9}, {4, 0x00332211}},
+              {{false, 5, 0x332211ff}, {false, 8, 0x0}}));
+    FAIL(step(0xa8, enc_i(0x0b, 2, 4, 1, 4), {{1, 9}, {4, 0x00332211}},
+              {{false, 9, 0x00332211}}));
+
+    riscv_checker_final(cpu);
+}
+
+static void test_hwloop(void) {
+    Verilated::args = "+simcheck";
+    cpu = riscv_checker_init(0x80, 0, 0);
+
+    // lp.setupi l0, 3 iterations, body of two instructions ending at 0x8c
+    PASS(step(0x80, (3u << 20) | (4u << 15) | (5 << 12) | (0 << 7) | 0x7b, {}));
+    for (uint32_t i = 0; i < 3; i++) {
+        PASS(step(0x84, enc_i(0x13, 0, 5, 5, 1), {{5, 2 * i + 1}}));
+        PASS(step(0x88, enc_i(0x13, 0, 5, 5, 1), {{5, 2 * i + 2}}));
+    }
+    PASS(step(0x8c, enc_i(0x13, 0, 5, 5, 1), {{5, 7}}));
+
+    // a second loop that the RTL leaves one iteration early
+    PASS(step(0x90, (2u << 20) | (4u << 15) | (5 << 12) | (0 << 7) | 0x7b, {}));
+    PASS(step(0x94, enc_i(0x13, 0, 5, 5, 1), {{5, 8}}));
+    PASS(step(0x98, enc_i(0x13, 0, 5, 5, 1), {{5, 9}}));
+    FAIL(step(0x9c, enc_i(0x13, 0, 5, 5, 1), {{5, 10}}));
+
+    riscv_checker_final(cpu);
+}
+
+static void test_dot_products(void) {
+    Verilated::args = "+simcheck";
+    cpu = riscv_checker_init(0x80, 0, 0);
+
+    set_reg(0x80, 1, 0x01ff0203);
+    set_reg(0x84, 2, 0x02020202);
+    set_reg(0x88, 3, 10);
+
+    // funct7 = {funct5, pair or sci bit}, funct3 selects the lane width
+    PASS(step(0x8c, enc_r(0x57, 1, 0x13 << 2, 3, 1, 2), {{3, 10}}));      // pv.dotsp.b 6+4-2+2
+    PASS(step(0x90, enc_r(0x57, 1, 0x10 << 2, 3, 1, 2), {{3, 522}}));     // pv.dotup.b 6+4+510+2
+    PASS(step(0x94, enc_r(0x57, 1, 0x17 << 2, 3, 1, 2), {{3, 532}}));     // pv.sdotsp.b x3 += 10
+    FAIL(step(0x98, enc_r(0x57, 1, 0x17 << 2, 3, 1, 2), {{3, 543}}));
+
+    // pv.sdot8sp x4, x1, x2 adds dot(x1, x2) and dot(x2, x3), x3 = 0x21f
+    PASS(step(0x9c, enc_r(0x57, 1, (0x17 << 2) | 2, 4, 1, 2), {{4, 10 + 2 * 0x1f + 2 * 2}}));
+    // pv.sdot8usp x4 += dot(x1, x2) + dot(x2, x3) with unsigned rs1 lanes
+    PASS(step(0xa0, enc_r(0x57, 1, (0x15 << 2) | 2, 4, 1, 2), {{4, 76 + 522 + 66}}));
+
+    // pv.dotsp.n: nibbles 3,0,2,0,-1,-1,1,0 times 2,0 repeated
+    PASS(step(0xa4, enc_r(0x57, 2, 0x13 << 2, 5, 1, 2), {{5, 10}}));
+    // pv.dotsp.c: crumbs -1,0,0,0 -2,0,0,0 -1,-1,-1,-1 1,0,0,0 times -2,0,0,0
+    PASS(step(0xa8, enc_r(0x57, 3, 0x13 << 2, 5, 1, 2), {{5, 6}}));
+    // pv.sdotusp.n, unsigned nibbles of x1: 15,15 instead of -1,-1
+    PASS(step(0xac, enc_r(0x57, 2, 0x15 << 2, 5, 1, 2), {{5, 6 + 6 + 4 + 30 + 2}}));
+    // pv.dotsp.sci.h x6, x1, -1: -(0x0203 + 0x01ff)
+    PASS(step(0xb0, enc_r(0x57, 6, (0x13 << 2) | 1, 6, 1, 31), {{6, (uint32_t)-1026}}));
+
+    // pv.add.h is not modelled, its write is taken over but the next pc checked
+    PASS(step(0xb4, enc_r(0x57, 0, 0, 7, 1, 2), {{7, 0}}));
+    FAIL(step(0xbc, enc_r(0x57, 0, 0, 7, 1, 2), {{7, 0}}));
+
+    riscv_checker_final(cpu);
+}
+
+static void test_sampling(void) {
+    // every second instruction between the region markers
+    Verilated::args = "+simcheck=2 +simregion";
+    cpu = riscv_checker_init(0x80, 1, 0);
+
+    PASS(step(0x80, enc_i(0x13, 0, 1, 0, 5), {{1, 7}}));                  // outside the region
+    PASS(step(0x84, 0x00102013, {}));                                     // SIMCHECK_BEGIN
+    FAIL(step(0x88, enc_i(0x13, 0, 2, 1, 1), {{2, 99}}));
+    PASS(step(0x8c, enc_i(0x13, 0, 2, 1, 1), {{2, 99}}));                 // skipped
+    PASS(step(0x90, 0x00002013, {}));                                     // SIMCHECK_END
+    PASS(step(0x94, enc_i(0x13, 0, 2, 1, 1), {{2, 99}}));
+
+    riscv_checker_final(cpu);
+}
+
+int main() {
+    test_alu_and_control();
+    test_loads_stores();
+    test_hwloop();
+    test_dot_products();
+    test_sampling();
+
+    if (num_fail)
+        printf("simChecker tb: %d checks FAILED\n", num_fail);
+    else
+        printf("simChecker tb: all checks passed\n");
+    return num_fail ? 1 : 0;
+}
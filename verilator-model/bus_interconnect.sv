@@ -0,0 +1,168 @@
+// =============================================================
+// Data Bus Interconnect - N masters to M slaves
+// =============================================================
+// Request/grant/rvalid protocol of the RI5CY data port on both sides. A
+// request is held until granted, the response comes back with rvalid some
+// cycles later (at least one). Each slave answers its requests in order.
+//
+// Every slave has its own arbiter, so masters talking to different slaves
+// proceed in the same cycle. ARB_MODE 0 is round-robin, 1 is fixed priority
+// with master 0 highest. Slave s is selected by SLAVE_BASE[s] <= addr <
+// SLAVE_END[s]; addresses that hit no range go to DEFAULT_SLAVE.
+//
+// A per-slave FIFO of granted master ids routes the responses back and
+// bounds outstanding requests to MAX_OUTSTANDING. Counters:
+//   stall_cnt_o[m]  cycles master m requested without a grant
+//   txn_cnt_o[s]    requests granted by slave s
+//   lat_cnt_o[s]    sum over cycles of requests outstanding at slave s,
+//                   i.e. the total grant-to-rvalid latency
+module bus_interconnect #(
+    parameter int N_MASTERS       = 2,
+    parameter int N_SLAVES        = 2,
+    parameter int ARB_MODE        = 0,
+    parameter int DEFAULT_SLAVE   = 0,
+    parameter int MAX_OUTSTANDING = 4,
+    parameter logic [N_SLAVES-1:0][31:0] SLAVE_BASE = '0,
+    parameter logic [N_SLAVES-1:0][31:0] SLAVE_END  = '0
+)(
+    input  logic                                clk,
+    input  logic                                rst_n,
+
+    // Masters
+    input  logic [N_MASTERS-1:0]                m_req,
+    input  logic [N_MASTERS-1:0][31:0]          m_addr,
+    input  logic [N_MASTERS-1:0]                m_we,
+    input  logic [N_MASTERS-1:0][3:0]           m_be,
+    input  logic [N_MASTERS-1:0][31:0]          m_wdata,
+    output logic [N_MASTERS-1:0]                m_gnt,
+    output logic [N_MASTERS-1:0]                m_rvalid,
+    output logic [N_MASTERS-1:0][31:0]          m_rdata,
+
+    // Slaves
+    output logic [N_SLAVES-1:0]                 s_req,
+    output logic [N_SLAVES-1:0][31:0]           s_addr,
+    output logic [N_SLAVES-1:0]                 s_we,
+    output logic [N_SLAVES-1:0][3:0]            s_be,
+    output logic [N_SLAVES-1:0][31:0]           s_wdata,
+    input  logic [N_SLAVES-1:0]                 s_gnt,
+    input  logic [N_SLAVES-1:0]                 s_rvalid,
+    input  logic [N_SLAVES-1:0][31:0]           s_rdata,
+
+    // Statistics
+    input  logic                                clear_counters_i,
+    output logic [N_MASTERS-1:0]                stall_o,
+    output logic [N_MASTERS-1:0][31:0]          stall_cnt_o,
+    output logic [N_SLAVES-1:0][31:0]           txn_cnt_o,
+    output logic [N_SLAVES-1:0][31:0]           lat_cnt_o
+);
+    localparam int MID_W = (N_MASTERS > 1) ? $clog2(N_MASTERS) : 1;
+    localparam int SID_W = (N_SLAVES  > 1) ? $clog2(N_SLAVES)  : 1;
+    localparam int CNT_W = $clog2(MAX_OUTSTANDING + 1);
+
+    // Address decode
+    logic [N_MASTERS-1:0][SID_W-1:0] m_slave;
+
+    always_comb begin
+        for (int m = 0; m < N_MASTERS; m++) begin
+            m_slave[m] = SID_W'(DEFAULT_SLAVE);
+            for (int s = 0; s < N_SLAVES; s++) begin
+                if (s != DEFAULT_SLAVE && m_addr[m] >= SLAVE_BASE[s] && m_addr[m] < SLAVE_END[s])
+                    m_slave[m] = SID_W'(s);
+            end
+        end
+    end
+
+    // Per-slave arbitration
+    logic [N_SLAVES-1:0][MID_W-1:0] winner;
+    logic [N_SLAVES-1:0][MID_W-1:0] rr_last;
+    logic [N_SLAVES-1:0]            s_any;
+
+    // Per-slave response FIFO of master ids
+    logic [MID_W-1:0] rsp_fifo [N_SLAVES][MAX_OUTSTANDING];
+    logic [N_SLAVES-1:0][CNT_W-1:0] rsp_count;
+    logic [N_SLAVES-1:0]            rsp_full;
+
+    always_comb begin
+        for (int s = 0; s < N_SLAVES; s++) begin
+            winner[s] = '0;
+            s_any[s]  = 1'b0;
+            for (int k = 0; k < N_MASTERS; k++) begin
+                automatic int m = (ARB_MODE == 0) ? (int'(rr_last[s]) + 1 + k) % N_MASTERS : k;
+                if (!s_any[s] && m_req[m] && m_slave[m] == SID_W'(s)) begin
+                    winner[s] = MID_W'(m);
+                    s_any[s]  = 1'b1;
+                end
+            end
+            rsp_full[s] = (rsp_count[s] == CNT_W'(MAX_OUTSTANDING));
+
+            s_req[s]   = s_any[s] && !rsp_full[s];
+            s_addr[s]  = m_addr[winner[s]];
+            s_we[s]    = m_we[winner[s]];
+            s_be[s]    = m_be[winner[s]];
+            s_wdata[s] = m_wdata[winner[s]];
+        end
+    end
+
+    // Grant and response routing back to the masters
+    always_comb begin
+        m_gnt    = '0;
+        m_rvalid = '0;
+        m_rdata  = '0;
+        for (int s = 0; s < N_SLAVES; s++) begin
+            if (s_req[s] && s_gnt[s])
+                m_gnt[winner[s]] = 1'b1;
+            if (s_rvalid[s] && rsp_count[s] != '0) begin
+                m_rvalid[rsp_fifo[s][0]] = 1'b1;
+                m_rdata[rsp_fifo[s][0]]  = s_rdata[s];
+            end
+        end
+    end
+
+    assign stall_o = m_req & ~m_gnt;
+
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            rr_last   <= '0;
+            rsp_count <= '0;
+            for (int s = 0; s < N_SLAVES; s++)
+                for (int i = 0; i < MAX_OUTSTANDING; i++)
+                    rsp_fifo[s][i] <= '0;
+        end else begin
+            for (int s = 0; s < N_SLAVES; s++) begin
+                automatic logic push = s_req[s] && s_gnt[s];
+                automatic logic pop  = s_rvalid[s] && rsp_count[s] != '0;
+
+                if (push) rr_last[s] <= winner[s];
+
+                if (pop) begin
+                    for (int i = 0; i < MAX_OUTSTANDING - 1; i++)
+                        rsp_fifo[s][i] <= rsp_fifo[s][i+1];
+                end
+                if (push)
+                    rsp_fifo[s][pop ? int'(rsp_count[s]) - 1 : int'(rsp_count[s])] <= winner[s];
+
+                rsp_count[s] <= rsp_count[s] + CNT_W'(push) - CNT_W'(pop);
+            end
+        end
+    end
+
+    // Statistics
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            stall_cnt_o <= '0;
+            txn_cnt_o   <= '0;
+            lat_cnt_o   <= '0;
+        end else if (clear_counters_i) begin
+            stall_cnt_o <= '0;
+            txn_cnt_o   <= '0;
+            lat_cnt_o   <= '0;
+        end else begin
+            for (int m = 0; m < N_MASTERS; m++)
+                if (stall_o[m]) stall_cnt_o[m] <= stall_cnt_o[m] + 32'h1;
+            for (int s = 0; s < N_SLAVES; s++) begin
+                if (s_req[s] && s_gnt[s]) txn_cnt_o[s] <= txn_cnt_o[s] + 32'h1;
+                lat_cnt_o[s] <= lat_cnt_o[s] + 32'(rsp_count[s]);
+            end
+        end
+    end
+endmodule
@@ -0,0 +1,265 @@
+// =============================================================
+// DMA Engine - 1-D/2-D strided copies with chained descriptors
+// =============================================================
+// Register map (byte offsets). A descriptor in memory uses the same layout
+// for its first eight words, so a chain can be built with plain stores.
+//   0x00 SRC         source address of the first element
+//   0x04 DST         destination address of the first element
+//   0x08 COUNT       elements per row
+//   0x0C ROWS        rows (0 or 1 = 1-D copy)
+//   0x10 SRC_STRIDE  bytes between the starts of consecutive source rows
+//   0x14 DST_STRIDE  bytes between the starts of consecutive dest rows
+//   0x18 CTRL        [0] src increment, [1] dst increment, [2] byte elements,
+//                    [3] completion interrupt enable
+//   0x1C NEXT        next descriptor address, 0 ends the chain
+//   0x20 STATUS      [0] busy, [1] done (sticky, write 1 to clear)
+//   0x24 START       [0] start with the registers above,
+//                    [1] start by loading the descriptor at NEXT
+//
+// Word elements are copied with aligned 32-bit accesses. Byte elements are
+// read from their lane of the aligned word and written with a single byte
+// enable, so a fixed-destination byte copy can feed the UART.
+module dma_engine (
+    input  logic        clk,
+    input  logic        rst_n,
+
+    // Configuration slave
+    input  logic        req,
+    input  logic        we,
+    input  logic [5:0]  addr,
+    input  logic [31:0] wdata,
+    output logic [31:0] rdata,
+    output logic        rvalid,
+
+    // Bus master
+    output logic        m_req,
+    output logic        m_we,
+    output logic [31:0] m_addr,
+    output logic [3:0]  m_be,
+    output logic [31:0] m_wdata,
+    input  logic        m_gnt,
+    input  logic        m_rvalid,
+    input  logic [31:0] m_rdata,
+
+    output logic        irq_o
+);
+    localparam REG_SRC        = 6'h00;
+    localparam REG_DST        = 6'h04;
+    localparam REG_COUNT      = 6'h08;
+    localparam REG_ROWS       = 6'h0C;
+    localparam REG_SRC_STRIDE = 6'h10;
+    localparam REG_DST_STRIDE = 6'h14;
+    localparam REG_CTRL       = 6'h18;
+    localparam REG_NEXT       = 6'h1C;
+    localparam REG_STATUS     = 6'h20;
+    localparam REG_START      = 6'h24;
+
+    localparam CTRL_SRC_INC = 0;
+    localparam CTRL_DST_INC = 1;
+    localparam CTRL_BYTE    = 2;
+    localparam CTRL_IRQ_EN  = 3;
+
+    typedef enum logic [2:0] { IDLE, DESC, DESC_WAIT, READ, READ_WAIT, WRITE, WRITE_WAIT } dma_state_t;
+    dma_state_t state;
+
+    // Descriptor registers
+    logic [31:0] src, dst, count, rows, src_stride, dst_stride, next;
+    logic [3:0]  ctrl;
+    logic        done;
+
+    // Transfer progress
+    logic [31:0] src_row, dst_row;     // start address of the current row
+    logic [31:0] src_cur, dst_cur;
+    logic [31:0] elem_left, rows_left;
+    logic [31:0] data_q;
+    logic [2:0]  desc_idx;
+
+    logic [31:0] esize;
+    assign esize = ctrl[CTRL_BYTE] ? 32'd1 : 32'd4;
+
+    // Bus master outputs
+    always_comb begin
+        m_req   = 1'b0;
+        m_we    = 1'b0;
+        m_addr  = 32'h0;
+        m_be    = 4'b1111;
+        m_wdata = data_q;
+        case (state)
+            DESC: begin
+                m_req  = 1'b1;
+                m_addr = next + {27'b0, desc_idx, 2'b00};
+            end
+            READ: begin
+                m_req  = 1'b1;
+                m_addr = {src_cur[31:2], 2'b00};
+            end
+            WRITE: begin
+                m_req  = 1'b1;
+                m_we   = 1'b1;
+                m_addr = {dst_cur[31:2], 2'b00};
+                if (ctrl[CTRL_BYTE]) begin
+                    m_be    = 4'b0001 << dst_cur[1:0];
+                    m_wdata = {4{data_q[7:0]}};
+                end
+            end
+            default: ;
+        endcase
+    end
+
+    assign irq_o = done && ctrl[CTRL_IRQ_EN];
+
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            state      <= IDLE;
+            src        <= 32'h0;
+            dst        <= 32'h0;
+            count      <= 32'h0;
+            rows       <= 32'h0;
+            src_stride <= 32'h0;
+            dst_stride <= 32'h0;
+            ctrl       <= 4'h0;
+            next       <= 32'h0;
+            done       <= 1'b0;
+            src_row    <= 32'h0;
+            dst_row    <= 32'h0;
+            src_cur    <= 32'h0;
+            dst_cur    <= 32'h0;
+            elem_left  <= 32'h0;
+            rows_left  <= 32'h0;
+            data_q     <= 32'h0;
+            desc_idx   <= 3'd0;
+        end else begin
+            // Configuration writes, descriptor registers only while idle
+            if (req && we) begin
+                if (state == IDLE) begin
+                    case (addr)
+                        REG_SRC:        src        <= wdata;
+                        REG_DST:        dst        <= wdata;
+                        REG_COUNT:      count      <= wdata;
+                        REG_ROWS:       rows       <= wdata;
+                        REG_SRC_STRIDE: src_stride <= wdata;
+                        REG_DST_STRIDE: dst_stride <= wdata;
+                        REG_CTRL:       ctrl       <= wdata[3:0];
+                        REG_NEXT:       next       <= wdata;
+                        default: ;
+                    endcase
+                end
+                if (addr == REG_STATUS && wdata[1]) done <= 1'b0;
+            end
+
+            case (state)
+                IDLE: begin
+                    if (req && we && addr == REG_START) begin
+                        done <= 1'b0;
+                        if (wdata[1] && next != 32'h0) begin
+                            desc_idx <= 3'd0;
+                            state    <= DESC;
+                        end else if (wdata[0]) begin
+                            src_row   <= src;
+                            dst_row   <= dst;
+                            src_cur   <= src;
+                            dst_cur   <= dst;
+                            elem_left <= count;
+                            rows_left <= (rows == 32'h0) ? 32'h1 : rows;
+                            state     <= (count == 32'h0) ? IDLE : READ;
+                            if (count == 32'h0) done <= 1'b1;
+                        end
+                    end
+                end
+
+                DESC: if (m_gnt) state <= DESC_WAIT;
+
+                DESC_WAIT: begin
+                    if (m_rvalid) begin
+                        case (desc_idx)
+                            3'd0: src        <= m_rdata;
+                            3'd1: dst        <= m_rdata;
+                            3'd2: count      <= m_rdata;
+                            3'd3: rows       <= m_rdata;
+                            3'd4: src_stride <= m_rdata;
+                            3'd5: dst_stride <= m_rdata;
+                            3'd6: ctrl       <= m_rdata[3:0];
+                            3'd7: next       <= m_rdata;
+                        endcase
+                        desc_idx <= desc_idx + 3'd1;
+                        if (desc_idx == 3'd7) begin
+                            // src/dst are complete, start the copy from them
+                            src_row   <= src;
+                            dst_row   <= dst;
+                            src_cur   <= src;
+                            dst_cur   <= dst;
+                            elem_left <= count;
+                            rows_left <= (rows == 32'h0) ? 32'h1 : rows;
+                            state     <= (count == 32'h0) ? (m_rdata == 32'h0 ? IDLE : DESC) : READ;
+                            if (count == 32'h0 && m_rdata == 32'h0) done <= 1'b1;
+                        end else begin
+                            state <= DESC;
+                        end
+                    end
+                end
+
+                READ: if (m_gnt) state <= READ_WAIT;
+
+                READ_WAIT: begin
+                    if (m_rvalid) begin
+                        data_q <= ctrl[CTRL_BYTE] ? (m_rdata >> {src_cur[1:0], 3'b000}) : m_rdata;
+                        state  <= WRITE;
+                    end
+                end
+
+                WRITE: if (m_gnt) state <= WRITE_WAIT;
+
+                WRITE_WAIT: begin
+                    if (m_rvalid) begin
+                        if (elem_left != 32'h1) begin
+                            elem_left <= elem_left - 32'h1;
+                            if (ctrl[CTRL_SRC_INC]) src_cur <= src_cur + esize;
+                            if (ctrl[CTRL_DST_INC]) dst_cur <= dst_cur + esize;
+                            state <= READ;
+                        end else if (rows_left != 32'h1) begin
+                            rows_left <= rows_left - 32'h1;
+                            elem_left <= count;
+                            src_row   <= src_row + src_stride;
+                            dst_row   <= dst_row + dst_stride;
+                            src_cur   <= src_row + src_stride;
+                            dst_cur   <= dst_row + dst_stride;
+                            state     <= READ;
+                        end else if (next != 32'h0) begin
+                            desc_idx <= 3'd0;
+                            state    <= DESC;
+                        end else begin
+                            done  <= 1'b1;
+                            state <= IDLE;
+                        end
+                    end
+                end
+
+                default: state <= IDLE;
+            endcase
+        end
+    end
+
+    // Register read back
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            rvalid <= 1'b0;
+            rdata  <= 32'h0;
+        end else begin
+            rvalid <= req;
+            if (req && !we) begin
+                case (addr)
+                    REG_SRC:        rdata <= src;
+                    REG_DST:        rdata <= dst;
+                    REG_COUNT:      rdata <= count;
+                    REG_ROWS:       rdata <= rows;
+                    REG_SRC_STRIDE: rdata <= src_stride;
+                    REG_DST_STRIDE: rdata <= dst_stride;
+                    REG_CTRL:       rdata <= {28'b0, ctrl};
+                    REG_NEXT:       rdata <= next;
+                    REG_STATUS:     rdata <= {30'b0, done, state != IDLE};
+                    default:        rdata <= 32'h0;
+                endcase
+            end
+        end
+    end
+endmodule
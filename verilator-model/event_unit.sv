@@ -0,0 +1,189 @@
+// =============================================================
+// Event Unit - hardware barrier, inter-core events and interrupts
+// =============================================================
+// Every core has a private port, so a core blocked here never holds up the
+// shared interconnect. Blocking registers keep the load's rvalid back, the
+// core simply stalls in the LSU until it is released.
+//
+// Interrupt sources (src_i, bit n = core irq line n) set sticky bits in
+// PENDING, level sources keep setting them until cleared at the source.
+// Each core has an IRQ_MASK of sources delivered as interrupts and an
+// EVT_MASK of sources that only wake it up. With SLEEP_CTRL[0] set, the
+// core's fetch enable and clock enable drop while none of its unmasked
+// sources is pending, so a WFI puts it into the controller's SLEEP state
+// until one arrives.
+//
+// Register map (byte offsets, same for every core):
+//   0x00 CORE_ID     id of the requesting core
+//   0x04 NUM_CORES   number of cores in the cluster
+//   0x08 BARRIER     read: arrive at the barrier, returns once all cores
+//                    have arrived; the data is the number of completed barriers
+//   0x0C EVT_SEND    write: raise an event on every core set in the mask
+//   0x10 EVT_WAIT    read: return once an event is pending for this core and
+//                    consume it; the data is the mask of cores that raised it
+//   0x14 EVT_MASK    sources that wake this core (per core)
+//   0x18 IRQ_MASK    sources delivered to this core as interrupts (per core)
+//   0x1C PENDING     pending sources, write 1 to clear
+//   0x20 PENDING_SET write 1 to raise a source from software
+//   0x24 SLEEP_CTRL  [0] WFI sleeps until an unmasked source is pending (per core)
+module event_unit #(
+    parameter int N_CORES = 1
+)(
+    input  logic                            clk,
+    input  logic                            rst_n,
+
+    input  logic [31:0]                     src_i,
+    output logic [N_CORES-1:0][31:0]        irq_o,
+    output logic [N_CORES-1:0]              wake_o,    // fetch/clock enable
+
+    input  logic [N_CORES-1:0]              req,
+    input  logic [N_CORES-1:0]              we,
+    input  logic [N_CORES-1:0][5:0]         addr,
+    input  logic [N_CORES-1:0][31:0]        wdata,
+    output logic [N_CORES-1:0]              gnt,
+    output logic [N_CORES-1:0]              rvalid,
+    output logic [N_CORES-1:0][31:0]        rdata
+);
+    localparam REG_CORE_ID   = 6'h00;
+    localparam REG_NUM_CORES = 6'h04;
+    localparam REG_BARRIER   = 6'h08;
+    localparam REG_EVT_SEND  = 6'h0C;
+    localparam REG_EVT_WAIT  = 6'h10;
+    localparam REG_EVT_MASK  = 6'h14;
+    localparam REG_IRQ_MASK  = 6'h18;
+    localparam REG_PENDING   = 6'h1C;
+    localparam REG_PEND_SET  = 6'h20;
+    localparam REG_SLEEP     = 6'h24;
+
+    logic [N_CORES-1:0]              bar_wait, evt_wait, evt_pending;
+    logic [N_CORES-1:0][N_CORES-1:0] evt_src;
+    logic [31:0]                     bar_count;
+    logic [N_CORES-1:0][31:0]        evt_mask, irq_mask;
+    logic [N_CORES-1:0]              sleep_en;
+    logic [31:0]                     pending;
+
+    assign gnt = req;
+
+    always_comb begin
+        for (int c = 0; c < N_CORES; c++) begin
+            irq_o[c]  = pending & irq_mask[c];
+            wake_o[c] = !sleep_en[c] || ((pending & (evt_mask[c] | irq_mask[c])) != 32'h0);
+        end
+    end
+
+    // Pending sources
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            pending <= 32'h0;
+        end else begin
+            automatic logic [31:0] clr = 32'h0;
+            automatic logic [31:0] set = src_i;
+            for (int c = 0; c < N_CORES; c++) begin
+                if (req[c] && we[c] && addr[c] == REG_PENDING)  clr |= wdata[c];
+                if (req[c] && we[c] && addr[c] == REG_PEND_SET) set |= wdata[c];
+            end
+            pending <= (pending & ~clr) | set;
+        end
+    end
+
+    // Per-core configuration
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            evt_mask <= '0;
+            irq_mask <= '0;
+            sleep_en <= '0;
+        end else begin
+            for (int c = 0; c < N_CORES; c++) begin
+                if (req[c] && we[c]) begin
+                    case (addr[c])
+                        REG_EVT_MASK: evt_mask[c] <= wdata[c];
+                        REG_IRQ_MASK: irq_mask[c] <= wdata[c];
+                        REG_SLEEP:    sleep_en[c] <= wdata[c][0];
+                        default: ;
+                    endcase
+                end
+            end
+        end
+    end
+
+    // Arrivals and events of this cycle
+    logic [N_CORES-1:0]              bar_arrive, evt_arrive, evt_set;
+    logic [N_CORES-1:0][N_CORES-1:0] evt_set_src;
+
+    always_comb begin
+        evt_set     = '0;
+        evt_set_src = '0;
+        for (int c = 0; c < N_CORES; c++) begin
+            bar_arrive[c] = req[c] && !we[c] && addr[c] == REG_BARRIER;
+            evt_arrive[c] = req[c] && !we[c] && addr[c] == REG_EVT_WAIT;
+            if (req[c] && we[c] && addr[c] == REG_EVT_SEND) begin
+                for (int t = 0; t < N_CORES; t++) begin
+                    if (wdata[c][t]) begin
+                        evt_set[t]        = 1'b1;
+                        evt_set_src[t][c] = 1'b1;
+                    end
+                end
+            end
+        end
+    end
+
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            bar_wait    <= '0;
+            evt_wait    <= '0;
+            evt_pending <= '0;
+            evt_src     <= '0;
+            bar_count   <= 32'h0;
+            rvalid      <= '0;
+            rdata       <= '0;
+        end else begin
+            automatic logic [N_CORES-1:0] bar_all = bar_wait | bar_arrive;
+            automatic logic [N_CORES-1:0] evt_all = evt_wait | evt_arrive;
+
+            rvalid <= '0;
+
+            // Plain registers answer in the next cycle
+            for (int c = 0; c < N_CORES; c++) begin
+                if (req[c] && !bar_arrive[c] && !evt_arrive[c]) begin
+                    rvalid[c] <= 1'b1;
+                    case (addr[c])
+                        REG_CORE_ID:   rdata[c] <= 32'(c);
+                        REG_NUM_CORES: rdata[c] <= 32'(N_CORES);
+                        REG_EVT_MASK:  rdata[c] <= evt_mask[c];
+                        REG_IRQ_MASK:  rdata[c] <= irq_mask[c];
+                        REG_PENDING:   rdata[c] <= pending;
+                        REG_SLEEP:     rdata[c] <= {31'b0, sleep_en[c]};
+                        default:       rdata[c] <= 32'h0;
+                    endcase
+                end
+            end
+
+            // Barrier, released when the last core arrives
+            if (&bar_all) begin
+                for (int c = 0; c < N_CORES; c++) begin
+                    rvalid[c] <= 1'b1;
+                    rdata[c]  <= bar_count + 32'h1;
+                end
+                bar_wait  <= '0;
+                bar_count <= bar_count + 32'h1;
+            end else begin
+                bar_wait <= bar_all;
+            end
+
+            // Events
+            for (int c = 0; c < N_CORES; c++) begin
+                if (evt_all[c] && (evt_pending[c] || evt_set[c])) begin
+                    rvalid[c]      <= 1'b1;
+                    rdata[c]       <= 32'(evt_src[c] | evt_set_src[c]);
+                    evt_wait[c]    <= 1'b0;
+                    evt_pending[c] <= 1'b0;
+                    evt_src[c]     <= '0;
+                end else begin
+                    evt_wait[c]    <= evt_all[c];
+                    evt_pending[c] <= evt_pending[c] | evt_set[c];
+                    evt_src[c]     <= evt_src[c] | evt_set_src[c];
+                end
+            end
+        end
+    end
+endmodule
@@ -0,0 +1,79 @@
+// =============================================================
+// Fetch Arbiter - N instruction ports onto one 128-bit memory port
+// =============================================================
+// Round-robin arbitration of the cores' (or their I-caches') fetch
+// requests. Responses come back in order, a FIFO of granted port ids routes
+// each rvalid to its requester and bounds outstanding fetches to
+// MAX_OUTSTANDING.
+module fetch_arbiter #(
+    parameter int N_PORTS         = 2,
+    parameter int ADDR_WIDTH      = 22,
+    parameter int MAX_OUTSTANDING = 4
+)(
+    input  logic                                 clk,
+    input  logic                                 rst_n,
+
+    input  logic [N_PORTS-1:0]                   req_i,
+    input  logic [N_PORTS-1:0][ADDR_WIDTH-1:0]   addr_i,
+    output logic [N_PORTS-1:0]                   gnt_o,
+    output logic [N_PORTS-1:0]                   rvalid_o,
+    output logic [127:0]                         rdata_o,   // shared, qualified by rvalid_o
+
+    output logic                                 mem_req_o,
+    output logic [ADDR_WIDTH-1:0]                mem_addr_o,
+    input  logic                                 mem_gnt_i,
+    input  logic                                 mem_rvalid_i,
+    input  logic [127:0]                         mem_rdata_i
+);
+    localparam int PID_W = (N_PORTS > 1) ? $clog2(N_PORTS) : 1;
+    localparam int CNT_W = $clog2(MAX_OUTSTANDING + 1);
+
+    logic [PID_W-1:0] winner, rr_last;
+    logic             any;
+    logic [PID_W-1:0] rsp_fifo [MAX_OUTSTANDING];
+    logic [CNT_W-1:0] rsp_count;
+
+    always_comb begin
+        winner = '0;
+        any    = 1'b0;
+        for (int k = 0; k < N_PORTS; k++) begin
+            automatic int p = (int'(rr_last) + 1 + k) % N_PORTS;
+            if (!any && req_i[p]) begin
+                winner = PID_W'(p);
+                any    = 1'b1;
+            end
+        end
+    end
+
+    assign mem_req_o  = any && (rsp_count != CNT_W'(MAX_OUTSTANDING));
+    assign mem_addr_o = addr_i[winner];
+    assign rdata_o    = mem_rdata_i;
+
+    always_comb begin
+        gnt_o    = '0;
+        rvalid_o = '0;
+        if (mem_req_o && mem_gnt_i)            gnt_o[winner]       = 1'b1;
+        if (mem_rvalid_i && rsp_count != '0)   rvalid_o[rsp_fifo[0]] = 1'b1;
+    end
+
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            rr_last   <= '0;
+            rsp_count <= '0;
+            for (int i = 0; i < MAX_OUTSTANDING; i++)
+                rsp_fifo[i] <= '0;
+        end else begin
+            automatic logic push = mem_req_o && mem_gnt_i;
+            automatic logic pop  = mem_rvalid_i && rsp_count != '0;
+
+            if (push) rr_last <= winner;
+            if (pop) begin
+                for (int i = 0; i < MAX_OUTSTANDING - 1; i++)
+                    rsp_fifo[i] <= rsp_fifo[i+1];
+            end
+            if (push)
+                rsp_fifo[pop ? int'(rsp_count) - 1 : int'(rsp_count)] <= winner;
+            rsp_count <= rsp_count + CNT_W'(push) - CNT_W'(pop);
+        end
+    end
+endmodule
@@ -0,0 +1,176 @@
+// =============================================================
+// Instruction Cache - set-associative, read-only, 128-bit fetch port
+// =============================================================
+// Sits between the core's instruction port and the RAM instruction port,
+// both use the req/gnt/rvalid protocol with 16-byte aligned fetches. A hit
+// is granted right away and answers the next cycle. A miss holds the
+// request back, refills the line with LINE_BYTES/16 fetches from memory
+// (pipelined as far as the memory grants them) after REFILL_LATENCY extra
+// cycles, then serves the request as a hit. Victims are chosen round-robin
+// per set.
+//
+//   hit_cnt_o     fetches served without a refill
+//   miss_cnt_o    line refills
+//   refill_cnt_o  cycles spent refilling
+module icache #(
+    parameter int ADDR_WIDTH     = 22,
+    parameter int SIZE_BYTES     = 4096,
+    parameter int WAYS           = 2,
+    parameter int LINE_BYTES     = 32,
+    parameter int REFILL_LATENCY = 0
+)(
+    input  logic                  clk,
+    input  logic                  rst_n,
+
+    // Core side
+    input  logic                  req_i,
+    input  logic [ADDR_WIDTH-1:0] addr_i,
+    output logic                  gnt_o,
+    output logic                  rvalid_o,
+    output logic [127:0]          rdata_o,
+
+    // Memory side
+    output logic                  mem_req_o,
+    output logic [ADDR_WIDTH-1:0] mem_addr_o,
+    input  logic                  mem_gnt_i,
+    input  logic                  mem_rvalid_i,
+    input  logic [127:0]          mem_rdata_i,
+
+    // Statistics
+    input  logic                  clear_counters_i,
+    output logic [31:0]           hit_cnt_o,
+    output logic [31:0]           miss_cnt_o,
+    output logic [31:0]           refill_cnt_o
+);
+    localparam int BEATS  = LINE_BYTES / 16;
+    localparam int SETS   = SIZE_BYTES / (LINE_BYTES * WAYS);
+    localparam int OFF_W  = $clog2(LINE_BYTES);
+    localparam int IDX_W  = (SETS > 1) ? $clog2(SETS) : 1;
+    localparam int TAG_LO = OFF_W + ((SETS > 1) ? $clog2(SETS) : 0);
+    localparam int TAG_W  = ADDR_WIDTH - TAG_LO;
+    localparam int WAY_W  = (WAYS > 1) ? $clog2(WAYS) : 1;
+    localparam int BEAT_W = (BEATS > 1) ? $clog2(BEATS) : 1;
+    localparam int DLY_W  = $clog2(REFILL_LATENCY + 1) + 1;
+
+    logic [127:0]     data  [SETS][WAYS][BEATS];
+    logic [TAG_W-1:0] tag   [SETS][WAYS];
+    logic             valid [SETS][WAYS];
+    logic [WAY_W-1:0] victim[SETS];
+
+    typedef enum logic [1:0] { IDLE, DELAY, FILL } ic_state_t;
+    ic_state_t state;
+
+    // Lookup
+    logic [IDX_W-1:0]  set;
+    logic [TAG_W-1:0]  addr_tag;
+    logic [BEAT_W-1:0] beat;
+    logic              hit;
+    logic [WAY_W-1:0]  hit_way;
+
+    assign set      = (SETS > 1) ? IDX_W'(addr_i >> OFF_W) : '0;
+    assign addr_tag = addr_i[ADDR_WIDTH-1:TAG_LO];
+    assign beat     = (BEATS > 1) ? BEAT_W'(addr_i >> 4) : '0;
+
+    always_comb begin
+        hit     = 1'b0;
+        hit_way = '0;
+        for (int w = 0; w < WAYS; w++) begin
+            if (valid[set][w] && tag[set][w] == addr_tag) begin
+                hit     = 1'b1;
+                hit_way = WAY_W'(w);
+            end
+        end
+    end
+
+    assign gnt_o = (state == IDLE) && req_i && hit;
+
+    // Refill
+    logic [ADDR_WIDTH-1:0] fill_base;
+    logic [IDX_W-1:0]      fill_set;
+    logic [TAG_W-1:0]      fill_tag;
+    logic [WAY_W-1:0]      fill_way;
+    logic [BEAT_W:0]       req_beat, rsp_beat;
+    logic [DLY_W-1:0]      delay;
+    logic                  refilled;
+
+    assign mem_req_o  = (state == FILL) && (req_beat < (BEAT_W+1)'(BEATS));
+    assign mem_addr_o = fill_base + ADDR_WIDTH'({req_beat, 4'b0000});
+
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            state    <= IDLE;
+            rvalid_o <= 1'b0;
+            rdata_o  <= '0;
+            req_beat <= '0;
+            rsp_beat <= '0;
+            delay    <= '0;
+            refilled <= 1'b0;
+            for (int s = 0; s < SETS; s++) begin
+                victim[s] <= '0;
+                for (int w = 0; w < WAYS; w++)
+                    valid[s][w] <= 1'b0;
+            end
+        end else begin
+            rvalid_o <= gnt_o;
+            if (gnt_o) begin
+                rdata_o  <= data[set][hit_way][beat];
+                refilled <= 1'b0;
+            end
+
+            case (state)
+                IDLE: begin
+                    if (req_i && !hit) begin
+                        fill_base <= {addr_i[ADDR_WIDTH-1:OFF_W], OFF_W'(0)};
+                        fill_set  <= set;
+                        fill_tag  <= addr_tag;
+                        fill_way  <= victim[set];
+                        valid[set][victim[set]] <= 1'b0;
+                        req_beat  <= '0;
+                        rsp_beat  <= '0;
+                        delay     <= DLY_W'(REFILL_LATENCY);
+                        state     <= (REFILL_LATENCY > 0) ? DELAY : FILL;
+                    end
+                end
+
+                DELAY: begin
+                    delay <= delay - 1'b1;
+                    if (delay == DLY_W'(1)) state <= FILL;
+                end
+
+                FILL: begin
+                    if (mem_req_o && mem_gnt_i) req_beat <= req_beat + 1'b1;
+                    if (mem_rvalid_i) begin
+                        data[fill_set][fill_way][rsp_beat[BEAT_W-1:0]] <= mem_rdata_i;
+                        rsp_beat <= rsp_beat + 1'b1;
+                        if (rsp_beat == (BEAT_W+1)'(BEATS - 1)) begin
+                            tag[fill_set][fill_way]   <= fill_tag;
+                            valid[fill_set][fill_way] <= 1'b1;
+                            victim[fill_set]          <= (fill_way == WAY_W'(WAYS - 1)) ? '0 : fill_way + 1'b1;
+                            refilled                  <= 1'b1;
+                            state                     <= IDLE;
+                        end
+                    end
+                end
+
+                default: state <= IDLE;
+            endcase
+        end
+    end
+
+    // Statistics
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            hit_cnt_o    <= '0;
+            miss_cnt_o   <= '0;
+            refill_cnt_o <= '0;
+        end else if (clear_counters_i) begin
+            hit_cnt_o    <= '0;
+            miss_cnt_o   <= '0;
+            refill_cnt_o <= '0;
+        end else begin
+            if (gnt_o && !refilled)                 hit_cnt_o    <= hit_cnt_o + 32'h1;
+            if (state == IDLE && req_i && !hit)     miss_cnt_o   <= miss_cnt_o + 32'h1;
+            if (state != IDLE)                      refill_cnt_o <= refill_cnt_o + 32'h1;
+        end
+    end
+endmodule
@@ -1,4 +1,33 @@
-module imc_controller (
+// CELL_MODEL / ADC_BITS are forwarded to reram_crossbar_8x8 and reported
+// through ADDR_INFO so firmware can tag its results with the model used.
+//
+// Input application modes (ADDR_CTRL[0]):
+//   parallel   - cb_voltages_packed is driven as full 8-bit row voltages
+//   bit-serial - the top INPUT_BITS bit-planes are driven MSB first as 1-bit
+//                voltages, one plane per cycle, and the output currents are
+//                shift-accumulated internally. The write to ADDR_V_INPUT_HI
+//                starts the sequence, ADDR_STATUS[0] is set while it runs.
+//
+// With ADDR_CTRL[1] set, every evaluation (parallel or bit-serial) is added
+// into eight per-row accumulators (ADDR_ACC) so a long dot product can be
+// tiled over the columns and read back once. Any write to ADDR_ACC_CLEAR
+// zeroes them. The accumulators hold raw currents; the weight offset
+// correction is applied once by firmware on readout. ADDR_STATUS[2] is set
+// from a parallel V_INPUT_HI write until its currents are added in.
+//
+// Tile loader: writing ADDR_DMA_CTRL fetches ROWS * 8 conductance bytes
+// (already +128 encoded, row-major, 8 bytes per row) from ADDR_DMA_SRC over
+// the m_* bus-master port and programs them a whole crossbar row at a time.
+// ADDR_STATUS[1] is set until the last row is written.
+//
+// done_o pulses for one cycle when ADDR_STATUS[1:0] drops back to idle.
+// prog_busy_o is set while cells are being programmed (single cell writes
+// and tile loads), eval_busy_o while inputs are applied to the crossbar
+// (input writes and bit-serial planes); both feed core perf counters.
+module imc_controller #(
+    parameter int CELL_MODEL = 0,
+    parameter int ADC_BITS   = 0
+)(
     input  logic        clk,
     input  logic        rst_n,
     input  logic        req,
@@ -7,63 +36,252 @@ module imc_controller (
     input  logic [31:0] wdata,
     output logic [31:0] rdata,
     output logic        gnt,
-    output logic        rvalid
+    output logic        rvalid,
+
+    // Tile loader bus master
+    output logic        m_req,
+    output logic [31:0] m_addr,
+    input  logic        m_gnt,
+    input  logic        m_rvalid,
+    input  logic [31:0] m_rdata,
+
+    output logic        done_o,
+    output logic        prog_busy_o,
+    output logic        eval_busy_o
 );
     localparam ADDR_PROG_DATA  = 32'h400;
     localparam ADDR_PROG_ADDR  = 32'h404;
     localparam ADDR_V_INPUT_LO = 32'h408;
     localparam ADDR_V_INPUT_HI = 32'h40C;
     localparam ADDR_RESULT     = 32'h410; // 0x410 to 0x42C
+    localparam ADDR_INFO       = 32'h430; // [7:0] CELL_MODEL, [15:8] ADC_BITS
+    localparam ADDR_CTRL       = 32'h434; // [0] bit-serial, [1] accumulate, [11:8] input bits (1-8)
+    localparam ADDR_STATUS     = 32'h438; // [0] bit-serial sequence busy, [1] tile load busy, [2] accumulate pending
+    localparam ADDR_ACC_CLEAR  = 32'h43C;
+    localparam ADDR_ACC        = 32'h440; // 0x440 to 0x45C
+    localparam ADDR_DMA_SRC    = 32'h460;
+    localparam ADDR_DMA_CTRL   = 32'h464; // [2:0] first row, [7:4] rows (0 = 8), starts the load
 
     logic [63:0]  cb_voltages_packed;
+    logic [63:0]  cb_drive_packed;
     logic [255:0] cb_currents_packed;
-    
+
     logic        cb_prog_en;
     logic [5:0]  cb_prog_addr;
     logic [7:0]  cb_prog_data;
 
+    // Bit-serial state
+    logic        serial_en;
+    logic [3:0]  serial_bits;
+    logic        serial_busy;
+    logic [2:0]  serial_plane;
+    logic [3:0]  serial_left;
+    logic [31:0] serial_acc [0:7];
+    logic [31:0] serial_acc_next [0:7];
+
+    // Tile accumulation state
+    logic        accum_en;
+    logic        accum_pending;
+    logic        eval_pending;
+    logic [31:0] accum [0:7];
+
+    // Tile loader state
+    logic        dma_busy;
+    logic [31:0] dma_src;
+    logic [2:0]  dma_row;
+    logic [4:0]  dma_words;
+    logic [4:0]  dma_issued;
+    logic [4:0]  dma_recv;
+    logic [31:0] dma_lo_word;
+    logic        cb_row_en;
+    logic [2:0]  cb_row;
+    logic [63:0] cb_row_data;
+
     assign gnt = req;
 
     always_ff @(posedge clk or negedge rst_n) begin
         if (!rst_n) rvalid <= 1'b0;
-        else        rvalid <= req; 
+        else        rvalid <= req;
     end
 
-    reram_crossbar_8x8 crossbar_i (
-        .clk(clk), 
+    // Crossbar drive: full voltages, or the current bit-plane as 0/1 volts
+    always_comb begin
+        if (serial_busy) begin
+            for (int c = 0; c < 8; c++)
+                cb_drive_packed[c*8 +: 8] = {7'b0, cb_voltages_packed[c*8 + serial_plane]};
+        end else begin
+            cb_drive_packed = cb_voltages_packed;
+        end
+    end
+
+    reram_crossbar_8x8 #(
+        .CELL_MODEL(CELL_MODEL),
+        .ADC_BITS  (ADC_BITS)
+    ) crossbar_i (
+        .clk(clk),
         .rst_n(rst_n),
-        .prog_enable(cb_prog_en), 
-        .prog_addr(cb_prog_addr), 
+        .prog_enable(cb_prog_en),
+        .prog_addr(cb_prog_addr),
         .prog_data(cb_prog_data),
-        .voltages_packed(cb_voltages_packed),
+        .prog_row_enable(cb_row_en),
+        .prog_row(cb_row),
+        .prog_row_data(cb_row_data),
+        .binary_inputs(serial_busy),
+        .read_enable(eval_pending || serial_busy),
+        .voltages_packed(cb_drive_packed),
         .currents_packed(cb_currents_packed)
     );
 
     // Write Logic
     always_ff @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
-            cb_prog_en <= 1'b0; 
-            cb_prog_addr <= 6'h0; 
+            cb_prog_en <= 1'b0;
+            cb_prog_addr <= 6'h0;
             cb_prog_data <= 8'h0;
             cb_voltages_packed <= 64'h0;
+            serial_en   <= 1'b0;
+            accum_en    <= 1'b0;
+            serial_bits <= 4'd8;
         end else begin
-            if (cb_prog_en) cb_prog_en <= 1'b0; 
+            if (cb_prog_en) cb_prog_en <= 1'b0;
 
             if (req && we) begin
                 if (addr == ADDR_PROG_DATA) begin
                     cb_prog_data <= wdata[7:0];
                 end else if (addr == ADDR_PROG_ADDR) begin
                     cb_prog_addr <= wdata[5:0];
-                    cb_prog_en   <= 1'b1; 
+                    cb_prog_en   <= 1'b1;
                 end else if (addr == ADDR_V_INPUT_LO) begin
                     cb_voltages_packed[31:0] <= wdata;
                 end else if (addr == ADDR_V_INPUT_HI) begin
                     cb_voltages_packed[63:32] <= wdata;
+                end else if (addr == ADDR_CTRL) begin
+                    serial_en   <= wdata[0];
+                    accum_en    <= wdata[1];
+                    serial_bits <= (wdata[11:8] == 4'd0 || wdata[11:8] > 4'd8) ? 4'd8 : wdata[11:8];
                 end
             end
         end
     end
 
+    // Bit-serial sequencer: acc = 2*acc + I(plane), MSB plane first. The
+    // final plane also restores the weight of the truncated LSB planes so
+    // the result has the same scale as a parallel evaluation.
+    always_comb begin
+        for (int i = 0; i < 8; i++) begin
+            automatic logic [31:0] acc_next = (serial_acc[i] << 1) + cb_currents_packed[i*32 +: 32];
+            serial_acc_next[i] = (serial_left == 4'd1) ? acc_next << (4'd8 - serial_bits) : acc_next;
+        end
+    end
+
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            serial_busy  <= 1'b0;
+            serial_plane <= 3'd7;
+            serial_left  <= 4'd0;
+            for (int i = 0; i < 8; i++) serial_acc[i] <= 32'h0;
+        end else if (serial_busy) begin
+            for (int i = 0; i < 8; i++) serial_acc[i] <= serial_acc_next[i];
+            serial_plane <= serial_plane - 3'd1;
+            serial_left  <= serial_left - 4'd1;
+            if (serial_left == 4'd1) serial_busy <= 1'b0;
+        end else if (req && we && addr == ADDR_V_INPUT_HI && serial_en) begin
+            serial_busy  <= 1'b1;
+            serial_plane <= 3'd7;
+            serial_left  <= serial_bits;
+            for (int i = 0; i < 8; i++) serial_acc[i] <= 32'h0;
+        end
+    end
+
+    // Tile loader: requests are issued back to back, every second returned
+    // word completes a row and programs it on the next edge.
+    assign m_req  = dma_busy && (dma_issued != dma_words);
+    assign m_addr = dma_src + {25'b0, dma_issued, 2'b00};
+
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            dma_busy    <= 1'b0;
+            dma_src     <= 32'h0;
+            dma_row     <= 3'd0;
+            dma_words   <= 5'd0;
+            dma_issued  <= 5'd0;
+            dma_recv    <= 5'd0;
+            dma_lo_word <= 32'h0;
+            cb_row_en   <= 1'b0;
+            cb_row      <= 3'd0;
+            cb_row_data <= 64'h0;
+        end else begin
+            cb_row_en <= 1'b0;
+
+            if (req && we && addr == ADDR_DMA_SRC) begin
+                dma_src <= {wdata[31:2], 2'b00};
+            end
+
+            if (!dma_busy) begin
+                if (req && we && addr == ADDR_DMA_CTRL) begin
+                    dma_busy   <= 1'b1;
+                    dma_row    <= wdata[2:0];
+                    dma_words  <= (wdata[7:4] == 4'd0 || wdata[7:4] > 4'd8) ? 5'd16 : {wdata[7:4], 1'b0};
+                    dma_issued <= 5'd0;
+                    dma_recv   <= 5'd0;
+                end
+            end else begin
+                if (m_req && m_gnt) dma_issued <= dma_issued + 5'd1;
+
+                if (m_rvalid) begin
+                    if (!dma_recv[0]) begin
+                        dma_lo_word <= m_rdata;
+                    end else begin
+                        cb_row_en   <= 1'b1;
+                        cb_row      <= dma_row;
+                        cb_row_data <= {m_rdata, dma_lo_word};
+                        dma_row     <= dma_row + 3'd1;
+                    end
+                    dma_recv <= dma_recv + 5'd1;
+                    if (dma_recv == dma_words - 5'd1) dma_busy <= 1'b0;
+                end
+            end
+        end
+    end
+
+    // Completion event
+    logic status_busy, status_busy_q;
+    assign status_busy = serial_busy || dma_busy || cb_row_en;
+    assign done_o      = status_busy_q && !status_busy;
+
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) status_busy_q <= 1'b0;
+        else        status_busy_q <= status_busy;
+    end
+
+    // Activity for the performance counters
+    assign prog_busy_o = cb_prog_en || dma_busy || cb_row_en;
+    assign eval_busy_o = serial_busy ||
+                         (req && we && (addr == ADDR_V_INPUT_LO || addr == ADDR_V_INPUT_HI));
+
+    // Tile accumulators. A parallel evaluation is added the cycle after the
+    // V_INPUT_HI write (once the new voltages reach the crossbar), a
+    // bit-serial one on its last plane. That cycle, or every plane, is the
+    // read cycle of the crossbar cells.
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            eval_pending  <= 1'b0;
+            accum_pending <= 1'b0;
+            for (int i = 0; i < 8; i++) accum[i] <= 32'h0;
+        end else begin
+            eval_pending  <= req && we && addr == ADDR_V_INPUT_HI && !serial_en;
+            accum_pending <= req && we && addr == ADDR_V_INPUT_HI && accum_en && !serial_en;
+
+            if (req && we && addr == ADDR_ACC_CLEAR) begin
+                for (int i = 0; i < 8; i++) accum[i] <= 32'h0;
+            end else if (accum_pending) begin
+                for (int i = 0; i < 8; i++) accum[i] <= accum[i] + cb_currents_packed[i*32 +: 32];
+            end else if (accum_en && serial_busy && serial_left == 4'd1) begin
+                for (int i = 0; i < 8; i++) accum[i] <= accum[i] + serial_acc_next[i];
+            end
+        end
+    end
+
     // Sequential Read Logic
     always_ff @(posedge clk or negedge rst_n) begin
         if (!rst_n) begin
@@ -73,14 +291,24 @@ module imc_controller (
                 if (addr >= ADDR_RESULT && addr <= 32'h42C) begin
                     int idx = (addr - ADDR_RESULT) >> 2;
                     if (idx < 8) begin
-                        rdata <= cb_currents_packed[idx*32 +: 32]; 
+                        rdata <= serial_en ? serial_acc[idx] : cb_currents_packed[idx*32 +: 32];
                     end else begin
                         rdata <= 32'h0;
                     end
+                end else if (addr >= ADDR_ACC && addr <= 32'h45C) begin
+                    rdata <= accum[(addr - ADDR_ACC) >> 2];
                 end else if (addr == ADDR_PROG_ADDR) begin
                     rdata <= {26'b0, cb_prog_addr};
                 end else if (addr == ADDR_PROG_DATA) begin
                     rdata <= {24'b0, cb_prog_data};
+                end else if (addr == ADDR_INFO) begin
+                    rdata <= {16'b0, 8'(ADC_BITS), 8'(CELL_MODEL)};
+                end else if (addr == ADDR_DMA_SRC) begin
+                    rdata <= dma_src;
+                end else if (addr == ADDR_CTRL) begin
+                    rdata <= {20'b0, serial_bits, 6'b0, accum_en, serial_en};
+                end else if (addr == ADDR_STATUS) begin
+                    rdata <= {29'b0, accum_pending, dma_busy || cb_row_en, serial_busy};
                 end else begin
                     rdata <= 32'h0;
                 end
@@ -1,6 +1,14 @@
 // =============================================================
 // NPU Coprocessor - 8x8 MAC Array with mixed signed/unsigned
 // =============================================================
+// Reachable through the MMIO window of top.sv and through core 0's
+// coprocessor port (OPCODE_COP, funct7 0). funct3 selects the instruction:
+//   0 npu.ldw  rs1 = 4 weights, rs2 = word index 0-15 (as MMIO offset / 4)
+//   1 npu.push rs1 = inputs 0-3, rs2 = inputs 4-7, raises done_o
+//   2 npu.acc  rd = accumulator of row rs1[2:0], answers one cycle later
+// ldw and push return 0 in the issue cycle. The core's decoder raises an
+// illegal instruction for any other funct7/funct3, the encodings are
+// COP_NPU_* in riscv_defines.
 module npu_coprocessor (
     input  logic        clk,
     input  logic        rst_n,
@@ -9,8 +17,21 @@ module npu_coprocessor (
     input  logic [31:0] cpu_wdata,
     input  logic        cpu_read,
     input  logic [6:0]  cpu_read_off,
-    output logic [31:0] cpu_rdata
+    output logic [31:0] cpu_rdata,
+    output logic        done_o,     // results valid after the upper input word write
+
+    input  logic        cop_valid,
+    output logic        cop_ready,
+    input  logic [9:0]  cop_op,     // {funct7, funct3}
+    input  logic [31:0] cop_operand_a,
+    input  logic [31:0] cop_operand_b,
+    output logic [31:0] cop_result
 );
+    logic cop_ldw, cop_push, cop_acc;
+    assign cop_ldw  = cop_valid && cop_op == riscv_defines::COP_NPU_LDW;
+    assign cop_push = cop_valid && cop_op == riscv_defines::COP_NPU_PUSH;
+    assign cop_acc  = cop_valid && cop_op == riscv_defines::COP_NPU_ACC;
+
     // Weights: always signed INT8
     logic signed [7:0] weight_buf [0:63];
     
@@ -21,19 +42,36 @@ module npu_coprocessor (
         if (!rst_n) begin
             for (int i = 0; i < 64; i++) weight_buf[i] <= 8'sh0;
             for (int i = 0; i < 8;  i++) input_buf[i]  <= 8'h0;
-        end else if (cpu_write) begin
-            if (cpu_byte_off < 7'h40) begin
-                automatic int base = {cpu_byte_off[5:2], 2'b00};
-                weight_buf[base+0] <= $signed(cpu_wdata[7:0]);
-                weight_buf[base+1] <= $signed(cpu_wdata[15:8]);
-                weight_buf[base+2] <= $signed(cpu_wdata[23:16]);
-                weight_buf[base+3] <= $signed(cpu_wdata[31:24]);
-            end else if (cpu_byte_off >= 7'h40 && cpu_byte_off <= 7'h47) begin
-                automatic int base = cpu_byte_off[2] ? 4 : 0;
-                input_buf[base+0] <= cpu_wdata[7:0];    // unsigned
-                input_buf[base+1] <= cpu_wdata[15:8];
-                input_buf[base+2] <= cpu_wdata[23:16];
-                input_buf[base+3] <= cpu_wdata[31:24];
+        end else begin
+            if (cpu_write) begin
+                if (cpu_byte_off < 7'h40) begin
+                    automatic int base = {cpu_byte_off[5:2], 2'b00};
+                    weight_buf[base+0] <= $signed(cpu_wdata[7:0]);
+                    weight_buf[base+1] <= $signed(cpu_wdata[15:8]);
+                    weight_buf[base+2] <= $signed(cpu_wdata[23:16]);
+                    weight_buf[base+3] <= $signed(cpu_wdata[31:24]);
+                end else if (cpu_byte_off >= 7'h40 && cpu_byte_off <= 7'h47) begin
+                    automatic int base = cpu_byte_off[2] ? 4 : 0;
+                    input_buf[base+0] <= cpu_wdata[7:0];    // unsigned
+                    input_buf[base+1] <= cpu_wdata[15:8];
+                    input_buf[base+2] <= cpu_wdata[23:16];
+                    input_buf[base+3] <= cpu_wdata[31:24];
+                end
+            end
+
+            // An instruction wins over an MMIO write to the same bytes
+            if (cop_ldw) begin
+                automatic int base = {cop_operand_b[3:0], 2'b00};
+                weight_buf[base+0] <= $signed(cop_operand_a[7:0]);
+                weight_buf[base+1] <= $signed(cop_operand_a[15:8]);
+                weight_buf[base+2] <= $signed(cop_operand_a[23:16]);
+                weight_buf[base+3] <= $signed(cop_operand_a[31:24]);
+            end
+            if (cop_push) begin
+                for (int i = 0; i < 4; i++) begin
+                    input_buf[i]   <= cop_operand_a[i*8 +: 8];
+                    input_buf[i+4] <= cop_operand_b[i*8 +: 8];
+                end
             end
         end
     end
@@ -53,6 +91,29 @@ module npu_coprocessor (
         end
     end
 
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) done_o <= 1'b0;
+        else        done_o <= (cpu_write && cpu_byte_off[6:2] == 5'h11) || cop_push;
+    end
+
+    // The accumulator read is registered like the MMIO read, which keeps the
+    // MAC array out of the core's forwarding path
+    logic        acc_valid;
+    logic [31:0] acc_q;
+
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            acc_valid <= 1'b0;
+            acc_q     <= 32'h0;
+        end else begin
+            acc_valid <= cop_acc && !acc_valid;
+            acc_q     <= mac_out[cop_operand_a[2:0]];
+        end
+    end
+
+    assign cop_ready  = !cop_acc || acc_valid;
+    assign cop_result = cop_acc ? acc_q : 32'h0;
+
     always_ff @(posedge clk or negedge rst_n) begin
         if (!rst_n) cpu_rdata <= 32'h0;
         else if (cpu_read) begin
@@ -1,6 +1,26 @@
+/////////////////////////////////////////////////////////////
+// Timing model
+/////////////////////////////////////////////////////////////
+// Each port answers LATENCY cycles after its grant (1 = single-cycle SRAM,
+// fully pipelined). Longer latencies model a non-pipelined device that
+// accepts the next request once the previous one has returned. Accesses in
+// [SLOW_BASE, SLOW_END) use SLOW_LATENCY instead, e.g. weights kept in
+// flash/ReRAM. Wait states withhold the grant: WAIT_MODE 1 blocks one cycle
+// in every WAIT_PERIOD, WAIT_MODE 2 blocks WAIT_PCT percent of cycles at
+// random. All knobs can be overridden at run time with plusargs:
+//   +instr_lat=N +data_lat=N +slow_lat=N +slow_base=HEX +slow_end=HEX
+//   +wait_mode=N +wait_period=N +wait_pct=N +wait_seed=N
 module ram
 #(
-    parameter ADDR_WIDTH = 20   // 1 MB RAM
+    parameter ADDR_WIDTH    = 20,   // 1 MB RAM
+    parameter INSTR_LATENCY = 1,
+    parameter DATA_LATENCY  = 1,
+    parameter SLOW_BASE     = 0,
+    parameter SLOW_END      = 0,
+    parameter SLOW_LATENCY  = 1,
+    parameter WAIT_MODE     = 0,    // 0: none, 1: periodic, 2: random
+    parameter WAIT_PERIOD   = 4,
+    parameter WAIT_PCT      = 10
 )
 (
     input  logic        clk,
@@ -29,22 +49,111 @@ module ram
 );
 
   /////////////////////////////////////////////////////////////
-  // Immediate Grants
+  // Timing Knobs
   /////////////////////////////////////////////////////////////
-  assign instr_gnt_o = instr_req_i;
-  assign data_gnt_o  = data_req_i;
+  int          instr_lat, data_lat, slow_lat;
+  int          wait_mode, wait_period, wait_pct, wait_seed;
+  logic [31:0] slow_base, slow_end;
+
+  initial begin
+    instr_lat   = INSTR_LATENCY;
+    data_lat    = DATA_LATENCY;
+    slow_lat    = SLOW_LATENCY;
+    slow_base   = SLOW_BASE;
+    slow_end    = SLOW_END;
+    wait_mode   = WAIT_MODE;
+    wait_period = WAIT_PERIOD;
+    wait_pct    = WAIT_PCT;
+    wait_seed   = 1;
+
+    void'($value$plusargs("instr_lat=%d", instr_lat));
+    void'($value$plusargs("data_lat=%d", data_lat));
+    void'($value$plusargs("slow_lat=%d", slow_lat));
+    void'($value$plusargs("slow_base=%h", slow_base));
+    void'($value$plusargs("slow_end=%h", slow_end));
+    void'($value$plusargs("wait_mode=%d", wait_mode));
+    void'($value$plusargs("wait_period=%d", wait_period));
+    void'($value$plusargs("wait_pct=%d", wait_pct));
+    void'($value$plusargs("wait_seed=%d", wait_seed));
+
+    if (instr_lat < 1)   instr_lat   = 1;
+    if (data_lat < 1)    data_lat    = 1;
+    if (slow_lat < 1)    slow_lat    = 1;
+    if (wait_period < 1) wait_period = 1;
+    void'($urandom(wait_seed));
+
+    $display("RAM timing: instr %0d, data %0d, slow [0x%0x, 0x%0x) %0d, wait mode %0d (period %0d, %0d%%)",
+             instr_lat, data_lat, slow_base, slow_end, slow_lat, wait_mode, wait_period, wait_pct);
+  end
+
+  function automatic int port_latency(input logic [ADDR_WIDTH-1:0] addr, input int lat);
+    if (32'(addr) >= slow_base && 32'(addr) < slow_end) return slow_lat;
+    return lat;
+  endfunction
 
   /////////////////////////////////////////////////////////////
-  // Valid Signals
+  // Wait States (decided one cycle ahead, per port)
   /////////////////////////////////////////////////////////////
+  int   wait_ctr;
+  logic instr_wait, data_wait;
+
   always_ff @(posedge clk or negedge rst_n) begin
     if (!rst_n) begin
-      instr_rvalid_o <= 1'b0;
-      data_rvalid_o  <= 1'b0;
-    end 
+      wait_ctr   <= 0;
+      instr_wait <= 1'b0;
+      data_wait  <= 1'b0;
+    end
     else begin
-      instr_rvalid_o <= instr_req_i;
-      data_rvalid_o  <= data_req_i;
+      wait_ctr <= (wait_ctr + 1 >= wait_period) ? 0 : wait_ctr + 1;
+      case (wait_mode)
+        1:       begin instr_wait <= (wait_ctr == 0); data_wait <= (wait_ctr == 0); end
+        2:       begin instr_wait <= ($urandom % 100) < wait_pct; data_wait <= ($urandom % 100) < wait_pct; end
+        default: begin instr_wait <= 1'b0; data_wait <= 1'b0; end
+      endcase
+    end
+  end
+
+  /////////////////////////////////////////////////////////////
+  // Grants, Valid Signals and Latched Requests
+  /////////////////////////////////////////////////////////////
+  logic                  instr_en, instr_latched;
+  logic                  data_en, data_latched;
+  logic [ADDR_WIDTH-1:0] instr_addr_q, data_addr_q;
+  logic                  data_we_q;
+  logic [3:0]            data_be_q;
+  logic [31:0]           data_wdata_q;
+
+  ram_port_timing instr_timing_i (
+    .clk       (clk),
+    .rst_n     (rst_n),
+    .req_i     (instr_req_i),
+    .wait_i    (instr_wait),
+    .latency_i (port_latency(instr_addr_i, instr_lat)),
+    .gnt_o     (instr_gnt_o),
+    .en_o      (instr_en),
+    .latched_o (instr_latched),
+    .rvalid_o  (instr_rvalid_o)
+  );
+
+  ram_port_timing data_timing_i (
+    .clk       (clk),
+    .rst_n     (rst_n),
+    .req_i     (data_req_i),
+    .wait_i    (data_wait),
+    .latency_i (port_latency(data_addr_i, data_lat)),
+    .gnt_o     (data_gnt_o),
+    .en_o      (data_en),
+    .latched_o (data_latched),
+    .rvalid_o  (data_rvalid_o)
+  );
+
+  always_ff @(posedge clk) begin
+    if (instr_gnt_o) instr_addr_q <= instr_addr_i;
+    if (data_gnt_o) begin
+      data_addr_q  <= data_addr_i;
+      data_we_q    <= data_we_i;
+      data_be_q    <= data_be_i;
+      data_wdata_q <= data_wdata_i;
     end
   end
 
@@ -59,8 +168,8 @@ module ram
       ///////////////////////
       // PORT A → INSTRUCTION
       ///////////////////////
-      .en_a_i    (instr_req_i),
-      .addr_a_i  (instr_addr_i),
+      .en_a_i    (instr_en),
+      .addr_a_i  (instr_latched ? instr_addr_q : instr_addr_i),
       .wdata_a_i (32'b0),
       .rdata_a_o (instr_rdata_o),
       .we_a_i    (1'b0),
@@ -69,12 +178,12 @@ module ram
       ///////////////////////
       // PORT B → DATA
       ///////////////////////
-      .en_b_i    (data_req_i),
-      .addr_b_i  (data_addr_i),
-      .wdata_b_i (data_wdata_i),
+      .en_b_i    (data_en),
+      .addr_b_i  (data_latched ? data_addr_q  : data_addr_i),
+      .wdata_b_i (data_latched ? data_wdata_q : data_wdata_i),
       .rdata_b_o (data_rdata_o),
-      .we_b_i    (data_we_i),
-      .be_b_i    (data_be_i)
+      .we_b_i    (data_latched ? data_we_q    : data_we_i),
+      .be_b_i    (data_latched ? data_be_q    : data_be_i)
   );
 
   /////////////////////////////////////////////////////////////
@@ -135,13 +244,13 @@ module ram
     $display("Firmware size: %0d bytes (0x%0x)", bytes_read, bytes_read);
 
     /////////////////////////////////////////////////////////////
-    // Copy ALL valid bytes to RAM at 0x80
+    // Copy ALL valid bytes to RAM at 0x0 (irq vectors, boot at 0x80)
     /////////////////////////////////////////////////////////////
     for (i = 0; i < bytes_read; i = i + 1) begin
-      dp_ram_i.mem[32'h80 + i] = temp_mem[i];
+      dp_ram_i.mem[i] = temp_mem[i];
     end
 
-    $display("Firmware loaded to RAM @ 0x80");
+    $display("Firmware loaded to RAM @ 0x0");
 
     /////////////////////////////////////////////////////////////
     // Sanity Dump
@@ -161,3 +270,47 @@ module ram
   end
 
 endmodule
+
+/////////////////////////////////////////////////////////////
+// Per-port request timing: grant, array enable and rvalid for a
+// latency of latency_i cycles between grant and rvalid
+/////////////////////////////////////////////////////////////
+module ram_port_timing
+(
+    input  logic clk,
+    input  logic rst_n,
+    input  logic req_i,
+    input  logic wait_i,
+    input  int   latency_i,
+    output logic gnt_o,
+    output logic en_o,        // access the array this cycle
+    output logic latched_o,   // ... with the request latched at grant
+    output logic rvalid_o
+);
+  logic busy;
+  int   cnt;
+
+  assign gnt_o     = req_i && !busy && !wait_i;
+  assign en_o      = (gnt_o && latency_i <= 1) || (busy && cnt == 1);
+  assign latched_o = busy;
+
+  always_ff @(posedge clk or negedge rst_n) begin
+    if (!rst_n) begin
+      busy     <= 1'b0;
+      cnt      <= 0;
+      rvalid_o <= 1'b0;
+    end
+    else begin
+      rvalid_o <= en_o;
+      if (gnt_o && latency_i > 1) begin
+        busy <= 1'b1;
+        cnt  <= latency_i - 1;
+      end
+      else if (busy) begin
+        cnt <= cnt - 1;
+        if (cnt == 1) busy <= 1'b0;
+      end
+    end
+  end
+
+endmodule
@@ -1,53 +1,63 @@
 
 // reram_cell_behavioral.sv
 // Behavioral model of ReRAM based on Verilog-A Linear Ion Drift
+//
+// Pin compatible with reram_cell_simple, plus read_enable, so
+// reram_crossbar_8x8 can swap it in for accuracy studies. w is the normalised
+// doped-region width (0 = fully OFF, 65535 = fully ON), programming sets it
+// from the 8-bit target code.
+//
+//   G(w) = G_OFF + (G_ON - G_OFF) * w / 2^16    finite ON/OFF ratio
+//   I    = G * V * (1 + NONLINEARITY * V / 2^16)  I-V nonlinearity
+//   dw   = I >> DRIFT_SHIFT  per read cycle      linear ion drift (read disturb)
+//
+// A read cycle is a cycle with read_enable set, the crossbar raises it while
+// an evaluation drives the cells, so the drift follows the number of reads
+// and not the length of the run.
 
 module reram_cell_behavioral #(
-    parameter real RON  = 100.0,
-    parameter real ROFF = 200000.0,  
-    parameter real D    = 3.0e-9,
-    parameter real UV   = 1.0e-15,
-    parameter real DT   = 1.0e-9,
-    parameter int  W_BITS = 16
+    parameter int G_ON         = 255,  // conductance code of a fully ON cell
+    parameter int ON_OFF_RATIO = 20,   // G_ON / G_OFF
+    parameter int NONLINEARITY = 16,   // Q8 coefficient of the V^2 term, 0 = linear
+    parameter int DRIFT_SHIFT  = 12    // 0 disables state drift
 )(
     input  logic        clk,
     input  logic        rst_n,
-    input  logic [15:0] voltage_in,
+    input  logic        program_enable,
+    input  logic        read_enable,
+    input  logic [7:0]  target_conductance,
+    input  logic [7:0]  voltage_in,
     output logic [15:0] current_out,
     output logic [15:0] w_state
 );
-    logic [W_BITS-1:0] w;
-    logic [W_BITS-1:0] w_next;
-    localparam real DWDT_COEFF = (UV * RON / D) * 65536.0;
-    localparam int  DWDT_SCALED = int'(DWDT_COEFF);
-    logic [31:0] resistance;
+    localparam longint G_ON_Q8  = longint'(G_ON) << 8;
+    localparam longint G_OFF_Q8 = G_ON_Q8 / ON_OFF_RATIO;
+
+    logic [15:0] w;
     logic [31:0] current;
-    
-    always_comb begin
-        automatic longint r_temp;
-        r_temp = (int'(RON) * w) + (int'(ROFF) * (65536 - w));
-        resistance = r_temp >> 16;
-        if (resistance != 0) current = (voltage_in * 1000) / resistance;
-        else                 current = 32'hFFFFFFFF;
-    end
-    
+
     always_comb begin
-        automatic longint dwdt;
-        automatic longint w_delta;
-        automatic int signed current_signed = signed'(current);
-        dwdt = DWDT_SCALED * current_signed;
-        w_delta = (dwdt * int'(DT * 1e9)) >> 16;
-        w_next = w + w_delta[W_BITS-1:0];
-        if (w_next > 65535) w_next = 65535;
-        else if (w_next[W_BITS-1]) w_next = 0;
+        automatic longint g_q8;
+        automatic longint i_lin;
+        automatic longint i_nl;
+        g_q8  = G_OFF_Q8 + (((G_ON_Q8 - G_OFF_Q8) * longint'(w)) >> 16);
+        i_lin = (g_q8 * longint'(voltage_in)) >> 8;
+        i_nl  = i_lin + ((i_lin * longint'(voltage_in) * NONLINEARITY) >> 16);
+        current = (i_nl > 65535) ? 32'd65535 : 32'(i_nl);
     end
-    
+
     always_ff @(posedge clk or negedge rst_n) begin
-        if (!rst_n) w <= 16'h8000;
-        else        w <= w_next;
+        if (!rst_n) begin
+            w <= 16'h0;
+        end else if (program_enable) begin
+            w <= {target_conductance, target_conductance};
+        end else if (read_enable && DRIFT_SHIFT != 0) begin
+            automatic logic [16:0] w_next = 17'(w) + 17'(current >> DRIFT_SHIFT);
+            w <= w_next[16] ? 16'hFFFF : w_next[15:0];
+        end
     end
-    
-    assign w_state = w;
+
+    assign w_state     = w;
     assign current_out = current[15:0];
 endmodule
 
@@ -75,32 +85,74 @@ module reram_cell_simple (
     assign current_out = 16'( (32'(voltage_in) * 32'(conductance_state)) );
 endmodule
 
-module reram_crossbar_8x8 (
+// CELL_MODEL selects the cell implementation:
+//   0 - reram_cell_simple, exact V*G (fast functional runs)
+//   1 - reram_cell_behavioral, drift / ON-OFF ratio / nonlinearity
+// ADC_BITS > 0 quantizes every output line to that many bits over the ideal
+// full scale (8 * 255 * 255, or 8 * 255 when binary_inputs marks a 0/1
+// bit-plane) and reconstructs it in current units, so the firmware offset
+// correction is unchanged. 0 bypasses the ADC.
+// prog_row_enable writes all 8 cells of row prog_row at once from
+// prog_row_data (cell c in byte c), alongside the single-cell prog_addr path.
+// read_enable marks the cycles in which the inputs are evaluated, it only
+// matters to the drift of the behavioral cells.
+module reram_crossbar_8x8 #(
+    parameter int CELL_MODEL = 0,
+    parameter int ADC_BITS   = 0
+)(
     input  logic         clk,
     input  logic         rst_n,
     input  logic         prog_enable,
     input  logic [5:0]   prog_addr,
     input  logic [7:0]   prog_data,
+    input  logic         prog_row_enable,
+    input  logic [2:0]   prog_row,
+    input  logic [63:0]  prog_row_data,
+    input  logic         binary_inputs,
+    input  logic         read_enable,
     input  logic [63:0]  voltages_packed,  
     output logic [255:0] currents_packed   
 );
-    logic [15:0] flat_cell_currents [0:63];
+    localparam longint ADC_FULL_SCALE     = 8 * 255 * 255;
+    localparam longint ADC_FULL_SCALE_BIN = 8 * 255;
+    localparam longint ADC_MAX_CODE   = (64'd1 << ADC_BITS) - 1;
+
+    logic [15:0]  flat_cell_currents [0:63];
+    logic [255:0] line_currents_packed;
 
     genvar r, c;
     generate
         for (r = 0; r < 8; r++) begin : row_gen
             for (c = 0; c < 8; c++) begin : col_gen
                 logic [7:0] v_in;
-                assign v_in = voltages_packed[c*8 +: 8];
-
-                reram_cell_simple cell_inst (
-                    .clk            (clk),
-                    .rst_n          (rst_n),
-                    .program_enable (prog_enable && (prog_addr == (r*8 + c))),
-                    .target_conductance(prog_data),
-                    .voltage_in     (v_in),
-                    .current_out    (flat_cell_currents[r*8 + c])
-                );
+                logic       cell_prog;
+                logic [7:0] cell_g;
+                assign v_in      = voltages_packed[c*8 +: 8];
+                assign cell_prog = (prog_enable && (prog_addr == (r*8 + c))) ||
+                                   (prog_row_enable && (prog_row == r));
+                assign cell_g    = prog_row_enable ? prog_row_data[c*8 +: 8] : prog_data;
+
+                if (CELL_MODEL == 0) begin : ideal_gen
+                    reram_cell_simple cell_inst (
+                        .clk            (clk),
+                        .rst_n          (rst_n),
+                        .program_enable (cell_prog),
+                        .target_conductance(cell_g),
+                        .voltage_in     (v_in),
+                        .current_out    (flat_cell_currents[r*8 + c])
+                    );
+                end else begin : behavioral_gen
+                    reram_cell_behavioral cell_inst (
+                        .clk            (clk),
+                        .rst_n          (rst_n),
+                        .program_enable (cell_prog),
+                        .read_enable    (read_enable),
+                        .target_conductance(cell_g),
+                        .voltage_in     (v_in),
+                        .current_out    (flat_cell_currents[r*8 + c]),
+                        .w_state        ()
+                    );
+                end
             end
         end
     endgenerate
@@ -112,9 +164,27 @@ module reram_crossbar_8x8 (
                 row_sum = row_sum + 64'(flat_cell_currents[i*8 + j]);
             end
             // EXACT MATH: Pass the raw sum directly without dividing
-            currents_packed[i*32 +: 32] = 32'(row_sum);
+            line_currents_packed[i*32 +: 32] = 32'(row_sum);
         end
     end
+
+    generate
+        if (ADC_BITS == 0) begin : adc_bypass_gen
+            assign currents_packed = line_currents_packed;
+        end else begin : adc_gen
+            always_comb begin
+                for (int i = 0; i < 8; i++) begin
+                    automatic longint fs     = binary_inputs ? ADC_FULL_SCALE_BIN : ADC_FULL_SCALE;
+                    automatic longint i_line = longint'(line_currents_packed[i*32 +: 32]);
+                    automatic longint code;
+                    if (i_line > fs) i_line = fs;
+                    code = (i_line * ADC_MAX_CODE + fs / 2) / fs;
+                    currents_packed[i*32 +: 32] =
+                        32'((code * fs + ADC_MAX_CODE / 2) / ADC_MAX_CODE);
+                end
+            end
+        end
+    endgenerate
 endmodule
 
 
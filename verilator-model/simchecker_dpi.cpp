@@ -0,0 +1,718 @@
+// =============================================================
+// Lockstep instruction checker (riscv_simchecker.sv DPI)
+// =============================================================
+// An RV32IMC + Xpulp instruction set simulator that checks every retired
+// instruction of a core against what the RTL did: the registers it wrote,
+// the addresses of its data accesses, the data it stored and the address of
+// the next instruction. The simulator has no memory, a load returns the data
+// the RTL read, so it checks the load unit's byte selection and extension but
+// not the memory system behind it.
+//
+// Build with "make SIMCHECK=1" and run with
+//   +simcheck       check every instruction
+//   +simcheck=N     check every Nth instruction
+//   +simregion      only check between SIMCHECK_BEGIN() and SIMCHECK_END()
+//                   (sw/simcheck.h), combines with +simcheck=N
+// The register file follows the RTL's writes after every instruction, checked
+// or not, so a sampled check needs no replay and an error is reported once
+// instead of spreading through the rest of the run. Skipped instructions only
+// cost the copy of their writes and the hardware loop bookkeeping.
+//
+// Not modelled, their writes are taken over unchecked: CSR reads, the
+// bit-manipulation, p.ff1/p.fl1/p.clb and p.clip forms of OPCODE_OP, the
+// OPCODE_PULP_OP group, the OPCODE_VECOP instructions other than the dot
+// products and the coprocessor. The first of them are logged as unchecked
+// and all are counted in the summary. After traps, mret and interrupts the
+// next pc is taken from the RTL.
+//
+// tb/simChecker runs this file on the host against hand-built instruction
+// streams, see its scripts/sim.sh.
+
+#include "verilated.h"
+#include "Vtop__Dpi.h"
+#include <cstdarg>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+namespace {
+
+// hint encodings of SIMCHECK_BEGIN() and SIMCHECK_END()
+const uint32_t MARK_BEGIN  = 0x00102013;   // slti x0, x0, 1
+const uint32_t MARK_END    = 0x00002013;   // slti x0, x0, 0
+
+const int      MAX_REPORTS = 10;
+
+inline int32_t sext(uint32_t v, int bits) {
+    return (int32_t)(v << (32 - bits)) >> (32 - bits);
+}
+
+inline uint32_t bits(uint32_t v, int hi, int lo) {
+    return (v >> lo) & ((1u << (hi - lo + 1)) - 1);
+}
+
+// the dot products of OPCODE_VECOP over lanes of 16, 8, 4 or 2 bits, as mult.sv
+// computes them
+uint32_t dot(uint32_t a, uint32_t b, int lane, bool sa, bool sb) {
+    uint32_t acc = 0;
+    for (int i = 0; i < 32; i += lane) {
+        int64_t x = sa ? sext(bits(a, i + lane - 1, i), lane) : bits(a, i + lane - 1, i);
+        int64_t y = sb ? sext(bits(b, i + lane - 1, i), lane) : bits(b, i + lane - 1, i);
+        acc += (uint32_t)(x * y);
+    }
+    return acc;
+}
+
+inline uint32_t enc_r(uint32_t op, uint32_t f3, uint32_t f7, uint32_t rd, uint32_t rs1, uint32_t rs2) {
+    return (f7 << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | op;
+}
+
+inline uint32_t enc_i(uint32_t op, uint32_t f3, uint32_t rd, uint32_t rs1, int32_t imm) {
+    return ((uint32_t)imm << 20) | (rs1 << 15) | (f3 << 12) | (rd << 7) | op;
+}
+
+inline uint32_t enc_s(uint32_t f3, uint32_t rs1, uint32_t rs2, int32_t imm) {
+    return (bits(imm, 11, 5) << 25) | (rs2 << 20) | (rs1 << 15) | (f3 << 12) | (bits(imm, 4, 0) << 7) | 0x23;
+}
+
+inline uint32_t enc_b(uint32_t f3, uint32_t rs1, uint32_t rs2, int32_t off) {
+    return (bits(off, 12, 12) << 31) | (bits(off, 10, 5) << 25) | (rs2 << 20) | (rs1 << 15) |
+           (f3 << 12) | (bits(off, 4, 1) << 8) | (bits(off, 11, 11) << 7) | 0x63;
+}
+
+inline uint32_t enc_j(uint32_t rd, int32_t off) {
+    return (bits(off, 20, 20) << 31) | (bits(off, 10, 1) << 21) | (bits(off, 11, 11) << 20) |
+           (bits(off, 19, 12) << 12) | (rd << 7) | 0x6f;
+}
+
+// RV32C to the equivalent 32 bit instruction, 0 for illegal encodings
+uint32_t expand_rvc(uint32_t c) {
+    uint32_t rd   = bits(c, 11, 7);
+    uint32_t rs2  = bits(c, 6, 2);
+    uint32_t rdp  = 8 + bits(c, 4, 2);
+    uint32_t rs1p = 8 + bits(c, 9, 7);
+    int32_t  imm6 = sext((bits(c, 12, 12) << 5) | bits(c, 6, 2), 6);
+    int32_t  joff = sext((bits(c, 12, 12) << 11) | (bits(c, 11, 11) << 4) | (bits(c, 10, 9) << 8) |
+                         (bits(c, 8, 8) << 10) | (bits(c, 7, 7) << 6) | (bits(c, 6, 6) << 7) |
+                         (bits(c, 5, 3) << 1) | (bits(c, 2, 2) << 5), 12);
+    int32_t  boff = sext((bits(c, 12, 12) << 8) | (bits(c, 6, 5) << 6) | (bits(c, 2, 2) << 5) |
+                         (bits(c, 11, 10) << 3) | (bits(c, 4, 3) << 1), 9);
+    uint32_t woff = (bits(c, 5, 5) << 6) | (bits(c, 12, 10) << 3) | (bits(c, 6, 6) << 2);
+
+    switch ((bits(c, 15, 13) << 2) | bits(c, 1, 0)) {
+    case 0x00: {    // c.addi4spn
+        uint32_t imm = (bits(c, 10, 7) << 6) | (bits(c, 12, 11) << 4) | (bits(c, 5, 5) << 3) | (bits(c, 6, 6) << 2);
+        return imm ? enc_i(0x13, 0, rdp, 2, imm) : 0;
+    }
+    case 0x08: return enc_i(0x03, 2, rdp, rs1p, woff);          // c.lw
+    case 0x18: return enc_s(2, rs1p, rdp, woff);                // c.sw
+    case 0x01: return enc_i(0x13, 0, rd, rd, imm6);             // c.addi
+    case 0x05: return enc_j(1, joff);                           // c.jal
+    case 0x09: return enc_i(0x13, 0, rd, 0, imm6);              // c.li
+    case 0x0d:
+        if (rd == 2) {                                          // c.addi16sp
+            int32_t imm = sext((bits(c, 12, 12) << 9) | (bits(c, 4, 3) << 7) | (bits(c, 5, 5) << 6) |
+                               (bits(c, 2, 2) << 5) | (bits(c, 6, 6) << 4), 10);
+            return imm ? enc_i(0x13, 0, 2, 2, imm) : 0;
+        }
+        return imm6 ? (((uint32_t)imm6 << 12) | (rd << 7) | 0x37) : 0;   // c.lui
+    case 0x11:
+        switch (bits(c, 11, 10)) {
+        case 0: return bits(c, 12, 12) ? 0 : enc_r(0x13, 5, 0x00, rs1p, rs1p, rs2);   // c.srli
+        case 1: return bits(c, 12, 12) ? 0 : enc_r(0x13, 5, 0x20, rs1p, rs1p, rs2);   // c.srai
+        case 2: return enc_i(0x13, 7, rs1p, rs1p, imm6);                              // c.andi
+        default:
+            if (bits(c, 12, 12)) return 0;
+            switch (bits(c, 6, 5)) {
+            case 0:  return enc_r(0x33, 0, 0x20, rs1p, rs1p, rdp);    // c.sub
+            case 1:  return enc_r(0x33, 4, 0x00, rs1p, rs1p, rdp);    // c.xor
+            case 2:  return enc_r(0x33, 6, 0x00, rs1p, rs1p, rdp);    // c.or
+            default: return enc_r(0x33, 7, 0x00, rs1p, rs1p, rdp);    // c.and
+            }
+        }
+    case 0x15: return enc_j(0, joff);                           // c.j
+    case 0x19: return enc_b(0, rs1p, 0, boff);                  // c.beqz
+    case 0x1d: return enc_b(1, rs1p, 0, boff);                  // c.bnez
+    case 0x02: return bits(c, 12, 12) ? 0 : enc_r(0x13, 1, 0x00, rd, rd, rs2);        // c.slli
+    case 0x0a: {    // c.lwsp
+        uint32_t off = (bits(c, 12, 12) << 5) | (bits(c, 6, 4) << 2) | (bits(c, 3, 2) << 6);
+        return rd ? enc_i(0x03, 2, rd, 2, off) : 0;
+    }
+    case 0x12:
+        if (!bits(c, 12, 12)) {
+            if (rs2) return enc_r(0x33, 0, 0, rd, 0, rs2);      // c.mv
+            return rd ? enc_i(0x67, 0, 0, rd, 0) : 0;           // c.jr
+        }
+        if (rs2) return enc_r(0x33, 0, 0, rd, rd, rs2);         // c.add
+        return rd ? enc_i(0x67, 0, 1, rd, 0) : 0x00100073;      // c.jalr, c.ebreak
+    case 0x1a: return enc_s(2, 2, rs2, (bits(c, 8, 7) << 6) | (bits(c, 12, 9) << 2));   // c.swsp
+    default:   return 0;
+    }
+}
+
+struct RegWrite {
+    uint32_t addr;
+    uint32_t value;
+};
+
+struct MemAccess {
+    bool     we;
+    uint32_t addr;
+    uint32_t data;
+};
+
+class Checker {
+public:
+    Checker(uint32_t boot_addr, int core_id, int cluster_id, uint32_t every, bool regions)
+        : core_id_(core_id), cluster_id_(cluster_id), every_(every), countdown_(every),
+          in_region_(!regions), next_known_(false), next_pc_(boot_addr), last_pc_(0), last_instr_(0),
+          n_rtl_reg_(0), n_rtl_mem_(0), irq_(false),
+          retired_(0), checked_(0), unmodelled_(0), mismatches_(0) {
+        memset(x_, 0, sizeof(x_));
+        memset(lp_start_, 0, sizeof(lp_start_));
+        memset(lp_end_, 0, sizeof(lp_end_));
+        memset(lp_count_, 0, sizeof(lp_count_));
+    }
+
+    void mem_access(bool we, uint32_t addr, uint32_t data) {
+        if (n_rtl_mem_ < 2) rtl_mem_[n_rtl_mem_++] = { we, addr, data };
+    }
+
+    void reg_access(uint32_t addr, uint32_t value) {
+        if (addr != 0 && n_rtl_reg_ < 2) rtl_reg_[n_rtl_reg_++] = { addr, value };
+    }
+
+    void irq(bool irq) { irq_ = irq; }
+
+    int step(long long simtime, uint32_t cycle, uint32_t pc, uint32_t instr);
+
+    void report() const {
+        printf("[SIMCHECKER] core %02x_%x: %llu instructions, %llu checked, %llu not modelled, %llu mismatches\n",
+               cluster_id_, core_id_, (unsigned long long)retired_, (unsigned long long)checked_,
+               (unsigned long long)unmodelled_, (unsigned long long)mismatches_);
+    }
+
+private:
+    // what the simulator expects from one instruction
+    struct Expect {
+        bool      modelled;
+        bool      next_known;
+        uint32_t  next_pc;
+        int       n_reg;
+        RegWrite  reg[2];
+        bool      mem;
+        bool      mem_we;
+        uint32_t  mem_addr;
+        int       mem_size;
+        bool      mem_signed;
+        uint32_t  mem_wdata;
+        uint32_t  load_rd;
+    };
+
+    uint32_t hwloop(uint32_t pc, uint32_t in, uint32_t len);
+    void execute(uint32_t pc, uint32_t in, uint32_t len, uint32_t seq, Expect &e);
+    bool compare(long long simtime, uint32_t cycle, uint32_t pc, uint32_t instr, Expect &e);
+    void mismatch(long long simtime, uint32_t cycle, uint32_t pc, uint32_t instr, const char *fmt, ...);
+    void unchecked(long long simtime, uint32_t cycle, uint32_t pc, uint32_t instr);
+
+    int       core_id_;
+    int       cluster_id_;
+    uint32_t  every_;
+    uint32_t  countdown_;
+    bool      in_region_;
+
+    uint32_t  x_[32];
+    uint32_t  lp_start_[2];
+    uint32_t  lp_end_[2];
+    uint32_t  lp_count_[2];
+
+    bool      next_known_;
+    uint32_t  next_pc_;
+    uint32_t  last_pc_;
+    uint32_t  last_instr_;
+
+    int       n_rtl_reg_;
+    RegWrite  rtl_reg_[2];
+    int       n_rtl_mem_;
+    MemAccess rtl_mem_[2];
+    bool      irq_;
+
+    uint64_t  retired_;
+    uint64_t  checked_;
+    uint64_t  unmodelled_;
+    uint64_t  mismatches_;
+};
+
+void Checker::mismatch(long long simtime, uint32_t cycle, uint32_t pc, uint32_t instr, const char *fmt, ...) {
+    if (mismatches_++ >= MAX_REPORTS) return;
+
+    char what[128];
+    va_list ap;
+    va_start(ap, fmt);
+    vsnprintf(what, sizeof(what), fmt, ap);
+    va_end(ap);
+    printf("[SIMCHECKER] core %02x_%x: time %lld, cycle %u, pc %08x, instr %08x: %s\n",
+           cluster_id_, core_id_, simtime, cycle, pc, instr, what);
+    if (mismatches_ == MAX_REPORTS)
+        printf("[SIMCHECKER] core %02x_%x: further mismatches are only counted\n", cluster_id_, core_id_);
+}
+
+void Checker::unchecked(long long simtime, uint32_t cycle, uint32_t pc, uint32_t instr) {
+    if (unmodelled_++ >= MAX_REPORTS) return;
+
+    printf("[SIMCHECKER] core %02x_%x: time %lld, cycle %u, pc %08x, instr %08x: not modelled, unchecked\n",
+           cluster_id_, core_id_, simtime, cycle, pc, instr);
+    if (unmodelled_ == MAX_REPORTS)
+        printf("[SIMCHECKER] core %02x_%x: further unchecked instructions are only counted\n",
+               cluster_id_, core_id_);
+}
+
+// Hardware loop registers, kept up to date for every instruction since the
+// loop back at the end address is part of the next pc of a checked one.
+// Returns the pc that follows when the instruction does not jump.
+uint32_t Checker::hwloop(uint32_t pc, uint32_t in, uint32_t len) {
+    uint32_t op = in & 0x7f;
+    uint32_t f3 = bits(in, 14, 12);
+    int      l  = bits(in, 7, 7);
+
+    if (op == 0x7b) {
+        uint32_t target = pc + (bits(in, 31, 20) << 1);
+        switch (f3) {
+        case 0: lp_start_[l] = target; break;                           // lp.starti
+        case 1: lp_end_[l]   = target; break;                           // lp.endi
+        case 2: lp_count_[l] = x_[bits(in, 19, 15)]; break;             // lp.count
+        case 3: lp_count_[l] = bits(in, 31, 20); break;                 // lp.counti
+        case 4:                                                         // lp.setup
+            lp_start_[l] = pc + 4;
+            lp_end_[l]   = target;
+            lp_count_[l] = x_[bits(in, 19, 15)];
+            break;
+        case 5:                                                         // lp.setupi
+            lp_start_[l] = pc + 4;
+            lp_end_[l]   = pc + (bits(in, 19, 15) << 1);
+            lp_count_[l] = bits(in, 31, 20);
+            break;
+        }
+    } else if (op == 0x73 && (f3 & 3) && (bits(in, 31, 20) & 0xff8) == 0x7b0) {
+        // csrrw/s/c on the loop registers at 0x7B0 + 4 * loop + {start, end, count}
+        uint32_t csr = bits(in, 31, 20);
+        int      i   = bits(csr, 2, 2);
+        uint32_t *r  = (csr & 3) == 0 ? &lp_start_[i] : (csr & 3) == 1 ? &lp_end_[i] :
+                       (csr & 3) == 2 ? &lp_count_[i] : nullptr;
+        uint32_t v   = (f3 & 4) ? bits(in, 19, 15) : x_[bits(in, 19, 15)];
+        if (r) {
+            switch (f3 & 3) {
+            case 1: *r  = v;  break;
+            case 2: *r |= v;  break;
+            case 3: *r &= ~v; break;
+            }
+        }
+    }
+
+    // the last instruction of a loop body jumps back while iterations remain,
+    // loop 0 has priority
+    for (int i = 0; i < 2; i++) {
+        if (pc == lp_end_[i] && lp_count_[i] >= 2) {
+            lp_count_[i]--;
+            return lp_start_[i];
+        }
+    }
+    return pc + len;
+}
+
+void Checker::execute(uint32_t pc, uint32_t in, uint32_t len, uint32_t seq, Expect &e) {
+    uint32_t op  = in & 0x7f;
+    uint32_t rd  = bits(in, 11, 7);
+    uint32_t rs1 = bits(in, 19, 15);
+    uint32_t rs2 = bits(in, 24, 20);
+    uint32_t f3  = bits(in, 14, 12);
+    uint32_t f7  = bits(in, 31, 25);
+    uint32_t a   = x_[rs1];
+    uint32_t b   = x_[rs2];
+    int32_t  imm_i = sext(bits(in, 31, 20), 12);
+    int32_t  imm_s = sext((f7 << 5) | rd, 12);
+    int32_t  imm_b = sext((bits(in, 31, 31) << 12) | (bits(in, 7, 7) << 11) | (bits(in, 30, 25) << 5) |
+                          (bits(in, 11, 8) << 1), 13);
+
+    e.modelled   = true;
+    e.next_known = true;
+    e.next_pc    = seq;
+    e.n_reg      = 0;
+    e.mem        = false;
+
+    auto wr = [&e](uint32_t r, uint32_t v) { e.reg[e.n_reg++] = { r, v }; };
+
+    switch (op) {
+    case 0x37: wr(rd, in & 0xfffff000); break;                                  // lui
+    case 0x17: wr(rd, pc + (in & 0xfffff000)); break;                           // auipc
+    case 0x6f:                                                                  // jal
+        wr(rd, pc + len);
+        e.next_pc = pc + sext((bits(in, 31, 31) << 20) | (bits(in, 19, 12) << 12) |
+                              (bits(in, 20, 20) << 11) | (bits(in, 30, 21) << 1), 21);
+        return;
+    case 0x67:                                                                  // jalr
+        wr(rd, pc + len);
+        e.next_pc = (a + imm_i) & ~1u;
+        return;
+
+    case 0x63: {                                                                // branches
+        bool t;
+        switch (f3) {
+        case 0: t = a == b; break;
+        case 1: t = a != b; break;
+        case 2: t = (int32_t)a == sext(rs2, 5); break;                          // p.beqimm
+        case 3: t = (int32_t)a != sext(rs2, 5); break;                          // p.bneimm
+        case 4: t = (int32_t)a <  (int32_t)b; break;
+        case 5: t = (int32_t)a >= (int32_t)b; break;
+        case 6: t = a <  b; break;
+        default: t = a >= b; break;
+        }
+        if (t) e.next_pc = pc + imm_b;
+        break;
+    }
+
+    case 0x03:                                                                  // loads
+    case 0x0b: {                                                                // post-increment loads
+        uint32_t off = imm_i;
+        e.mem_size   = 4;
+        e.mem_signed = !(f3 & 4);
+        switch (f3) {
+        case 0: case 4: e.mem_size = 1; break;
+        case 1: case 5: e.mem_size = 2; break;
+        case 2: case 6: break;                                                  // lw, p.elw
+        case 7:                                                                 // register offset
+            off          = b;
+            e.mem_signed = !bits(in, 30, 30);
+            e.mem_size   = 1 << bits(in, 29, 28);
+            break;
+        default:
+            e.modelled   = false;
+            e.next_known = false;
+            return;
+        }
+        e.mem      = true;
+        e.mem_we   = false;
+        e.mem_addr = op == 0x0b ? a : a + off;
+        e.load_rd  = rd;
+        if (op == 0x0b) wr(rs1, a + off);
+        break;
+    }
+
+    case 0x23:                                                                  // stores
+    case 0x2b: {                                                                // post-increment stores
+        uint32_t off = (f3 & 4) ? x_[rd] : (uint32_t)imm_s;
+        if ((f3 & 3) == 3) {
+            e.modelled   = false;
+            e.next_known = false;
+            return;
+        }
+        e.mem       = true;
+        e.mem_we    = true;
+        e.mem_size  = 1 << (f3 & 3);
+        e.mem_addr  = op == 0x2b ? a : a + off;
+        e.mem_wdata = b;
+        if (op == 0x2b) wr(rs1, a + off);
+        break;
+    }
+
+    case 0x13: {                                                                // register-immediate
+        uint32_t sh = rs2;
+        switch (f3) {
+        case 0: wr(rd, a + imm_i); break;
+        case 1: wr(rd, a << sh); break;
+        case 2: wr(rd, (int32_t)a < imm_i); break;
+        case 3: wr(rd, a < (uint32_t)imm_i); break;
+        case 4: wr(rd, a ^ imm_i); break;
+        case 5: wr(rd, (f7 & 0x20) ? (uint32_t)((int32_t)a >> sh) : a >> sh); break;
+        case 6: wr(rd, a | imm_i); break;
+        case 7: wr(rd, a & imm_i); break;
+        }
+        break;
+    }
+
+    case 0x33: {                                                                // register-register
+        int32_t  sa = a, sb = b;
+        uint32_t c  = x_[rd];
+        if (f7 & 0x40) {                                                        // bit manipulation
+            e.modelled = false;
+            break;
+        }
+        switch (((f7 & 0x3f) << 3) | f3) {
+        case 0x000: wr(rd, a + b); break;
+        case 0x100: wr(rd, a - b); break;
+        case 0x001: wr(rd, a << (b & 31)); break;
+        case 0x002: wr(rd, sa < sb); break;
+        case 0x003: wr(rd, a < b); break;
+        case 0x004: wr(rd, a ^ b); break;
+        case 0x005: wr(rd, a >> (b & 31)); break;
+        case 0x105: wr(rd, (uint32_t)(sa >> (b & 31))); break;
+        case 0x006: wr(rd, a | b); break;
+        case 0x007: wr(rd, a & b); break;
+
+        case 0x008: wr(rd, a * b); break;                                       // mul
+        case 0x009: wr(rd, (uint32_t)(((int64_t)sa * sb) >> 32)); break;        // mulh
+        case 0x00a: wr(rd, (uint32_t)(((int64_t)sa * (uint64_t)b) >> 32)); break;   // mulhsu
+        case 0x00b: wr(rd, (uint32_t)(((uint64_t)a * b) >> 32)); break;         // mulhu
+        case 0x00c:                                                             // div
+            wr(rd, b == 0 ? ~0u : (sa == INT32_MIN && sb == -1) ? a : (uint32_t)(sa / sb));
+            break;
+        case 0x00d: wr(rd, b == 0 ? ~0u : a / b); break;                        // divu
+        case 0x00e:                                                             // rem
+            wr(rd, b == 0 ? a : (sa == INT32_MIN && sb == -1) ? 0 : (uint32_t)(sa % sb));
+            break;
+        case 0x00f: wr(rd, b == 0 ? a : a % b); break;                          // remu
+        case 0x108: wr(rd, c + a * b); break;                                   // p.mac
+        case 0x109: wr(rd, c - a * b); break;                                   // p.msu
+
+        case 0x010: wr(rd, sa < 0 ? -a : a); break;                             // p.abs
+        case 0x012: wr(rd, sa <= sb); break;                                    // p.slet
+        case 0x013: wr(rd, a <= b); break;                                      // p.sletu
+        case 0x014: wr(rd, sa < sb ? a : b); break;                             // p.min
+        case 0x015: wr(rd, a < b ? a : b); break;                               // p.minu
+        case 0x016: wr(rd, sa > sb ? a : b); break;                             // p.max
+        case 0x017: wr(rd, a > b ? a : b); break;                               // p.maxu
+        case 0x025: wr(rd, (a >> (b & 31)) | (a << ((32 - (b & 31)) & 31))); break;  // p.ror
+        case 0x043: wr(rd, __builtin_popcount(a)); break;                       // p.cnt
+        case 0x044: wr(rd, (uint32_t)(int16_t)a); break;                        // p.exths
+        case 0x045: wr(rd, a & 0xffff); break;                                  // p.exthz
+        case 0x046: wr(rd, (uint32_t)(int8_t)a); break;                         // p.extbs
+        case 0x047: wr(rd, a & 0xff); break;                                    // p.extbz
+        default:    e.modelled = false; break;
+        }
+        break;
+    }
+
+    case 0x7b: break;                                                           // hardware loop setup
+
+    case 0x73:
+        if (f3 == 0) {                                                          // traps, mret, wfi
+            e.modelled   = false;
+            e.next_known = false;
+            return;
+        }
+        e.modelled = false;                                                     // CSR accesses
+        break;
+
+    case 0x57: {                                                                // OPCODE_VECOP
+        // funct3 is .h, .b, .n, .c, .sc.h, .sc.b, .sci.h, .sci.b
+        uint32_t f5   = bits(in, 31, 27);
+        bool     pair = bits(in, 26, 26);
+        int      lane = f3 == 2 ? 4 : f3 == 3 ? 2 : (f3 & 1) ? 8 : 16;
+        uint32_t vb   = b;
+        if (f3 & 4) {                                                           // scalar replication
+            uint32_t s = (f3 & 2) ? (uint32_t)sext((rs2 << 1) | bits(in, 25, 25), 6) : b;
+            vb = lane == 8 ? (s & 0xff) * 0x01010101u : (s & 0xffff) * 0x00010001u;
+        }
+
+        // pv.dotup/dotusp/dotsp, pv.sdotup/sdotusp/sdotsp and with bit 26 the
+        // 8 lane pv.sdot8*, which also read rs1+1 and rs2+1. Bit 26 is
+        // otherwise only set by the comparisons and only the dot products
+        // have nibble and crumb forms, the rest traps as in decoder.sv.
+        bool is_dot = f5 == 0x10 || f5 == 0x11 || f5 == 0x13 ||
+                      f5 == 0x14 || f5 == 0x15 || f5 == 0x17;
+        bool legal  = pair ? (f5 <= 0x09 && lane >= 8) || (is_dot && (f5 & 4) && f3 == 1)
+                           : is_dot || lane >= 8;
+        if (!legal) {
+            e.modelled   = false;
+            e.next_known = false;
+            return;
+        }
+        if (!is_dot) {
+            e.modelled = false;
+            break;
+        }
+        bool     sa = (f5 & 3) == 3;
+        bool     sb = (f5 & 3) != 0;
+        uint32_t v  = ((f5 & 4) ? x_[rd] : 0) + dot(a, vb, lane, sa, sb);
+        if (pair)
+            v += dot(x_[(rs1 + 1) & 31], x_[(rs2 + 1) & 31], 8, sa, sb);
+        wr(rd, v);
+        break;
+    }
+
+    case 0x77:                                                                  // OPCODE_COP
+        if (f7 != 0 || f3 > 2) {                                                // not an npu operation, traps
+            e.modelled   = false;
+            e.next_known = false;
+            return;
+        }
+        e.modelled = false;
+        break;
+
+    case 0x5b:                                                                  // OPCODE_PULP_OP
+        e.modelled = false;
+        break;
+
+    default:                                                                    // illegal, traps
+        e.modelled   = false;
+        e.next_known = false;
+        return;
+    }
+}
+
+// the data a load returns from the words the RTL read, misaligned loads read
+// two words
+static uint32_t load_value(const MemAccess *m, uint32_t addr, int size, bool sign) {
+    uint32_t v = 0;
+    for (int i = 0; i < size; i++) {
+        uint32_t lane = (addr & 3) + i;
+        uint32_t word = lane < 4 ? m[0].data : m[1].data;
+        v |= ((word >> (8 * (lane & 3))) & 0xff) << (8 * i);
+    }
+    return sign ? (uint32_t)sext(v, 8 * size) : v;
+}
+
+bool Checker::compare(long long simtime, uint32_t cycle, uint32_t pc, uint32_t instr, Expect &e) {
+    bool ok = true;
+
+    if (e.mem) {
+        uint32_t a     = e.mem_addr;
+        int      n     = ((a & 3) + e.mem_size > 4) ? 2 : 1;
+        bool     match = n_rtl_mem_ == n;
+        for (int i = 0; match && i < n; i++) {
+            match = rtl_mem_[i].we == e.mem_we &&
+                    (i == 0 ? rtl_mem_[i].addr == a : (rtl_mem_[i].addr & ~3u) == (a & ~3u) + 4);
+        }
+        if (!match) {
+            mismatch(simtime, cycle, pc, instr, "%s of %d bytes at %08x, RTL did %d accesses, first %s at %08x",
+                     e.mem_we ? "store" : "load", e.mem_size, a, n_rtl_mem_,
+                     n_rtl_mem_ ? (rtl_mem_[0].we ? "store" : "load") : "-", n_rtl_mem_ ? rtl_mem_[0].addr : 0);
+            return false;
+        }
+
+        if (e.mem_we) {
+            // the LSU rotates the register into the byte lanes of the address
+            uint32_t sh  = 8 * (a & 3);
+            uint32_t rot = sh ? (e.mem_wdata << sh) | (e.mem_wdata >> (32 - sh)) : e.mem_wdata;
+            for (int i = 0; i < e.mem_size; i++) {
+                uint32_t lane = (a & 3) + i;
+                uint32_t m    = 0xffu << (8 * (lane & 3));
+                if ((rtl_mem_[lane >> 2].data & m) != (rot & m)) {
+                    mismatch(simtime, cycle, pc, instr, "store data %08x at %08x, RTL wrote %08x",
+                             e.mem_wdata, a, rtl_mem_[lane >> 2].data);
+                    ok = false;
+                    break;
+                }
+            }
+        } else {
+            e.reg[e.n_reg++] = { e.load_rd, load_value(rtl_mem_, a, e.mem_size, e.mem_signed) };
+        }
+    } else if (n_rtl_mem_) {
+        mismatch(simtime, cycle, pc, instr, "unexpected %s at %08x",
+                 rtl_mem_[0].we ? "store" : "load", rtl_mem_[0].addr);
+        ok = false;
+    }
+
+    // writes to x0 are dropped on both sides
+    int n = 0;
+    for (int i = 0; i < e.n_reg; i++)
+        if (e.reg[i].addr) e.reg[n++] = e.reg[i];
+
+    if (n != n_rtl_reg_) {
+        mismatch(simtime, cycle, pc, instr, "%d register writes expected, RTL did %d (x%u = %08x)", n, n_rtl_reg_,
+                 n_rtl_reg_ ? rtl_reg_[0].addr : 0, n_rtl_reg_ ? rtl_reg_[0].value : 0);
+        return false;
+    }
+    for (int i = 0; i < n; i++) {
+        if (e.reg[i].addr != rtl_reg_[i].addr || e.reg[i].value != rtl_reg_[i].value) {
+            mismatch(simtime, cycle, pc, instr, "expected x%u = %08x, RTL wrote x%u = %08x",
+                     e.reg[i].addr, e.reg[i].value, rtl_reg_[i].addr, rtl_reg_[i].value);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+int Checker::step(long long simtime, uint32_t cycle, uint32_t pc, uint32_t instr) {
+    bool ok = true;
+
+    // the next pc of the previous instruction, unless an interrupt came in
+    if (next_known_ && !irq_ && pc != next_pc_) {
+        mismatch(simtime, cycle, last_pc_, last_instr_, "next pc %08x, RTL went to %08x", next_pc_, pc);
+        ok = false;
+    }
+
+    uint32_t len = (instr & 3) == 3 ? 4 : 2;
+    uint32_t in  = len == 4 ? instr : expand_rvc(instr & 0xffff);
+
+    if (in == MARK_BEGIN)
+        in_region_ = true;
+    else if (in == MARK_END)
+        in_region_ = false;
+
+    retired_++;
+    next_known_ = false;
+
+    uint32_t seq = hwloop(pc, in, len);
+
+    if (in_region_ && --countdown_ == 0) {
+        Expect e;
+        countdown_ = every_;
+
+        execute(pc, in, len, seq, e);
+
+        if (e.modelled) {
+            checked_++;
+            ok &= compare(simtime, cycle, pc, instr, e);
+        } else {
+            unchecked(simtime, cycle, pc, instr);
+        }
+        next_known_ = e.next_known;
+        next_pc_    = e.next_pc;
+        last_pc_    = pc;
+        last_instr_ = instr;
+    }
+
+    // follow the RTL, whether it agreed or not
+    for (int i = 0; i < n_rtl_reg_; i++)
+        x_[rtl_reg_[i].addr] = rtl_reg_[i].value;
+
+    n_rtl_reg_ = 0;
+    n_rtl_mem_ = 0;
+    irq_       = false;
+    return ok ? 0 : 1;
+}
+
+}  // namespace
+
+void *riscv_checker_init(int boot_addr, int core_id, int cluster_id) {
+    // the matches share one buffer, use each before asking for the next
+    const char *arg   = Verilated::commandArgsPlusMatch("simcheck");
+    bool        check = !strcmp(arg, "+simcheck") || !strncmp(arg, "+simcheck=", 10);
+    long        every = !strncmp(arg, "+simcheck=", 10) ? strtol(arg + 10, nullptr, 0) : 1;
+    bool        rgn   = !strcmp(Verilated::commandArgsPlusMatch("simregion"), "+simregion");
+    if (!check && !rgn) return nullptr;
+    if (every < 1) every = 1;
+
+    if (every == 1)
+        printf("[SIMCHECKER] core %02x_%x: checking every instruction%s\n",
+               cluster_id, core_id, rgn ? " in SIMCHECK regions" : "");
+    else
+        printf("[SIMCHECKER] core %02x_%x: checking 1 in %ld instructions%s\n",
+               cluster_id, core_id, every, rgn ? " in SIMCHECK regions" : "");
+    return new Checker(boot_addr, core_id, cluster_id, every, rgn);
+}
+
+int riscv_checker_step(void *cpu, long long simtime, int cycle, const svLogicVecVal *pc, const svLogicVecVal *instr) {
+    return static_cast<Checker *>(cpu)->step(simtime, cycle, pc->aval, instr->aval);
+}
+
+void riscv_checker_irq(void *cpu, int irq, int irq_no) {
+    (void)irq_no;
+    static_cast<Checker *>(cpu)->irq(irq != 0);
+}
+
+void riscv_checker_mem_access(void *cpu, int we, const svLogicVecVal *addr, const svLogicVecVal *data) {
+    static_cast<Checker *>(cpu)->mem_access(we != 0, addr->aval, data->aval);
+}
+
+void riscv_checker_reg_access(void *cpu, const svLogicVecVal *addr, const svLogicVecVal *data) {
+    static_cast<Checker *>(cpu)->reg_access(addr->aval & 31, data->aval);
+}
+
+void riscv_checker_final(void *cpu) {
+    Checker *c = static_cast<Checker *>(cpu);
+    c->report();
+    delete c;
+}
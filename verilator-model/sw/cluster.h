@@ -0,0 +1,67 @@
+// =============================================================
+// Cluster support: core id and event unit (event_unit.sv @ 0x700)
+// =============================================================
+
+#ifndef CLUSTER_H
+#define CLUSTER_H
+
+#include <stdint.h>
+
+#define EU_BASE         0x700
+#define EU_REG(off)     (*((volatile uint32_t*)(EU_BASE + (off))))
+#define EU_CORE_ID      EU_REG(0x00)
+#define EU_NUM_CORES    EU_REG(0x04)
+#define EU_BARRIER      EU_REG(0x08)
+#define EU_EVT_SEND     EU_REG(0x0C)
+#define EU_EVT_WAIT     EU_REG(0x10)
+#define EU_EVT_MASK     EU_REG(0x14)
+#define EU_IRQ_MASK     EU_REG(0x18)
+#define EU_PENDING      EU_REG(0x1C)
+#define EU_PENDING_SET  EU_REG(0x20)
+#define EU_SLEEP_CTRL   EU_REG(0x24)
+
+// Event unit sources, numbered like the core irq lines (top.sv IRQ_*)
+#define IRQ_LINE_DMA    16
+#define IRQ_LINE_NPU    17
+#define IRQ_LINE_IMC    18
+#define IRQ_LINE_TIMER  19
+#define EU_SRC_DMA      (1u << IRQ_LINE_DMA)
+#define EU_SRC_NPU      (1u << IRQ_LINE_NPU)
+#define EU_SRC_IMC      (1u << IRQ_LINE_IMC)
+#define EU_SRC_TIMER    (1u << IRQ_LINE_TIMER)
+
+// mhartid: [3:0] core id, [10:5] cluster id
+static inline int core_id(void) {
+    uint32_t id;
+    asm volatile ("csrr %0, 0xF14" : "=r"(id));
+    return id & 0xF;
+}
+
+static inline int num_cores(void) { return EU_NUM_CORES; }
+
+// Blocks until every core of the cluster has arrived
+static inline void cluster_barrier(void) { (void)EU_BARRIER; }
+
+// Raises an event on every core in mask
+static inline void cluster_notify(uint32_t mask) { EU_EVT_SEND = mask; }
+
+// Blocks until an event is pending for this core, returns the senders
+static inline uint32_t cluster_wait_event(void) { return EU_EVT_WAIT; }
+
+// mstatus.IE is bit 0 on this core
+static inline void irq_enable(void)  { asm volatile ("csrsi 0x300, 1"); }
+static inline void irq_disable(void) { asm volatile ("csrci 0x300, 1"); }
+
+// Sleeps in WFI (needs EU_SLEEP_CTRL = 1) until one of the sources in mask
+// is pending, then consumes it. Clear stale pending bits before starting
+// the operation that is waited for.
+static inline void eu_sleep_until(uint32_t mask) {
+    uint32_t evt = EU_EVT_MASK;
+    EU_EVT_MASK = evt | mask;
+    while (!(EU_PENDING & mask))
+        asm volatile ("wfi");
+    EU_PENDING  = mask;
+    EU_EVT_MASK = evt;
+}
+
+#endif
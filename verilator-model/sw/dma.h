@@ -0,0 +1,75 @@
+// =============================================================
+// DMA engine driver (dma_engine.sv @ 0x500)
+// =============================================================
+
+#ifndef DMA_H
+#define DMA_H
+
+#include <stdint.h>
+
+#define DMA_BASE        0x500
+#define DMA_REG(off)    (*((volatile uint32_t*)(DMA_BASE + (off))))
+#define DMA_SRC         DMA_REG(0x00)
+#define DMA_DST         DMA_REG(0x04)
+#define DMA_COUNT       DMA_REG(0x08)
+#define DMA_ROWS        DMA_REG(0x0C)
+#define DMA_SRC_STRIDE  DMA_REG(0x10)
+#define DMA_DST_STRIDE  DMA_REG(0x14)
+#define DMA_CTRL        DMA_REG(0x18)
+#define DMA_NEXT        DMA_REG(0x1C)
+#define DMA_STATUS      DMA_REG(0x20)
+#define DMA_START       DMA_REG(0x24)
+
+#define DMA_CTRL_SRC_INC   0x1
+#define DMA_CTRL_DST_INC   0x2
+#define DMA_CTRL_BYTE      0x4
+#define DMA_CTRL_IRQ_EN    0x8
+
+#define DMA_STATUS_BUSY    0x1
+#define DMA_STATUS_DONE    0x2
+
+#define DMA_START_REGS     0x1
+#define DMA_START_DESC     0x2
+
+// In-memory descriptor, same layout as the first eight registers
+typedef struct {
+    uint32_t src;
+    uint32_t dst;
+    uint32_t count;        // elements per row
+    uint32_t rows;         // 0 or 1 = 1-D
+    uint32_t src_stride;   // bytes between source row starts
+    uint32_t dst_stride;   // bytes between destination row starts
+    uint32_t ctrl;
+    uint32_t next;         // next descriptor, 0 ends the chain
+} __attribute__((aligned(4))) dma_desc_t;
+
+static inline void dma_start_2d(const void *src, void *dst, uint32_t count, uint32_t rows,
+                                uint32_t src_stride, uint32_t dst_stride, uint32_t ctrl) {
+    DMA_SRC        = (uint32_t)src;
+    DMA_DST        = (uint32_t)dst;
+    DMA_COUNT      = count;
+    DMA_ROWS       = rows;
+    DMA_SRC_STRIDE = src_stride;
+    DMA_DST_STRIDE = dst_stride;
+    DMA_CTRL       = ctrl;
+    DMA_NEXT       = 0;
+    DMA_START      = DMA_START_REGS;
+}
+
+static inline void dma_start_1d(const void *src, void *dst, uint32_t count, uint32_t ctrl) {
+    dma_start_2d(src, dst, count, 1, 0, 0, ctrl);
+}
+
+static inline void dma_start_chain(const dma_desc_t *first) {
+    DMA_NEXT  = (uint32_t)first;
+    DMA_START = DMA_START_DESC;
+}
+
+static inline int dma_busy(void) { return DMA_STATUS & DMA_STATUS_BUSY; }
+
+static inline void dma_wait(void) {
+    while (DMA_STATUS & DMA_STATUS_BUSY);
+    DMA_STATUS = DMA_STATUS_DONE;
+}
+
+#endif
@@ -5,6 +5,13 @@
 #include <stdio.h>
 #include <stdint.h>
 #include "mnist_weights_int8.h"
+#include "dma.h"
+#include "cluster.h"
+#include "timer.h"
+#include "perf.h"
+#include "xpulp.h"
+#include "npu.h"
+#include "simcheck.h"
 
 // --- Peripheral Base Addresses ---
 #define IMC_PROG_DATA   (*((volatile uint32_t*)0x400))
@@ -12,14 +19,78 @@
 #define IMC_V_INPUT_LO  (*((volatile uint32_t*)0x408))
 #define IMC_V_INPUT_HI  (*((volatile uint32_t*)0x40C))
 #define IMC_RESULT(i)   (*((volatile uint32_t*)(0x410 + (i)*4)))
-#define CYCLE_CTR       (*((volatile uint32_t*)0x300))
+#define IMC_INFO        (*((volatile uint32_t*)0x430))
+#define IMC_CTRL        (*((volatile uint32_t*)0x434))
+#define IMC_STATUS      (*((volatile uint32_t*)0x438))
+#define IMC_ACC_CLEAR   (*((volatile uint32_t*)0x43C))
+#define IMC_ACC(i)      (*((volatile uint32_t*)(0x440 + (i)*4)))
+#define IMC_DMA_SRC     (*((volatile uint32_t*)0x460))
+#define IMC_DMA_CTRL    (*((volatile uint32_t*)0x464))
 
-static inline uint32_t read_cycles() { return CYCLE_CTR; }
+#define IMC_CTRL_SERIAL     0x1
+#define IMC_CTRL_ACCUM      0x2
+#define IMC_CTRL_BITS(n)    ((uint32_t)(n) << 8)
+#define IMC_STATUS_SERIAL   0x1
+#define IMC_STATUS_DMA      0x2
+#define IMC_STATUS_ACCUM    0x4
+#define IMC_DMA_ROWS(n)     (((uint32_t)(n) & 0xF) << 4)
+
+// Interconnect statistics (top.sv BUSSTAT), masters: core, DMA, IMC loader
+#define BUS_STALL(m)    (*((volatile uint32_t*)(0x600 + (m)*4)))
+#define BUS_TXN(s)      (*((volatile uint32_t*)(0x620 + (s)*4)))
+#define BUS_LAT(s)      (*((volatile uint32_t*)(0x640 + (s)*4)))
+#define BUS_CLEAR       (*((volatile uint32_t*)0x600))
+#define BUS_SLAVE_RAM   0
+#define TCDM_CONFLICTS(b) (*((volatile uint32_t*)(0x660 + (b)*4)))
+#define TCDM_ACCESSES(b)  (*((volatile uint32_t*)(0x680 + (b)*4)))
+#define TCDM_BANKS      4
+#define ICACHE_HITS     (*((volatile uint32_t*)0x6A0))
+#define ICACHE_MISSES   (*((volatile uint32_t*)0x6A4))
+#define ICACHE_REFILL   (*((volatile uint32_t*)0x6A8))
+
+// Data placed in the banked scratchpad (uninitialised at boot)
+#define TCDM __attribute__((section(".tcdm")))
+
+static inline uint64_t read_cycles() { return timer_read(); }
+
+// Accumulates cycles, retired instructions and load-use stalls (PCCR,
+// counting must be on)
+typedef struct { uint64_t cycles; uint32_t instr; uint32_t ld_stall; } kernel_cost_t;
+#define KERNEL_COST(cost, call) do {                            \
+    uint32_t __i0 = PERF_CSR_READ(PCCR(PERF_INSTR));            \
+    uint32_t __s0 = PERF_CSR_READ(PCCR(PERF_LD_STALL));         \
+    uint64_t __t0 = read_cycles();                              \
+    call;                                                       \
+    (cost).cycles   += read_cycles() - __t0;                    \
+    (cost).instr    += PERF_CSR_READ(PCCR(PERF_INSTR)) - __i0;  \
+    (cost).ld_stall += PERF_CSR_READ(PCCR(PERF_LD_STALL)) - __s0; \
+} while (0)
 
 static int32_t hidden_acc[HIDDEN_SIZE];
+static int32_t cpu_hidden_acc[HIDDEN_SIZE];
 static int8_t  hidden_act[HIDDEN_SIZE] __attribute__((aligned(4)));
 static int32_t output_acc[OUTPUT_SIZE];
 
+// Bit-serial input precision, 0 = parallel 8-bit voltages
+static int imc_serial_bits = 0;
+
+// Number of 8x8 tiles written into the crossbar
+static uint32_t imc_tile_programs = 0;
+
+// Conductance-encoded (+128) 8x8 tiles, [row block][col block][16 words],
+// loaded into the crossbar by the controller's tile loader when imc_use_dma.
+// They live in the TCDM so the loader does not compete with core RAM traffic.
+#define IMC_TILES(rows, cols) ((((rows) + 7) / 8) * (((cols) + 7) / 8))
+static uint32_t w1_tiles[IMC_TILES(HIDDEN_SIZE, INPUT_SIZE)][16] TCDM;
+static uint32_t w2_tiles[IMC_TILES(OUTPUT_SIZE, HIDDEN_SIZE)][16] TCDM;
+static int imc_use_dma = 0;
+
+// Weight-stationary batch buffers, [image][neuron]
+#define IMC_BATCH_MAX NUM_TEST_IMAGES
+static int32_t batch_hidden_acc[IMC_BATCH_MAX][HIDDEN_SIZE];
+static int8_t  batch_hidden_act[IMC_BATCH_MAX][HIDDEN_SIZE] __attribute__((aligned(4)));
+static int32_t batch_output_acc[IMC_BATCH_MAX][OUTPUT_SIZE];
+
 // ==========================================
 // 1. Pure CPU Implementation
 // ==========================================
@@ -33,6 +104,49 @@ static void cpu_mv_u8(const int8_t *W, const uint8_t *inp, int32_t *out, int row
     }
 }
 
+// Row-parallel cpu_mv_u8 across the cluster. Core 0 posts the job and
+// wakes the other cores, every core takes a contiguous block of rows and
+// the barrier joins them.
+static struct {
+    const int8_t  *W;
+    const uint8_t *inp;
+    int32_t       *out;
+    int            rows, cols;
+} mv_job;
+
+static void cpu_mv_u8_part(int core, int ncores) {
+    int r0 = mv_job.rows * core / ncores;
+    int r1 = mv_job.rows * (core + 1) / ncores;
+    cpu_mv_u8(mv_job.W + r0 * mv_job.cols, mv_job.inp, mv_job.out + r0, r1 - r0, mv_job.cols);
+}
+
+static void cpu_mv_u8_parallel(const int8_t *W, const uint8_t *inp, int32_t *out, int rows, int cols) {
+    int ncores = num_cores();
+    if (ncores == 1) {
+        cpu_mv_u8(W, inp, out, rows, cols);
+        return;
+    }
+    mv_job.W    = W;
+    mv_job.inp  = inp;
+    mv_job.out  = out;
+    mv_job.rows = rows;
+    mv_job.cols = cols;
+    cluster_notify(((1u << ncores) - 1) & ~1u);
+    cpu_mv_u8_part(0, ncores);
+    cluster_barrier();
+}
+
+// Entry point of cores 1..N-1 (see startup.S)
+void cluster_worker(void) {
+    int id = core_id();
+    int ncores = num_cores();
+    while (1) {
+        cluster_wait_event();
+        cpu_mv_u8_part(id, ncores);
+        cluster_barrier();
+    }
+}
+
 static void cpu_mv_i8(const int8_t *W, const int8_t *inp, int32_t *out, int rows, int cols) {
     for (int r = 0; r < rows; r++) {
         int32_t acc = 0;
@@ -50,27 +164,84 @@ static int argmax(const int32_t *a, int n) {
     return best;
 }
 
-static int infer_cpu(const uint8_t *img) {
-    cpu_mv_u8(w1_int8, img, hidden_acc, HIDDEN_SIZE, INPUT_SIZE);
+// Bias, ReLU and requantization of hidden_acc into hidden_act
+static void hidden_activation(void) {
     for (int i = 0; i < HIDDEN_SIZE; i++) {
         int32_t v = hidden_acc[i] + b1_int32[i];
         if (v < 0) v = 0; 
         v /= H_DIV;
         hidden_act[i] = (v > 127) ? (int8_t)127 : (int8_t)v;
     }
+}
 
-    cpu_mv_i8(w2_int8, hidden_act, output_acc, OUTPUT_SIZE, HIDDEN_SIZE);
+// Same requantization with a mulhu by the reciprocal instead of the divide:
+// q = (v * M) >> (32 + S) with M = floor(2^(32+S) / H_DIV) is at most one
+// below v / H_DIV, one correction step makes it exact
+_Static_assert(H_DIV > 1, "REQ_S needs H_DIV > 1, use hidden_activation for H_DIV == 1");
+#define REQ_S  (31 - __builtin_clz(H_DIV - 1))
+#define REQ_M  ((uint32_t)((1ull << (32 + REQ_S)) / H_DIV))
+
+static void hidden_activation_mulh(void) {
+    for (int i = 0; i < HIDDEN_SIZE; i++) {
+        int32_t v = hidden_acc[i] + b1_int32[i];
+        if (v < 0) v = 0;
+        uint32_t q = (uint32_t)(((uint64_t)(uint32_t)v * REQ_M) >> 32) >> REQ_S;
+        if ((uint32_t)v - q * H_DIV >= H_DIV) q++;
+        hidden_act[i] = (q > 127) ? (int8_t)127 : (int8_t)q;
+    }
+}
+
+static int output_class(void) {
     for (int i = 0; i < OUTPUT_SIZE; i++) {
         output_acc[i] += b2_int32[i];
     }
     return argmax(output_acc, OUTPUT_SIZE);
 }
 
+static int infer_cpu(const uint8_t *img) {
+    cpu_mv_u8_parallel(w1_int8, img, hidden_acc, HIDDEN_SIZE, INPUT_SIZE);
+    hidden_activation();
+    cpu_mv_i8(w2_int8, hidden_act, output_acc, OUTPUT_SIZE, HIDDEN_SIZE);
+    return output_class();
+}
+
+// Same network with the Xpulp kernels on core 0
+static int infer_xpulp(const uint8_t *img) {
+    xpulp_mv_u8(w1_int8, img, hidden_acc, HIDDEN_SIZE, INPUT_SIZE);
+    hidden_activation();
+    xpulp_mv_i8(w2_int8, hidden_act, output_acc, OUTPUT_SIZE, HIDDEN_SIZE);
+    return output_class();
+}
+
 // ==========================================
 // 2. ReRAM IMC Implementation
 // ==========================================
-static void imc_tile_mac(const int8_t *W, int rows, int cols, const uint8_t *inp, int32_t *out, int r_start, int c_start) {
-    // Program Tile
+static void imc_pack_tiles(const int8_t *W, int rows, int cols, uint32_t (*tiles)[16]) {
+    for (int rs = 0; rs < rows; rs += 8) {
+        for (int cs = 0; cs < cols; cs += 8) {
+            uint8_t *t = (uint8_t*)*tiles++;
+            for (int r = 0; r < 8; r++) {
+                for (int c = 0; c < 8; c++) {
+                    int w_row = rs + r, w_col = cs + c;
+                    t[r*8 + c] = (w_row < rows && w_col < cols) ? (uint8_t)(W[w_row * cols + w_col] + 128) : 128;
+                }
+            }
+        }
+    }
+}
+
+// packed != NULL loads the pre-encoded tile with the controller's bus
+// master, otherwise the core writes every cell
+static void imc_program_tile(const int8_t *W, const uint32_t (*packed)[16], int rows, int cols, int r_start, int c_start) {
+    imc_tile_programs++;
+    if (packed) {
+        EU_PENDING   = EU_SRC_IMC;
+        IMC_DMA_SRC  = (uint32_t)packed[(r_start / 8) * ((cols + 7) / 8) + (c_start / 8)];
+        IMC_DMA_CTRL = IMC_DMA_ROWS(8);
+        eu_sleep_until(EU_SRC_IMC);
+        return;
+    }
+
     for (int r = 0; r < 8; r++) {
         int w_row = r_start + r;
         for (int c = 0; c < 8; c++) {
@@ -81,43 +252,101 @@ static void imc_tile_mac(const int8_t *W, int rows, int cols, const uint8_t *inp
             IMC_PROG_ADDR = (r * 8) + c;
         }
     }
+}
 
-    // Set Inputs
+// Applies one 8-wide input slice; the controller adds the result into its
+// row accumulators. Returns the input sum needed for the offset correction.
+static uint32_t imc_apply_input(const uint8_t *inp, int cols, int c_start) {
+    // Bit-serial mode only applies the top imc_serial_bits bits
+    uint8_t mask = imc_serial_bits ? (uint8_t)(0xFF << (8 - imc_serial_bits)) : 0xFF;
     uint8_t v[8] = {0};
     uint32_t sum_v = 0;
     for(int c = 0; c < 8; c++) {
         if((c_start + c) < cols) {
-            v[c] = inp[c_start + c];
+            v[c] = inp[c_start + c] & mask;
             sum_v += v[c];
         }
     }
     IMC_V_INPUT_LO = (v[0]) | (v[1] << 8) | (v[2] << 16) | (v[3] << 24);
     IMC_V_INPUT_HI = (v[4]) | (v[5] << 8) | (v[6] << 16) | (v[7] << 24);
-    
-    for(volatile int d=0; d<10; d++); // Hardware settle delay
 
-    // Read and Correct
+    if (imc_serial_bits)
+        while (IMC_STATUS & IMC_STATUS_SERIAL);   // Wait for the bit-plane sequence
+    else
+        while (IMC_STATUS & IMC_STATUS_ACCUM);    // Wait for the row accumulators
+    return sum_v;
+}
+
+// Read the accumulated row block once and remove the +128 conductance
+// offset of every tile that contributed to it
+static void imc_read_rows(int32_t *out, int rows, int r_start, uint32_t sum_v) {
     for (int r = 0; r < 8; r++) {
         int w_row = r_start + r;
-        if (w_row < rows) {
-            uint32_t raw_current = IMC_RESULT(r);
-            int32_t true_mac = (int32_t)raw_current - (128 * (int32_t)sum_v);
-            out[w_row] += true_mac;
+        if (w_row < rows)
+            out[w_row] = (int32_t)IMC_ACC(r) - (128 * (int32_t)sum_v);
+    }
+}
+
+static void imc_layer_execution(const int8_t *W, const uint32_t (*packed)[16], const uint8_t *inp, int32_t *out, int rows, int cols) {
+    for (int rs = 0; rs < rows; rs += 8) {
+        uint32_t sum_v = 0;
+        IMC_ACC_CLEAR = 1;
+        for (int cs = 0; cs < cols; cs += 8) {
+            imc_program_tile(W, packed, rows, cols, rs, cs);
+            sum_v += imc_apply_input(inp, cols, cs);
+        }
+        imc_read_rows(out, rows, rs, sum_v);
+    }
+}
+
+// Weight-stationary: every tile is programmed once and then evaluated for
+// all images of the batch. Per-image partial sums live in outs[batch][rows],
+// so the row accumulators are cleared before each evaluation and read back
+// as a single-tile result.
+static void imc_layer_batch(const int8_t *W, const uint32_t (*packed)[16], const uint8_t *const *inps, int32_t *outs, int batch, int rows, int cols) {
+    for (int i = 0; i < batch * rows; i++) outs[i] = 0;
+    for (int rs = 0; rs < rows; rs += 8) {
+        for (int cs = 0; cs < cols; cs += 8) {
+            imc_program_tile(W, packed, rows, cols, rs, cs);
+            for (int b = 0; b < batch; b++) {
+                int32_t *out = &outs[b * rows];
+                IMC_ACC_CLEAR = 1;
+                uint32_t sum_v = imc_apply_input(inps[b], cols, cs);
+                for (int r = 0; r < 8; r++) {
+                    int w_row = rs + r;
+                    if (w_row < rows)
+                        out[w_row] += (int32_t)IMC_ACC(r) - (128 * (int32_t)sum_v);
+                }
+            }
         }
     }
 }
 
-static void imc_layer_execution(const int8_t *W, const uint8_t *inp, int32_t *out, int rows, int cols) {
-    for (int r = 0; r < rows; r++) out[r] = 0;
-    for (int cs = 0; cs < cols; cs += 8) {
-        for (int rs = 0; rs < rows; rs += 8) {
-            imc_tile_mac(W, rows, cols, inp, out, rs, cs);
+static void infer_imc_batch(const uint8_t *const *imgs, int batch, int *preds) {
+    const uint8_t *acts[IMC_BATCH_MAX];
+
+    imc_layer_batch(w1_int8, imc_use_dma ? w1_tiles : NULL, imgs, &batch_hidden_acc[0][0], batch, HIDDEN_SIZE, INPUT_SIZE);
+    for (int b = 0; b < batch; b++) {
+        for (int i = 0; i < HIDDEN_SIZE; i++) {
+            int32_t v = batch_hidden_acc[b][i] + b1_int32[i];
+            if (v < 0) v = 0;
+            v /= H_DIV;
+            batch_hidden_act[b][i] = (v > 127) ? (int8_t)127 : (int8_t)v;
+        }
+        acts[b] = (const uint8_t*)batch_hidden_act[b];
+    }
+
+    imc_layer_batch(w2_int8, imc_use_dma ? w2_tiles : NULL, acts, &batch_output_acc[0][0], batch, OUTPUT_SIZE, HIDDEN_SIZE);
+    for (int b = 0; b < batch; b++) {
+        for (int i = 0; i < OUTPUT_SIZE; i++) {
+            batch_output_acc[b][i] += b2_int32[i];
         }
+        preds[b] = argmax(batch_output_acc[b], OUTPUT_SIZE);
     }
 }
 
 static int infer_imc(const uint8_t *img) {
-    imc_layer_execution(w1_int8, img, hidden_acc, HIDDEN_SIZE, INPUT_SIZE);
+    imc_layer_execution(w1_int8, imc_use_dma ? w1_tiles : NULL, img, hidden_acc, HIDDEN_SIZE, INPUT_SIZE);
     for (int i = 0; i < HIDDEN_SIZE; i++) {
         int32_t v = hidden_acc[i] + b1_int32[i];
         if (v < 0) v = 0; 
@@ -125,25 +354,200 @@ static int infer_imc(const uint8_t *img) {
         hidden_act[i] = (v > 127) ? (int8_t)127 : (int8_t)v;
     }
 
-    imc_layer_execution(w2_int8, (const uint8_t*)hidden_act, output_acc, OUTPUT_SIZE, HIDDEN_SIZE);
+    imc_layer_execution(w2_int8, imc_use_dma ? w2_tiles : NULL, (const uint8_t*)hidden_act, output_acc, OUTPUT_SIZE, HIDDEN_SIZE);
     for (int i = 0; i < OUTPUT_SIZE; i++) {
         output_acc[i] += b2_int32[i];
     }
     return argmax(output_acc, OUTPUT_SIZE);
 }
 
+// ==========================================
+// 3. Interrupts
+// ==========================================
+static volatile uint32_t irq_count[32];
+
+// Timer-driven sampling: the timer ISR counts samples per phase
+enum { PHASE_IDLE, PHASE_CPU, PHASE_IMC, PHASE_COUNT };
+static volatile int      profile_phase = PHASE_IDLE;
+static volatile uint32_t profile_samples[PHASE_COUNT];
+#define PROFILE_PERIOD 997
+
+// Event sampling: a perf counter overflow records the interrupted PC, the
+// first PC_SAMPLE_SLOTS distinct PCs get their own bin
+#define PC_SAMPLE_PERIOD 101
+#define PC_SAMPLE_SLOTS  8
+static volatile uint32_t pc_sample_pc[PC_SAMPLE_SLOTS];
+static volatile uint32_t pc_sample_cnt[PC_SAMPLE_SLOTS];
+static volatile uint32_t pc_sample_other;
+
+static void pc_sample(uint32_t pc) {
+    for (int i = 0; i < PC_SAMPLE_SLOTS; i++) {
+        if (pc_sample_cnt[i] == 0) pc_sample_pc[i] = pc;
+        if (pc_sample_pc[i] == pc) { pc_sample_cnt[i]++; return; }
+    }
+    pc_sample_other++;
+}
+
+void trap_handler(uint32_t mcause, uint32_t mepc) {
+    if (!(mcause & 0x80000000u)) {
+        printf("Unhandled exception %u at 0x%x\n", (unsigned)(mcause & 0x1F), (unsigned)mepc);
+        while (1);
+    }
+    uint32_t line = mcause & 0x1F;
+    // Level sources are cleared at the source before the pending bit
+    if (line == IRQ_LINE_DMA) DMA_STATUS = DMA_STATUS_DONE;
+    if (line == PERF_IRQ_LINE) {
+        perf_overflow_ack();
+        pc_sample(mepc);
+    }
+    EU_PENDING = 1u << line;
+    irq_count[line]++;
+    if (line == IRQ_LINE_TIMER) profile_samples[profile_phase]++;
+}
+
+// Sleeps until the interrupt on line has been taken since irq_count[line]
+// was seen. IE stays clear around the check, WFI still wakes on the
+// pending source and the interrupt is taken once IE is set again.
+static void wait_irq(int line, uint32_t seen) {
+    irq_disable();
+    while (irq_count[line] == seen) {
+        asm volatile ("wfi");
+        irq_enable();
+        irq_disable();
+    }
+    irq_enable();
+}
+
+// ==========================================
+// 4. DMA Self-Test
+// ==========================================
+static uint8_t  dma_patch[8 * 8] __attribute__((aligned(4)));
+static uint32_t dma_words[8 + OUTPUT_SIZE];
+static dma_desc_t dma_chain[2];
+
+// 2-D byte copy of an 8x8 image patch, then a two-descriptor word chain
+static int dma_self_test(void) {
+    int errors = 0;
+
+    // First transfer completes by interrupt
+    uint32_t seen = irq_count[IRQ_LINE_DMA];
+    dma_start_2d(&test_images[0][10 * 28 + 10], dma_patch, 8, 8, 28, 8,
+                 DMA_CTRL_SRC_INC | DMA_CTRL_DST_INC | DMA_CTRL_BYTE | DMA_CTRL_IRQ_EN);
+    wait_irq(IRQ_LINE_DMA, seen);
+    for (int r = 0; r < 8; r++)
+        for (int c = 0; c < 8; c++)
+            if (dma_patch[r*8 + c] != test_images[0][(10 + r) * 28 + 10 + c]) errors++;
+
+    dma_chain[0] = (dma_desc_t){ (uint32_t)w2_int8, (uint32_t)&dma_words[0], 8, 1, 0, 0,
+                                 DMA_CTRL_SRC_INC | DMA_CTRL_DST_INC, (uint32_t)&dma_chain[1] };
+    dma_chain[1] = (dma_desc_t){ (uint32_t)b2_int32, (uint32_t)&dma_words[8], OUTPUT_SIZE, 1, 0, 0,
+                                 DMA_CTRL_SRC_INC | DMA_CTRL_DST_INC, 0 };
+    dma_start_chain(&dma_chain[0]);
+    dma_wait();
+    for (int i = 0; i < 8; i++)
+        if (dma_words[i] != ((const uint32_t*)w2_int8)[i]) errors++;
+    for (int i = 0; i < OUTPUT_SIZE; i++)
+        if ((int32_t)dma_words[8 + i] != b2_int32[i]) errors++;
+
+    return errors;
+}
+
+// The dot product kernels against C on operands that use every byte,
+// nibble and crumb lane and both signs, so a wrong instruction encoding
+// shows up as a failure instead of as a few percent of accuracy
+static uint8_t dot_x[32] __attribute__((aligned(4)));
+static int8_t  dot_w[32] __attribute__((aligned(4)));
+
+// packed operands as in mnist_test.py: lane i of a word is bits
+// [bits*i +: bits], inputs unsigned, weights signed
+#define PACK_ROWS  3
+#define PACK_WORDS 2
+static uint32_t pack_x[PACK_WORDS];
+static uint32_t pack_w[PACK_ROWS * PACK_WORDS];
+static int32_t  pack_out[PACK_ROWS];
+
+static int32_t packed_ref(const uint32_t *x, const uint32_t *w, int words, int bits) {
+    int32_t acc = 0;
+    uint32_t mask = (1u << bits) - 1;
+    for (int c = 0; c < words; c++)
+        for (int i = 0; i < 32 / bits; i++) {
+            int32_t xl = (x[c] >> (bits * i)) & mask;
+            int32_t wl = (w[c] >> (bits * i)) & mask;
+            if (wl & (1 << (bits - 1))) wl -= 1 << bits;
+            acc += xl * wl;
+        }
+    return acc;
+}
+
+static int xpulp_self_test(void) {
+    int errors = 0;
+
+    for (int i = 0; i < 32; i++) {
+        dot_x[i] = (uint8_t)(i * 37 + 11);
+        dot_w[i] = (int8_t)(i * 53 - 97);
+    }
+    for (int n8 = 1; n8 <= 4; n8++) {
+        int32_t ref_u = 5, ref_i = 5;
+        for (int i = 0; i < 8 * n8; i++) {
+            ref_u += (int32_t)dot_x[i] * dot_w[i];
+            ref_i += (int32_t)(int8_t)dot_x[i] * dot_w[i];
+        }
+        if (xpulp_dot8p_u8(dot_x, dot_w, n8, 5) != ref_u) errors++;
+        if (xpulp_dot8p_i8((const int8_t *)dot_x, dot_w, n8, 5) != ref_i) errors++;
+        if (xpulp_dot8_u8(dot_x, dot_w, n8, 5) != ref_u) errors++;
+        if (xpulp_dot8_i8((const int8_t *)dot_x, dot_w, n8, 5) != ref_i) errors++;
+    }
+
+    for (int c = 0; c < PACK_WORDS; c++)
+        pack_x[c] = 0x9E3779B9u * (c + 1);
+    for (int i = 0; i < PACK_ROWS * PACK_WORDS; i++)
+        pack_w[i] = (0x85EBCA6Bu * (i + 3)) ^ (0x0F0F0F0Fu * i);
+    for (int bits = 4; bits >= 2; bits -= 2) {
+        if ((bits == 4 ? xpulp_sdotusp_n(5, pack_x[0], pack_w[0])
+                       : xpulp_sdotusp_c(5, pack_x[0], pack_w[0])) !=
+            5 + packed_ref(pack_x, pack_w, 1, bits)) errors++;
+        xpulp_mv_packed(pack_w, pack_x, pack_out, PACK_ROWS, PACK_WORDS, bits);
+        for (int r = 0; r < PACK_ROWS; r++)
+            if (pack_out[r] != packed_ref(pack_x, pack_w + r * PACK_WORDS, PACK_WORDS, bits))
+                errors++;
+    }
+
+    return errors;
+}
+
 // ==========================================
 // Main Execution
 // ==========================================
 int main(void) {
     printf("\n========================================================\n");
     printf(" CPU vs ReRAM IMC (8x8) Inference Benchmark\n");
-    printf("========================================================\n\n");
+    printf("========================================================\n");
+
+    uint32_t imc_info = IMC_INFO;
+    if ((imc_info & 0xFF) == 0)
+        printf(" IMC model: ideal\n");
+    else
+        printf(" IMC model: behavioral, ADC %u bits\n", (unsigned)((imc_info >> 8) & 0xFF));
+    printf(" Cores: %d\n\n", num_cores());
+    IMC_CTRL = IMC_CTRL_ACCUM;
+    EU_SLEEP_CTRL = 1;
+    EU_IRQ_MASK   = EU_SRC_DMA;
+    irq_enable();
+    imc_pack_tiles(w1_int8, HIDDEN_SIZE, INPUT_SIZE, w1_tiles);
+    imc_pack_tiles(w2_int8, OUTPUT_SIZE, HIDDEN_SIZE, w2_tiles);
 
-    uint32_t total_cpu_cycles = 0;
-    uint32_t total_imc_cycles = 0;
+    BUS_CLEAR = 0;
+    int dma_errors = dma_self_test();
+    printf(" DMA self-test: %s (%d errors)\n", dma_errors ? "FAIL" : "PASS", dma_errors);
+    int dot_errors = xpulp_self_test();
+    printf(" Xpulp dot product self-test: %s (%d errors)\n\n", dot_errors ? "FAIL" : "PASS", dot_errors);
+
+    uint64_t run_t0 = read_cycles();
+    uint64_t total_cpu_cycles = 0;
+    uint64_t total_imc_cycles = 0;
     int cpu_correct = 0;
     int imc_correct = 0;
+    uint32_t total_l1_err = 0;
 
     printf("%-5s | %-5s | %-12s | %-12s | %-8s\n", "Image", "Label", "CPU Cycles", "IMC Cycles", "Match?");
     printf("--------------------------------------------------------\n");
@@ -151,15 +555,24 @@ int main(void) {
     for (int d = 0; d < NUM_TEST_IMAGES; d++) {
         int label = test_labels[d];
 
-        // CPU Inference
-        uint32_t t0 = read_cycles();
+        // CPU Inference, the region +simregion checks
+        uint64_t t0 = read_cycles();
+        SIMCHECK_BEGIN();
         int pred_cpu = infer_cpu(test_images[d]);
-        uint32_t cpu_cyc = read_cycles() - t0;
+        SIMCHECK_END();
+        uint32_t cpu_cyc = (uint32_t)(read_cycles() - t0);
+        for (int i = 0; i < HIDDEN_SIZE; i++) cpu_hidden_acc[i] = hidden_acc[i];
         
         // IMC Inference
         t0 = read_cycles();
         int pred_imc = infer_imc(test_images[d]);
-        uint32_t imc_cyc = read_cycles() - t0;
+        uint32_t imc_cyc = (uint32_t)(read_cycles() - t0);
+
+        // Layer 1 deviation of the crossbar from exact integer math
+        for (int i = 0; i < HIDDEN_SIZE; i++) {
+            int32_t e = hidden_acc[i] - cpu_hidden_acc[i];
+            total_l1_err += (e < 0) ? -e : e;
+        }
 
         total_cpu_cycles += cpu_cyc;
         total_imc_cycles += imc_cyc;
@@ -176,8 +589,233 @@ int main(void) {
     printf("\nRESULTS:\n");
     printf("  CPU Accuracy: %d/10\n", cpu_correct);
     printf("  IMC Accuracy: %d/10\n", imc_correct);
-    printf("  Avg CPU Cycles: %u\n", total_cpu_cycles / 10);
-    printf("  Avg IMC Cycles: %u\n", total_imc_cycles / 10);
+    printf("  Total CPU Cycles: %llu\n", (unsigned long long)total_cpu_cycles);
+    printf("  Total IMC Cycles: %llu\n", (unsigned long long)total_imc_cycles);
+    printf("  Avg CPU Cycles: %llu\n", (unsigned long long)(total_cpu_cycles / NUM_TEST_IMAGES));
+    printf("  Avg IMC Cycles: %llu\n", (unsigned long long)(total_imc_cycles / NUM_TEST_IMAGES));
+    printf("  IMC Layer1 mean |error|: %u\n", total_l1_err / (NUM_TEST_IMAGES * HIDDEN_SIZE));
+    printf("  IMC Tiles Programmed: %u\n", imc_tile_programs);
+    printf("\n========================================================\n\n");
+
+    // Scalar vs Xpulp GEMV kernels on both layers, single core
+    static int32_t sc_out[HIDDEN_SIZE], xp_out[HIDDEN_SIZE];
+    kernel_cost_t sc_cost[2] = { 0 }, xp4_cost[2] = { 0 }, xp_cost[2] = { 0 };
+    int xp_mismatch = 0, xp_correct = 0;
+    uint64_t xp_infer_cyc = 0;
+    perf_start(PERF_ALL);
+    for (int d = 0; d < NUM_TEST_IMAGES; d++) {
+        uint64_t t0 = read_cycles();
+        if (infer_xpulp(test_images[d]) == test_labels[d]) xp_correct++;
+        xp_infer_cyc += read_cycles() - t0;
+
+        KERNEL_COST(sc_cost[0], cpu_mv_u8(w1_int8, test_images[d], sc_out, HIDDEN_SIZE, INPUT_SIZE));
+        KERNEL_COST(xp4_cost[0], xpulp_mv4_u8(w1_int8, test_images[d], xp_out, HIDDEN_SIZE, INPUT_SIZE));
+        for (int i = 0; i < HIDDEN_SIZE; i++) xp_mismatch += sc_out[i] != xp_out[i];
+        KERNEL_COST(xp_cost[0], xpulp_mv_u8(w1_int8, test_images[d], xp_out, HIDDEN_SIZE, INPUT_SIZE));
+        for (int i = 0; i < HIDDEN_SIZE; i++) xp_mismatch += sc_out[i] != xp_out[i];
+
+        KERNEL_COST(sc_cost[1], cpu_mv_i8(w2_int8, hidden_act, sc_out, OUTPUT_SIZE, HIDDEN_SIZE));
+        KERNEL_COST(xp4_cost[1], xpulp_mv4_i8(w2_int8, hidden_act, xp_out, OUTPUT_SIZE, HIDDEN_SIZE));
+        for (int i = 0; i < OUTPUT_SIZE; i++) xp_mismatch += sc_out[i] != xp_out[i];
+        KERNEL_COST(xp_cost[1], xpulp_mv_i8(w2_int8, hidden_act, xp_out, OUTPUT_SIZE, HIDDEN_SIZE));
+        for (int i = 0; i < OUTPUT_SIZE; i++) xp_mismatch += sc_out[i] != xp_out[i];
+    }
+    perf_stop();
+
+    static const char *const layer_names[2] = { "Layer 1 (u8 x i8, 32x784)", "Layer 2 (i8 x i8, 10x32)" };
+    printf("Xpulp GEMV kernels vs scalar (avg per image)\n");
+    for (int l = 0; l < 2; l++) {
+        printf("  %s: scalar %llu cycles / %u instr, xpulp %llu cycles / %u instr, %llux\n",
+               layer_names[l],
+               (unsigned long long)(sc_cost[l].cycles / NUM_TEST_IMAGES), (unsigned)(sc_cost[l].instr / NUM_TEST_IMAGES),
+               (unsigned long long)(xp_cost[l].cycles / NUM_TEST_IMAGES), (unsigned)(xp_cost[l].instr / NUM_TEST_IMAGES),
+               (unsigned long long)(xp_cost[l].cycles ? sc_cost[l].cycles / xp_cost[l].cycles : 0));
+        printf("    4 lane sdot: %llu cycles / %u instr\n",
+               (unsigned long long)(xp4_cost[l].cycles / NUM_TEST_IMAGES), (unsigned)(xp4_cost[l].instr / NUM_TEST_IMAGES));
+        // compare against a LOAD_FWD=0 build (obj_dir_nofwd) to see the
+        // forwarded hazards; loads feeding addresses or the sdot8 register
+        // pairs stall in both builds
+        printf("    load-use stalls: scalar %u, 4 lane sdot %u, xpulp %u\n",
+               (unsigned)(sc_cost[l].ld_stall / NUM_TEST_IMAGES), (unsigned)(xp4_cost[l].ld_stall / NUM_TEST_IMAGES),
+               (unsigned)(xp_cost[l].ld_stall / NUM_TEST_IMAGES));
+    }
+    printf("  Mismatching outputs: %d\n", xp_mismatch);
+    printf("  Xpulp inference: %d/10, avg %llu cycles\n", xp_correct,
+           (unsigned long long)(xp_infer_cyc / NUM_TEST_IMAGES));
+    printf("\n========================================================\n\n");
+
+    // NPU tiles on layer 1, bus accesses vs coprocessor instructions
+    kernel_cost_t npu_mmio = { 0 }, npu_insn = { 0 };
+    int npu_mismatch = 0;
+    perf_start(PERF_ALL);
+    for (int d = 0; d < NUM_TEST_IMAGES; d++) {
+        cpu_mv_u8(w1_int8, test_images[d], sc_out, HIDDEN_SIZE, INPUT_SIZE);
+        KERNEL_COST(npu_mmio, npu_mv_mmio(w1_int8, test_images[d], xp_out, HIDDEN_SIZE, INPUT_SIZE));
+        for (int i = 0; i < HIDDEN_SIZE; i++) npu_mismatch += sc_out[i] != xp_out[i];
+        KERNEL_COST(npu_insn, npu_mv_insn(w1_int8, test_images[d], xp_out, HIDDEN_SIZE, INPUT_SIZE));
+        for (int i = 0; i < HIDDEN_SIZE; i++) npu_mismatch += sc_out[i] != xp_out[i];
+    }
+    perf_stop();
+    printf("NPU GEMV, %s (avg per image)\n", layer_names[0]);
+    printf("  MMIO: %llu cycles / %u instr, instructions: %llu cycles / %u instr\n",
+           (unsigned long long)(npu_mmio.cycles / NUM_TEST_IMAGES), (unsigned)(npu_mmio.instr / NUM_TEST_IMAGES),
+           (unsigned long long)(npu_insn.cycles / NUM_TEST_IMAGES), (unsigned)(npu_insn.instr / NUM_TEST_IMAGES));
+    printf("  Mismatching outputs: %d\n", npu_mismatch);
+    printf("\n========================================================\n\n");
+
+    // Hidden layer requantization epilogue, divide vs mulhu
+    kernel_cost_t rq_div = { 0 }, rq_mulh = { 0 };
+    int rq_mismatch = 0;
+    int8_t rq_ref[HIDDEN_SIZE];
+    perf_start(PERF_ALL);
+    for (int d = 0; d < NUM_TEST_IMAGES; d++) {
+        xpulp_mv_u8(w1_int8, test_images[d], hidden_acc, HIDDEN_SIZE, INPUT_SIZE);
+        KERNEL_COST(rq_div, hidden_activation());
+        for (int i = 0; i < HIDDEN_SIZE; i++) rq_ref[i] = hidden_act[i];
+        KERNEL_COST(rq_mulh, hidden_activation_mulh());
+        for (int i = 0; i < HIDDEN_SIZE; i++) rq_mismatch += rq_ref[i] != hidden_act[i];
+    }
+    perf_stop();
+    printf("Requantization (avg per image, %d neurons)\n", HIDDEN_SIZE);
+    printf("  divide: %llu cycles, mulhu: %llu cycles, mismatches: %d\n",
+           (unsigned long long)(rq_div.cycles / NUM_TEST_IMAGES),
+           (unsigned long long)(rq_mulh.cycles / NUM_TEST_IMAGES), rq_mismatch);
+    printf("\n========================================================\n\n");
+
+    // Weight-stationary batch over all test images
+    int batch_preds[IMC_BATCH_MAX];
+    int batch_correct = 0;
+    imc_tile_programs = 0;
+    uint64_t t0 = read_cycles();
+    infer_imc_batch(test_images, NUM_TEST_IMAGES, batch_preds);
+    uint64_t batch_cyc = read_cycles() - t0;
+    for (int d = 0; d < NUM_TEST_IMAGES; d++)
+        if (batch_preds[d] == test_labels[d]) batch_correct++;
+
+    printf("Weight-stationary IMC batch (%d images)\n", NUM_TEST_IMAGES);
+    printf("  Accuracy: %d/10\n", batch_correct);
+    printf("  Avg Cycles/Image: %llu\n", (unsigned long long)(batch_cyc / NUM_TEST_IMAGES));
+    printf("  Tiles Programmed: %u\n", imc_tile_programs);
+    printf("\n========================================================\n\n");
+
+    // Per-image IMC with tiles loaded by the controller's bus master
+    uint64_t dma_cyc = 0;
+    int dma_correct = 0;
+    imc_use_dma = 1;
+    for (int d = 0; d < NUM_TEST_IMAGES; d++) {
+        t0 = read_cycles();
+        if (infer_imc(test_images[d]) == test_labels[d]) dma_correct++;
+        dma_cyc += read_cycles() - t0;
+    }
+    imc_use_dma = 0;
+
+    printf("IMC with DMA tile loading\n");
+    printf("  Accuracy: %d/10\n", dma_correct);
+    printf("  Avg Cycles/Image: %llu\n", (unsigned long long)(dma_cyc / NUM_TEST_IMAGES));
+    printf("\n========================================================\n\n");
+
+    // Bit-serial latency/precision sweep
+    printf("Bit-serial IMC sweep\n");
+    printf("%-5s | %-8s | %-12s\n", "Bits", "Accuracy", "Avg Cycles");
+    printf("--------------------------------\n");
+    for (int bits = 8; bits >= 1; bits--) {
+        uint64_t total_cyc = 0;
+        int correct = 0;
+        imc_serial_bits = bits;
+        IMC_CTRL = IMC_CTRL_ACCUM | IMC_CTRL_SERIAL | IMC_CTRL_BITS(bits);
+        for (int d = 0; d < NUM_TEST_IMAGES; d++) {
+            uint64_t t0 = read_cycles();
+            if (infer_imc(test_images[d]) == test_labels[d]) correct++;
+            total_cyc += read_cycles() - t0;
+        }
+        printf("  %d   |  %2d/10   | %-12llu\n", bits, correct, (unsigned long long)(total_cyc / NUM_TEST_IMAGES));
+    }
+    imc_serial_bits = 0;
+    IMC_CTRL = IMC_CTRL_ACCUM;
+    printf("\n========================================================\n\n");
+
+    // Timer-sampled profile of one more pass over the test images
+    static const char *const phase_names[PHASE_COUNT] = { "Other", "CPU", "IMC" };
+    uint64_t phase_cyc[PHASE_COUNT] = { 0 };
+    for (int p = 0; p < PHASE_COUNT; p++) profile_samples[p] = 0;
+    EU_IRQ_MASK = EU_SRC_DMA | EU_SRC_TIMER;
+    timer_set_compare(read_cycles() + PROFILE_PERIOD, PROFILE_PERIOD);
+    for (int d = 0; d < NUM_TEST_IMAGES; d++) {
+        uint64_t t0 = read_cycles();
+        profile_phase = PHASE_CPU;
+        infer_cpu(test_images[d]);
+        uint64_t t1 = read_cycles();
+        profile_phase = PHASE_IMC;
+        infer_imc(test_images[d]);
+        profile_phase = PHASE_IDLE;
+        phase_cyc[PHASE_CPU] += t1 - t0;
+        phase_cyc[PHASE_IMC] += read_cycles() - t1;
+    }
+    timer_stop();
+    EU_IRQ_MASK = EU_SRC_DMA;
+    EU_PENDING  = EU_SRC_TIMER;
+
+    printf("Timer-sampled profile (period %d cycles)\n", PROFILE_PERIOD);
+    for (int p = PHASE_CPU; p < PHASE_COUNT; p++)
+        printf("  %-3s: %u samples, ~%llu cycles (measured %llu)\n", phase_names[p],
+               (unsigned)profile_samples[p], (unsigned long long)profile_samples[p] * PROFILE_PERIOD,
+               (unsigned long long)phase_cyc[p]);
+    printf("\n========================================================\n\n");
+
+    // Core performance counters around one CPU and one IMC inference
+    perf_snapshot_t p0, p1, pd;
+    perf_start(PERF_ALL);
+    perf_snapshot(&p0);
+    infer_cpu(test_images[0]);
+    perf_snapshot(&p1);
+    perf_diff(&pd, &p0, &p1);
+    perf_print("Performance counters, CPU inference (core 0)", &pd);
+    imc_use_dma = 1;
+    perf_snapshot(&p0);
+    infer_imc(test_images[0]);
+    perf_snapshot(&p1);
+    imc_use_dma = 0;
+    perf_stop();
+    perf_diff(&pd, &p0, &p1);
+    perf_print("Performance counters, IMC inference with DMA tile loading", &pd);
+    printf("\n========================================================\n\n");
+
+    // Load-sampled profile of the CPU inferences
+    perf_start(PERF_ALL);
+    PERF_SAMPLE_START(PERF_LD, PC_SAMPLE_PERIOD);
+    for (int d = 0; d < NUM_TEST_IMAGES; d++)
+        infer_cpu(test_images[d]);
+    PERF_SAMPLE_STOP(PERF_LD);
+    uint64_t smp_cycles = PERF_READ64(PERF_CYCLES);
+    uint64_t smp_instr  = PERF_READ64(PERF_INSTR);
+    perf_stop();
+
+    printf("Load-sampled profile, CPU inference (every %d loads)\n", PC_SAMPLE_PERIOD);
+    for (int i = 0; i < PC_SAMPLE_SLOTS && pc_sample_cnt[i]; i++)
+        printf("  pc 0x%05x: %u samples\n", (unsigned)pc_sample_pc[i], (unsigned)pc_sample_cnt[i]);
+    printf("  other pcs: %u samples\n", (unsigned)pc_sample_other);
+    printf("  %llu cycles, %llu instructions\n", (unsigned long long)smp_cycles,
+           (unsigned long long)smp_instr);
+    printf("\n========================================================\n\n");
+
+    int ncores = num_cores();
+    printf("Data bus\n");
+    for (int m = 0; m < ncores; m++)
+        printf("  Core %-5d stall cycles: %u\n", m, BUS_STALL(m));
+    printf("  %-10s stall cycles: %u\n", "DMA", BUS_STALL(ncores));
+    printf("  %-10s stall cycles: %u\n", "IMC loader", BUS_STALL(ncores + 1));
+    uint32_t ram_txn = BUS_TXN(BUS_SLAVE_RAM);
+    printf("  RAM requests: %u, avg latency: %u\n", ram_txn,
+           ram_txn ? BUS_LAT(BUS_SLAVE_RAM) / ram_txn : 0);
+    for (int b = 0; b < TCDM_BANKS; b++)
+        printf("  TCDM bank %d: %u accesses, %u conflicts\n", b, TCDM_ACCESSES(b), TCDM_CONFLICTS(b));
+    uint32_t ic_hits = ICACHE_HITS, ic_misses = ICACHE_MISSES;
+    printf("Instruction cache\n");
+    printf("  hits: %u, misses: %u, refill cycles: %u, hit rate: %u%%\n", ic_hits, ic_misses,
+           ICACHE_REFILL, (ic_hits + ic_misses) ? (100 * ic_hits) / (ic_hits + ic_misses) : 0);
+    printf("\n========================================================\n\n");
+
+    printf("Total run: %llu cycles\n", (unsigned long long)(read_cycles() - run_t0));
     printf("\n========================================================\n\n");
 
     while(1);
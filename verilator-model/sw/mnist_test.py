@@ -34,6 +34,7 @@ The math, derived carefully (no centering = no zero-point bugs):
     B2[r] = round(b2[r] / (S_w2 * scale_h))
 """
 
+import argparse
 import numpy as np
 from PIL import Image
 import os
@@ -71,28 +72,36 @@ def train(epochs=15):
     return model, model.get_weights(), x_test_u8, y_test
 
 
-def ptq(weights, x_test_u8, y_test):
+def ptq(weights, x_test_u8, y_test, bits=8):
     w1k, b1, w2k, b2 = weights
     W1 = w1k.T.astype(np.float32)   # [32, 784]  row = one output neuron
     W2 = w2k.T.astype(np.float32)   # [10, 32]
 
+    # bits < 8 is the packed export: weights in +-(2^(bits-1)-1), pixels
+    # truncated to their top 'bits' bits, unsigned hidden activations
+    qw    = (1 << (bits - 1)) - 1
+    shift = 8 - bits
+    X_SC  = 255.0 / (1 << shift)           # real input = pixel_q / X_SC
+    HMAX  = 127 if bits == 8 else (1 << bits) - 1
+    x_q   = x_test_u8.astype(np.int32) >> shift
+
     # Quantize weights
-    S_w1 = float(np.max(np.abs(W1))) / 127.0
-    S_w2 = float(np.max(np.abs(W2))) / 127.0
-    W1_q = np.clip(np.round(W1 / S_w1), -127, 127).astype(np.int8)
-    W2_q = np.clip(np.round(W2 / S_w2), -127, 127).astype(np.int8)
+    S_w1 = float(np.max(np.abs(W1))) / qw
+    S_w2 = float(np.max(np.abs(W2))) / qw
+    W1_q = np.clip(np.round(W1 / S_w1), -qw, qw).astype(np.int8)
+    W2_q = np.clip(np.round(W2 / S_w2), -qw, qw).astype(np.int8)
     print(f"S_w1={S_w1:.8f}  S_w2={S_w2:.8f}")
 
-    # Layer 1 bias: B1[r] = round(b1[r] * 255 / S_w1)
-    B1 = np.round(b1.astype(np.float64) * 255.0 / S_w1).astype(np.int32)
+    # Layer 1 bias: B1[r] = round(b1[r] * X_SC / S_w1)
+    B1 = np.round(b1.astype(np.float64) * X_SC / S_w1).astype(np.int32)
     print(f"B1 range: [{B1.min()}, {B1.max()}]")
 
     # Sanity check on first image
-    img0_u8  = x_test_u8[0].astype(np.int32)
+    img0_u8  = x_q[0]
     img0_f   = x_test_u8[0].astype(np.float32) / 255.0
 
     acc0     = W1_q.astype(np.int32) @ img0_u8 + B1
-    h0_int   = np.maximum(acc0, 0).astype(np.float32) * (S_w1 / 255.0)
+    h0_int   = np.maximum(acc0, 0).astype(np.float32) * (S_w1 / X_SC)
     h0_float = np.maximum(W1 @ img0_f + b1, 0)
 
     print(f"\nSanity check (image 0, label={y_test[0]}):")
@@ -104,7 +113,7 @@ def ptq(weights, x_test_u8, y_test):
     print(f"\nCalibrating (2000 images)...")
     peak_list = []
     for i in range(2000):
-        xi = x_test_u8[i].astype(np.int32)
+        xi = x_q[i]
         h  = np.maximum(W1_q.astype(np.int32) @ xi + B1, 0)
         peak_list.append(int(h.max()))
     peak_arr = np.array(peak_list)
@@ -113,18 +122,18 @@ def ptq(weights, x_test_u8, y_test):
     print(f"  INT32 post-relu max: p99.9={p999}  p100={p100}")
 
     # Initial H_DIV
-    H_DIV_init = max(1, p999 // 127)
+    H_DIV_init = max(1, p999 // HMAX)
     print(f"  Initial H_DIV = {H_DIV_init}")
 
     # Helper: evaluate accuracy for a given H_DIV on n images
     def eval_acc(div, n=1000):
-        sh = div * S_w1 / 255.0
+        sh = div * S_w1 / X_SC
         B2d = np.round(b2.astype(np.float64) / (S_w2 * sh)).astype(np.int32)
         correct = 0
         for i in range(n):
-            xi = x_test_u8[i].astype(np.int32)
+            xi = x_q[i]
             h  = W1_q.astype(np.int32) @ xi + B1
-            h  = np.clip(np.maximum(h, 0) // div, 0, 127).astype(np.int8)
+            h  = np.clip(np.maximum(h, 0) // div, 0, HMAX).astype(np.int8)
             o  = W2_q.astype(np.int32) @ h.astype(np.int32) + B2d
             if np.argmax(o) == y_test[i]: correct += 1
         return correct / n * 100
@@ -154,16 +163,16 @@ def ptq(weights, x_test_u8, y_test):
     print(f"  Best H_DIV = {best_div}  (1k acc = {best_acc:.1f}%)")
 
     # Final B2
-    scale_h = best_div * S_w1 / 255.0
+    scale_h = best_div * S_w1 / X_SC
     B2 = np.round(b2.astype(np.float64) / (S_w2 * scale_h)).astype(np.int32)
     print(f"  B2 range: [{B2.min()}, {B2.max()}]")
 
     # Full 10k eval
     correct = 0
     for i in range(10000):
-        xi = x_test_u8[i].astype(np.int32)
+        xi = x_q[i]
         h  = W1_q.astype(np.int32) @ xi + B1
-        h  = np.clip(np.maximum(h, 0) // best_div, 0, 127).astype(np.int8)
+        h  = np.clip(np.maximum(h, 0) // best_div, 0, HMAX).astype(np.int8)
         o  = W2_q.astype(np.int32) @ h.astype(np.int32) + B2
         if np.argmax(o) == y_test[i]: correct += 1
     final_acc = correct / 100.0
@@ -171,6 +180,7 @@ def ptq(weights, x_test_u8, y_test):
 
     return dict(W1_q=W1_q, B1=B1, W2_q=W2_q, B2=B2,
                 H_DIV=best_div, S_w1=S_w1, S_w2=S_w2,
+                bits=bits, shift=shift, HMAX=HMAX,
                 accuracy=final_acc)
 
 
@@ -200,13 +210,36 @@ def wi32(f, name, arr, cmt=""):
 def wu8(f, name, arr, cmt=""):
     flat = arr.flatten()
     if cmt: f.write(f"// {cmt}\n")
-    f.write(f"static const uint8_t {name}[{len(flat)}] = {{\n")
+    f.write(f"static const uint8_t {name}[{len(flat)}]"
+            f" __attribute__((aligned(4))) = {{\n")
     for i in range(0, len(flat), 16):
         c = flat[i:i+16]
         f.write("    " + ", ".join(f"{int(x):3d}" for x in c))
         f.write(",\n" if i+16<len(flat) else "\n")
     f.write("};\n\n")
 
+def pack(arr, bits):
+    # Rows of b-bit two's complement lanes, lane i of a word in bits
+    # [bits*i +: bits] (the pv.*.n / pv.*.c lane order), zero padded to words
+    lanes = 32 // bits
+    rows  = arr.reshape(arr.shape[0], -1) if arr.ndim > 1 else arr.reshape(1, -1)
+    cols  = (rows.shape[1] + lanes - 1) // lanes * lanes
+    v = np.zeros((rows.shape[0], cols), dtype=np.uint32)
+    v[:, :rows.shape[1]] = rows.astype(np.int32).astype(np.uint32) & ((1 << bits) - 1)
+    v = v.reshape(rows.shape[0], -1, lanes) << (np.arange(lanes, dtype=np.uint32) * bits)
+    return np.bitwise_or.reduce(v, axis=2)
+
+def wpk(f, name, arr, bits, cmt=""):
+    words = pack(arr, bits)
+    flat = words.flatten()
+    if cmt: f.write(f"// {cmt}, {words.shape[1]} words per row\n")
+    f.write(f"static const uint32_t {name}[{len(flat)}] = {{\n")
+    for i in range(0, len(flat), 8):
+        c = flat[i:i+8]
+        f.write("    " + ", ".join(f"0x{int(x):08x}" for x in c))
+        f.write(",\n" if i+8<len(flat) else "\n")
+    f.write("};\n\n")
+
 
 def generate_header(p, x_test_u8, y_test):
     digit_imgs = {}
@@ -261,7 +294,51 @@ def generate_header(p, x_test_u8, y_test):
     print("Generated mnist_weights_int8.h")
 
 
+def generate_packed_header(p, x_test_u8, y_test):
+    # Same network at p['bits'] bits for the nibble (4) / crumb (2) dot
+    # products: layer 1 is pv.sdotusp (unsigned pixels), layer 2 as well
+    # (hidden activations are 0..HMAX)
+    b   = p['bits']
+    tag = {4: "n", 2: "c"}[b]
+    fn  = f"mnist_weights_int{b}.h"
+    with open(fn, "w") as f:
+        f.write("// =====================================================\n")
+        f.write(f"// INT{b} PTQ MNIST Weights, packed {32 // b} per word\n")
+        f.write("// Generated by mnist_test.py --packed\n")
+        f.write("//\n")
+        f.write(f"//   Layer1: pixel_q = pixel >> {p['shift']}\n")
+        f.write(f"//     acc[r] = sum(pv.sdotusp.{tag}(img_q, w1)) + b1[r]\n")
+        f.write(f"//     h[r]   = clip(relu(acc[r]) / H_DIV, 0, {p['HMAX']})\n")
+        f.write(f"//   Layer2: out[r] = sum(pv.sdotusp.{tag}(h, w2)) + b2[r]\n")
+        f.write("//\n")
+        f.write(f"// Accuracy: {p['accuracy']:.2f}%\n")
+        f.write("// =====================================================\n\n")
+        f.write(f"#ifndef MNIST_WEIGHTS_INT{b}_H\n")
+        f.write(f"#define MNIST_WEIGHTS_INT{b}_H\n\n")
+        f.write("#include <stdint.h>\n\n")
+        f.write(f"#define Q{b}_BITS        {b}\n")
+        f.write(f"#define Q{b}_IN_SHIFT    {p['shift']}\n")
+        f.write(f"#define Q{b}_HMAX        {p['HMAX']}\n")
+        f.write(f"#define Q{b}_H_DIV       {p['H_DIV']}\n")
+        f.write(f"#define Q{b}_W1_WORDS    {pack(p['W1_q'], b).shape[1]}\n")
+        f.write(f"#define Q{b}_W2_WORDS    {pack(p['W2_q'], b).shape[1]}\n\n")
+        wpk (f, f"w1_int{b}",  p['W1_q'], b, f"Layer1 weights [32][784] INT{b}")
+        wi32(f, f"b1_int{b}",  p['B1'],      f"Layer1 biases  [32] INT32")
+        wpk (f, f"w2_int{b}",  p['W2_q'], b, f"Layer2 weights [10][32]  INT{b}")
+        wi32(f, f"b2_int{b}",  p['B2'],      f"Layer2 biases  [10] INT32")
+        for d in range(10):
+            idx = np.where(y_test == d)[0][0]
+            wpk(f, f"test_image_q{b}_{d}", x_test_u8[idx] >> p['shift'], b, f"Digit {d}")
+        f.write("#endif\n")
+    print(f"Generated {fn}")
+
+
 def main():
+    ap = argparse.ArgumentParser()
+    ap.add_argument("--packed", type=int, choices=[4, 2], action="append", default=[],
+                    help="also export packed int4/int2 weights (repeatable)")
+    args = ap.parse_args()
+
     print("=" * 60)
     print("MNIST PTQ - Verified (no centering, no zero-point bugs)")
     print("=" * 60)
@@ -276,14 +353,22 @@ def main():
         idx = np.where(y_test == d)[0][0]
         xi = x_test_u8[idx].astype(np.int32)
         h  = p['W1_q'].astype(np.int32) @ xi + p['B1']
-        h  = np.clip(np.maximum(h,0) // p['H_DIV'], 0, 127).astype(np.int8)
+        h  = np.clip(np.maximum(h,0) // p['H_DIV'], 0, p['HMAX']).astype(np.int8)
         o  = p['W2_q'].astype(np.int32) @ h.astype(np.int32) + p['B2']
         pred = np.argmax(o)
         print(f"  Digit {d}: pred={pred}  {'OK' if pred==d else 'WRONG'}")
 
     generate_header(p, x_test_u8, y_test)
+
+    summary = [f"INT8 H_DIV={p['H_DIV']}  accuracy={p['accuracy']:.2f}%"]
+    for b in args.packed:
+        print(f"\n{'='*60}\nPacked INT{b} export\n{'='*60}")
+        pb = ptq(weights, x_test_u8, y_test, bits=b)
+        generate_packed_header(pb, x_test_u8, y_test)
+        summary.append(f"INT{b} H_DIV={pb['H_DIV']}  accuracy={pb['accuracy']:.2f}%")
+
     print(f"\n{'='*60}")
-    print(f"DONE!  H_DIV={p['H_DIV']}  accuracy={p['accuracy']:.2f}%")
+    print("DONE!  " + "\n       ".join(summary))
     print(f"{'='*60}")
 
 
@@ -1636,7 +1636,7 @@ static const int32_t b2_int32[10] __attribute__((aligned(4))) = {
 };
 
 // Digit 0
-static const uint8_t test_image_0[784] = {
+static const uint8_t test_image_0[784] __attribute__((aligned(4))) = {
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
@@ -1689,7 +1689,7 @@ static const uint8_t test_image_0[784] = {
 };
 
 // Digit 1
-static const uint8_t test_image_1[784] = {
+static const uint8_t test_image_1[784] __attribute__((aligned(4))) = {
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
@@ -1742,7 +1742,7 @@ static const uint8_t test_image_1[784] = {
 };
 
 // Digit 2
-static const uint8_t test_image_2[784] = {
+static const uint8_t test_image_2[784] __attribute__((aligned(4))) = {
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
@@ -1795,7 +1795,7 @@ static const uint8_t test_image_2[784] = {
 };
 
 // Digit 3
-static const uint8_t test_image_3[784] = {
+static const uint8_t test_image_3[784] __attribute__((aligned(4))) = {
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
@@ -1848,7 +1848,7 @@ static const uint8_t test_image_3[784] = {
 };
 
 // Digit 4
-static const uint8_t test_image_4[784] = {
+static const uint8_t test_image_4[784] __attribute__((aligned(4))) = {
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
@@ -1901,7 +1901,7 @@ static const uint8_t test_image_4[784] = {
 };
 
 // Digit 5
-static const uint8_t test_image_5[784] = {
+static const uint8_t test_image_5[784] __attribute__((aligned(4))) = {
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
@@ -1954,7 +1954,7 @@ static const uint8_t test_image_5[784] = {
 };
 
 // Digit 6
-static const uint8_t test_image_6[784] = {
+static const uint8_t test_image_6[784] __attribute__((aligned(4))) = {
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
@@ -2007,7 +2007,7 @@ static const uint8_t test_image_6[784] = {
 };
 
 // Digit 7
-static const uint8_t test_image_7[784] = {
+static const uint8_t test_image_7[784] __attribute__((aligned(4))) = {
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
@@ -2060,7 +2060,7 @@ static const uint8_t test_image_7[784] = {
 };
 
 // Digit 8
-static const uint8_t test_image_8[784] = {
+static const uint8_t test_image_8[784] __attribute__((aligned(4))) = {
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
@@ -2113,7 +2113,7 @@ static const uint8_t test_image_8[784] = {
 };
 
 // Digit 9
-static const uint8_t test_image_9[784] = {
+static const uint8_t test_image_9[784] __attribute__((aligned(4))) = {
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
       0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
@@ -0,0 +1,66 @@
+// =============================================================
+// NPU 8x8 MAC array (npu_coprocessor.sv), MMIO and instruction forms
+// =============================================================
+// The array holds an 8x8 tile of signed weights and 8 unsigned inputs and
+// returns the 8 row sums. It sits on the bus at 0x200 and, on core 0 only,
+// on the coprocessor port (opcode 0x77, funct7 0):
+//   npu.ldw  x0, rs1, rs2   funct3 0, weight word rs1 at index rs2 (0-15)
+//   npu.push x0, rs1, rs2   funct3 1, inputs 0-3 in rs1, 4-7 in rs2
+//   npu.acc  rd, rs1, x0    funct3 2, rd = sum of row rs1
+// Weight word i holds columns 4 * (i & 1) .. +3 of row i / 2, as at MMIO
+// offset 4 * i. The instructions take their operands from registers and
+// finish in EX (acc after one extra cycle), a bus access is a store or a
+// load through the interconnect.
+
+#ifndef NPU_H
+#define NPU_H
+
+#include <stdint.h>
+
+#define NPU_W(i)        (*((volatile uint32_t*)(0x200 + (i)*4)))
+#define NPU_IN_LO       (*((volatile uint32_t*)0x240))
+#define NPU_IN_HI       (*((volatile uint32_t*)0x244))
+#define NPU_ROW(r)      (*((volatile int32_t*)(0x248 + (r)*4)))
+
+static inline void    npu_mmio_ldw(uint32_t w, int i)         { NPU_W(i) = w; }
+static inline void    npu_mmio_push(uint32_t lo, uint32_t hi) { NPU_IN_LO = lo; NPU_IN_HI = hi; }
+static inline int32_t npu_mmio_acc(int r)                     { return NPU_ROW(r); }
+
+static inline void npu_insn_ldw(uint32_t w, int i) {
+    __asm__ volatile(".insn r 0x77, 0, 0, x0, %0, %1" :: "r"(w), "r"(i));
+}
+
+static inline void npu_insn_push(uint32_t lo, uint32_t hi) {
+    __asm__ volatile(".insn r 0x77, 1, 0, x0, %0, %1" :: "r"(lo), "r"(hi));
+}
+
+static inline int32_t npu_insn_acc(int r) {
+    int32_t v;
+    __asm__ volatile(".insn r 0x77, 2, 0, %0, %1, x0" : "=r"(v) : "r"(r));
+    return v;
+}
+
+// out[r] = sum_c W[r][c] * inp[c] in 8x8 tiles, rows and cols multiples of 8,
+// W and inp word aligned
+#define NPU_MV(name, ldw, push, acc)                                                \
+static inline void name(const int8_t *W, const uint8_t *inp, int32_t *out, int rows, int cols) { \
+    for (int r0 = 0; r0 < rows; r0 += 8) {                                          \
+        int32_t sum[8] = { 0 };                                                     \
+        for (int c0 = 0; c0 < cols; c0 += 8) {                                      \
+            const uint32_t *x = (const uint32_t *)(inp + c0);                       \
+            for (int r = 0; r < 8; r++) {                                           \
+                const uint32_t *w = (const uint32_t *)(W + (r0 + r) * cols + c0);   \
+                ldw(w[0], 2 * r);                                                   \
+                ldw(w[1], 2 * r + 1);                                               \
+            }                                                                       \
+            push(x[0], x[1]);                                                       \
+            for (int r = 0; r < 8; r++) sum[r] += acc(r);                           \
+        }                                                                           \
+        for (int r = 0; r < 8; r++) out[r0 + r] = sum[r];                           \
+    }                                                                               \
+}
+
+NPU_MV(npu_mv_mmio, npu_mmio_ldw, npu_mmio_push, npu_mmio_acc)
+NPU_MV(npu_mv_insn, npu_insn_ldw, npu_insn_push, npu_insn_acc)
+
+#endif
@@ -0,0 +1,153 @@
+// =============================================================
+// Core performance counters (RI5CY PCCR/PCER/PCMR CSRs)
+// =============================================================
+// One counter per event, PCER selects the events that count and PCMR[0]
+// enables counting (PCMR[1] saturates instead of wrapping). Events 13 and up
+// are the external counters wired in top.sv. Counters are per core; the
+// accelerator events are cluster wide and count on every core. None of them
+// count inside interrupt handlers, see startup.S.
+//
+// A counter whose bit is set in PCOIE raises PERF_IRQ_LINE when it wraps and
+// restarts from its sign extended PCPRE preload, so a preload of -N samples
+// every N events. With the 64 bit counters of top.sv (PERF_CNT64) the upper
+// halves are at 0x7E0 + i.
+
+#ifndef PERF_H
+#define PERF_H
+
+#include <stdio.h>
+#include <stdint.h>
+
+#define PERF_CYCLES       0
+#define PERF_INSTR        1
+#define PERF_LD_STALL     2
+#define PERF_JR_STALL     3
+#define PERF_IMISS        4
+#define PERF_LD           5
+#define PERF_ST           6
+#define PERF_JUMP         7
+#define PERF_BRANCH       8
+#define PERF_BTAKEN       9
+#define PERF_RVC          10
+#define PERF_BMISS        11    // mispredicted branches, flushed in EX
+#define PERF_BTB_MISS     12    // branches predicted taken in ID, not by the BTB
+#define PERF_NPU_BUSY     13    // NPU accessed
+#define PERF_IMC_PROG     14    // crossbar cells programmed
+#define PERF_IMC_EVAL     15    // inputs applied to the crossbar
+#define PERF_BUS_STALL    16    // data request waiting for a grant
+#define PERF_MEM_WAIT     17    // granted data request waiting for its response
+#define PERF_COUNT        18
+
+#define PERF_ALL          ((1u << PERF_COUNT) - 1)
+
+#define PCMR_ENABLE       0x1
+#define PCMR_SATURATE     0x2
+
+#define PERF_IRQ_LINE     20    // top.sv IRQ_PERF
+
+// CSR numbers must be constants, they are encoded in the instruction
+#define PERF_CSR_WRITE(csr, v) __asm__ volatile("csrw %0, %1" :: "i"(csr), "r"(v))
+#define PERF_CSR_SET(csr, v)   __asm__ volatile("csrs %0, %1" :: "i"(csr), "r"(v))
+#define PERF_CSR_CLEAR(csr, v) __asm__ volatile("csrc %0, %1" :: "i"(csr), "r"(v))
+#define PERF_CSR_READ(csr) \
+    ({ uint32_t __v; __asm__ volatile("csrr %0, %1" : "=r"(__v) : "i"(csr)); __v; })
+
+#define PCCR(i)           (0x780 + (i))
+#define PCCRH(i)          (0x7E0 + (i))
+#define PCPRE(i)          (0xBE0 + (i))
+#define PCER              0x7A0
+#define PCMR              0x7A1
+#define PCOIE             0x7A2
+#define PCOVF             0x7A3
+
+// Full 64 bit counter, the upper half is read again if the lower one wrapped
+#define PERF_READ64(i) ({                                   \
+    uint32_t __hi = PERF_CSR_READ(PCCRH(i));                \
+    uint32_t __lo = PERF_CSR_READ(PCCR(i));                 \
+    if (PERF_CSR_READ(PCCRH(i)) != __hi) {                  \
+        __hi = PERF_CSR_READ(PCCRH(i));                     \
+        __lo = PERF_CSR_READ(PCCR(i));                      \
+    }                                                       \
+    ((uint64_t)__hi << 32) | __lo; })
+
+// Overflow interrupt every 'period' occurrences of event ev from now on.
+// startup.S stops the counters while the handler runs, so its own loads
+// do not count towards the next period; the trap entry and exit still add
+// about one store and one load per interrupt.
+#define PERF_SAMPLE_START(ev, period) do {                  \
+    uint32_t __pre = -(uint32_t)(period);                   \
+    PERF_CSR_WRITE(PCPRE(ev), __pre);                       \
+    PERF_CSR_WRITE(PCCRH(ev), 0xFFFFFFFFu);                 \
+    PERF_CSR_WRITE(PCCR(ev), __pre);                        \
+    PERF_CSR_SET(PCOIE, 1u << (ev));                        \
+} while (0)
+
+#define PERF_SAMPLE_STOP(ev) do {                           \
+    PERF_CSR_CLEAR(PCOIE, 1u << (ev));                      \
+    PERF_CSR_CLEAR(PCOVF, 1u << (ev));                      \
+} while (0)
+
+// Called by the interrupt handler, returns and clears the overflowed counters
+static inline uint32_t perf_overflow_ack(void) {
+    uint32_t ovf = PERF_CSR_READ(PCOVF);
+    PERF_CSR_CLEAR(PCOVF, ovf);
+    return ovf;
+}
+
+typedef struct {
+    uint32_t cnt[PERF_COUNT];
+} perf_snapshot_t;
+
+// Clear every counter, count the events in mask
+static inline void perf_start(uint32_t mask) {
+    PERF_CSR_WRITE(PCMR, 0);
+    PERF_CSR_WRITE(0x79F, 0);             // all PCCRs at once
+    PERF_CSR_WRITE(0x7FF, 0);             // ... and their upper halves
+    PERF_CSR_WRITE(PCOIE, 0);
+    PERF_CSR_WRITE(PCOVF, 0);
+    PERF_CSR_WRITE(PCER, mask);
+    PERF_CSR_WRITE(PCMR, PCMR_ENABLE);
+}
+
+static inline void perf_stop(void) { PERF_CSR_WRITE(PCMR, 0); }
+
+// One read per counter, the CSR number is part of the instruction
+static inline void perf_snapshot(perf_snapshot_t *s) {
+    s->cnt[0]  = PERF_CSR_READ(PCCR(0));
+    s->cnt[1]  = PERF_CSR_READ(PCCR(1));
+    s->cnt[2]  = PERF_CSR_READ(PCCR(2));
+    s->cnt[3]  = PERF_CSR_READ(PCCR(3));
+    s->cnt[4]  = PERF_CSR_READ(PCCR(4));
+    s->cnt[5]  = PERF_CSR_READ(PCCR(5));
+    s->cnt[6]  = PERF_CSR_READ(PCCR(6));
+    s->cnt[7]  = PERF_CSR_READ(PCCR(7));
+    s->cnt[8]  = PERF_CSR_READ(PCCR(8));
+    s->cnt[9]  = PERF_CSR_READ(PCCR(9));
+    s->cnt[10] = PERF_CSR_READ(PCCR(10));
+    s->cnt[11] = PERF_CSR_READ(PCCR(11));
+    s->cnt[12] = PERF_CSR_READ(PCCR(12));
+    s->cnt[13] = PERF_CSR_READ(PCCR(13));
+    s->cnt[14] = PERF_CSR_READ(PCCR(14));
+    s->cnt[15] = PERF_CSR_READ(PCCR(15));
+    s->cnt[16] = PERF_CSR_READ(PCCR(16));
+    s->cnt[17] = PERF_CSR_READ(PCCR(17));
+}
+
+// d = b - a, counters wrap modulo 2^32
+static inline void perf_diff(perf_snapshot_t *d, const perf_snapshot_t *a, const perf_snapshot_t *b) {
+    for (int i = 0; i < PERF_COUNT; i++)
+        d->cnt[i] = b->cnt[i] - a->cnt[i];
+}
+
+static inline void perf_print(const char *title, const perf_snapshot_t *d) {
+    static const char *const names[PERF_COUNT] = {
+        "cycles", "instructions", "load-use stalls", "jr stalls", "fetch wait",
+        "loads", "stores", "jumps", "branches", "taken branches", "compressed",
+        "mispredicted", "BTB miss", "NPU busy", "IMC program", "IMC evaluate", "bus stall", "memory wait"
+    };
+    printf("%s\n", title);
+    for (int i = 0; i < PERF_COUNT; i++)
+        printf("  %-16s %u\n", names[i], (unsigned)d->cnt[i]);
+}
+
+#endif
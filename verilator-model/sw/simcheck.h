@@ -0,0 +1,16 @@
+// =============================================================
+// Lockstep checking regions (riscv_simchecker.sv)
+// =============================================================
+// With +simregion the checker of a "make SIMCHECK=1" model only checks the
+// instructions between SIMCHECK_BEGIN() and SIMCHECK_END(). The markers are
+// hint encodings of slti to x0, a plain nop for the core and for builds
+// without the checker. Regions are per core and do not nest. The memory
+// clobber keeps the compiler from moving loads and stores across a marker.
+
+#ifndef SIMCHECK_H
+#define SIMCHECK_H
+
+#define SIMCHECK_BEGIN()  __asm__ volatile("slti x0, x0, 1" ::: "memory")
+#define SIMCHECK_END()    __asm__ volatile("slti x0, x0, 0" ::: "memory")
+
+#endif
@@ -0,0 +1,39 @@
+// =============================================================
+// Timer driver (timer_unit.sv @ 0x300)
+// =============================================================
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include <stdint.h>
+
+#define TIMER_BASE      0x300
+#define TIMER_REG(off)  (*((volatile uint32_t*)(TIMER_BASE + (off))))
+#define TIMER_CNT_LO    TIMER_REG(0x00)
+#define TIMER_CNT_HI    TIMER_REG(0x04)
+#define TIMER_CMP_LO    TIMER_REG(0x08)
+#define TIMER_CMP_HI    TIMER_REG(0x0C)
+#define TIMER_CTRL      TIMER_REG(0x10)
+#define TIMER_PERIOD    TIMER_REG(0x14)
+#define TIMER_PRESCALE  TIMER_REG(0x18)
+
+#define TIMER_CTRL_ARMED 0x1
+
+// The CNT_LO read latches the upper half, so the pair is consistent
+static inline uint64_t timer_read(void) {
+    uint32_t lo = TIMER_CNT_LO;
+    uint32_t hi = TIMER_CNT_HI;
+    return ((uint64_t)hi << 32) | lo;
+}
+
+// Timer event at 'when', then every 'period' ticks if period is non-zero.
+// The compare takes both halves at the CMP_HI write, LO must come first.
+static inline void timer_set_compare(uint64_t when, uint32_t period) {
+    TIMER_PERIOD = period;
+    TIMER_CMP_LO = (uint32_t)when;
+    TIMER_CMP_HI = (uint32_t)(when >> 32);
+}
+
+static inline void timer_stop(void) { TIMER_CTRL = 0; }
+
+#endif
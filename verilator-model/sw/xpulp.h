@@ -0,0 +1,147 @@
+// =============================================================
+// Xpulp int8 GEMV kernels (RI5CY hardware loops, post-increment
+// loads and 4-way dot products)
+// =============================================================
+// The stock toolchain has no Xpulp mnemonics, the instructions are emitted
+// with .insn using the encodings of decoder.sv:
+//   lp.setup  L, rs1, end    opcode 0x7B, funct3 100, rd = L, imm = (end - pc) / 2
+//                            loops from the next instruction to the one at end
+//   p.lw      rd, imm(rs1!)  opcode 0x0B, funct3 010, rs1 += imm after the load
+//   pv.sdotusp.b rd, rs1, rs2  opcode 0x57, funct3 001, funct7 0x54
+//   pv.sdotsp.b  rd, rs1, rs2  opcode 0x57, funct3 001, funct7 0x5C
+//   pv.sdot8usp.b rd, rs1, rs2 opcode 0x57, funct3 001, funct7 0x56
+//   pv.sdot8sp.b  rd, rs1, rs2 opcode 0x57, funct3 001, funct7 0x5E
+// funct7 is instr[31:25]; the decoder takes the operation from instr[31:26]
+// with the pair forms at bit 26 (0x52 would be pv.sdot8up.b), bit 25 is the
+// low immediate bit of the .sci forms and does not select anything here.
+// sdot adds the four byte products of rs1 and rs2 to rd; usp takes rs1 as
+// unsigned and rs2 as signed bytes. sdot8 also reads rs1+1 and rs2+1 and adds
+// all eight byte products, the register pairs are pinned with explicit
+// register variables.
+//
+// funct3 010 (.n) and 011 (.c) select the nibble (8 lanes) and crumb (16 lanes)
+// forms of the dot products, for the packed weights of mnist_test.py --packed.
+//
+// The inner loop handles 8 columns per iteration, the remaining columns are
+// done in C. Word aligned rows and inputs avoid split loads in the LSU.
+
+#ifndef XPULP_H
+#define XPULP_H
+
+#include <stdint.h>
+
+// acc + sum(x[i] * w[i]) over 8 * n8 elements, x unsigned, w signed
+static inline int32_t xpulp_dot8_u8(const uint8_t *x, const int8_t *w, int n8, int32_t acc) {
+    uint32_t x0, x1, w0, w1;
+    __asm__ volatile(
+        ".insn i 0x7B, 4, x0, %[n], 12\n\t"           // lp.setup 0, n8, +24 bytes
+        ".insn i 0x0B, 2, %[x0], 4(%[x])\n\t"          // p.lw x0, 4(x!)
+        ".insn i 0x0B, 2, %[w0], 4(%[w])\n\t"          // p.lw w0, 4(w!)
+        ".insn i 0x0B, 2, %[x1], 4(%[x])\n\t"          // p.lw x1, 4(x!)
+        ".insn i 0x0B, 2, %[w1], 4(%[w])\n\t"          // p.lw w1, 4(w!)
+        ".insn r 0x57, 1, 0x54, %[acc], %[x0], %[w0]\n\t"  // pv.sdotusp.b
+        ".insn r 0x57, 1, 0x54, %[acc], %[x1], %[w1]\n\t"  // pv.sdotusp.b, loop end
+        : [acc] "+r"(acc), [x] "+r"(x), [w] "+r"(w),
+          [x0] "=&r"(x0), [x1] "=&r"(x1), [w0] "=&r"(w0), [w1] "=&r"(w1)
+        : [n] "r"(n8)
+        : "memory");
+    return acc;
+}
+
+// Same with signed x
+static inline int32_t xpulp_dot8_i8(const int8_t *x, const int8_t *w, int n8, int32_t acc) {
+    uint32_t x0, x1, w0, w1;
+    __asm__ volatile(
+        ".insn i 0x7B, 4, x0, %[n], 12\n\t"
+        ".insn i 0x0B, 2, %[x0], 4(%[x])\n\t"
+        ".insn i 0x0B, 2, %[w0], 4(%[w])\n\t"
+        ".insn i 0x0B, 2, %[x1], 4(%[x])\n\t"
+        ".insn i 0x0B, 2, %[w1], 4(%[w])\n\t"
+        ".insn r 0x57, 1, 0x5C, %[acc], %[x0], %[w0]\n\t"  // pv.sdotsp.b
+        ".insn r 0x57, 1, 0x5C, %[acc], %[x1], %[w1]\n\t"
+        : [acc] "+r"(acc), [x] "+r"(x), [w] "+r"(w),
+          [x0] "=&r"(x0), [x1] "=&r"(x1), [w0] "=&r"(w0), [w1] "=&r"(w1)
+        : [n] "r"(n8)
+        : "memory");
+    return acc;
+}
+
+// acc + sum(x[i] * w[i]) over 8 * n8 elements with one sdot8 per iteration
+static inline int32_t xpulp_dot8p_u8(const uint8_t *x, const int8_t *w, int n8, int32_t acc) {
+    register uint32_t x0 __asm__("t3"), x1 __asm__("t4");
+    register uint32_t w0 __asm__("t5"), w1 __asm__("t6");
+    __asm__ volatile(
+        ".insn i 0x7B, 4, x0, %[n], 10\n\t"           // lp.setup 0, n8, +20 bytes
+        ".insn i 0x0B, 2, %[x0], 4(%[x])\n\t"
+        ".insn i 0x0B, 2, %[x1], 4(%[x])\n\t"
+        ".insn i 0x0B, 2, %[w0], 4(%[w])\n\t"
+        ".insn i 0x0B, 2, %[w1], 4(%[w])\n\t"
+        ".insn r 0x57, 1, 0x56, %[acc], %[x0], %[w0]\n\t"  // pv.sdot8usp.b, loop end
+        : [acc] "+r"(acc), [x] "+r"(x), [w] "+r"(w),
+          [x0] "=&r"(x0), [x1] "=&r"(x1), [w0] "=&r"(w0), [w1] "=&r"(w1)
+        : [n] "r"(n8)
+        : "memory");
+    return acc;
+}
+
+// Same with signed x
+static inline int32_t xpulp_dot8p_i8(const int8_t *x, const int8_t *w, int n8, int32_t acc) {
+    register uint32_t x0 __asm__("t3"), x1 __asm__("t4");
+    register uint32_t w0 __asm__("t5"), w1 __asm__("t6");
+    __asm__ volatile(
+        ".insn i 0x7B, 4, x0, %[n], 10\n\t"
+        ".insn i 0x0B, 2, %[x0], 4(%[x])\n\t"
+        ".insn i 0x0B, 2, %[x1], 4(%[x])\n\t"
+        ".insn i 0x0B, 2, %[w0], 4(%[w])\n\t"
+        ".insn i 0x0B, 2, %[w1], 4(%[w])\n\t"
+        ".insn r 0x57, 1, 0x5E, %[acc], %[x0], %[w0]\n\t"  // pv.sdot8sp.b
+        : [acc] "+r"(acc), [x] "+r"(x), [w] "+r"(w),
+          [x0] "=&r"(x0), [x1] "=&r"(x1), [w0] "=&r"(w0), [w1] "=&r"(w1)
+        : [n] "r"(n8)
+        : "memory");
+    return acc;
+}
+
+// acc + 8 nibble / 16 crumb products of one word each, x unsigned, w signed
+static inline int32_t xpulp_sdotusp_n(int32_t acc, uint32_t x, uint32_t w) {
+    __asm__(".insn r 0x57, 2, 0x54, %0, %1, %2" : "+r"(acc) : "r"(x), "r"(w));
+    return acc;
+}
+
+static inline int32_t xpulp_sdotusp_c(int32_t acc, uint32_t x, uint32_t w) {
+    __asm__(".insn r 0x57, 3, 0x54, %0, %1, %2" : "+r"(acc) : "r"(x), "r"(w));
+    return acc;
+}
+
+// out[r] = sum over the packed words of row r, words per row padded as in
+// mnist_test.py (zero lanes add nothing)
+static inline void xpulp_mv_packed(const uint32_t *W, const uint32_t *inp, int32_t *out,
+                                   int rows, int words, int bits) {
+    for (int r = 0; r < rows; r++) {
+        const uint32_t *w = W + r * words;
+        int32_t acc = 0;
+        if (bits == 4) for (int c = 0; c < words; c++) acc = xpulp_sdotusp_n(acc, inp[c], w[c]);
+        else           for (int c = 0; c < words; c++) acc = xpulp_sdotusp_c(acc, inp[c], w[c]);
+        out[r] = acc;
+    }
+}
+
+// out[r] = sum_c W[r][c] * inp[c], dot does 8 columns per loop iteration
+#define XPULP_MV(name, in_t, dot)                                                   \
+static inline void name(const int8_t *W, const in_t *inp, int32_t *out, int rows, int cols) { \
+    int n8 = cols >> 3;                                                             \
+    for (int r = 0; r < rows; r++) {                                                \
+        const int8_t *w = W + r * cols;                                             \
+        int32_t acc = n8 ? dot(inp, w, n8, 0) : 0;                                  \
+        for (int c = n8 << 3; c < cols; c++)                                        \
+            acc += (int32_t)w[c] * (int32_t)inp[c];                                 \
+        out[r] = acc;                                                               \
+    }                                                                               \
+}
+
+XPULP_MV(xpulp_mv_u8,  uint8_t, xpulp_dot8p_u8)    // sdot8, unsigned input
+XPULP_MV(xpulp_mv_i8,  int8_t,  xpulp_dot8p_i8)    // sdot8, signed input
+XPULP_MV(xpulp_mv4_u8, uint8_t, xpulp_dot8_u8)     // two 4 lane sdots per iteration
+XPULP_MV(xpulp_mv4_i8, int8_t,  xpulp_dot8_i8)
+
+#endif
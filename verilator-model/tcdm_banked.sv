@@ -0,0 +1,120 @@
+// =============================================================
+// TCDM - multi-banked, word-interleaved scratchpad
+// =============================================================
+// Consecutive 32-bit words live in consecutive banks (bank = word index mod
+// N_BANKS), so streaming masters spread over all banks. Every port can be
+// granted in the same cycle as long as the ports target different banks.
+// Ports that collide on a bank are arbitrated round-robin; the losers see
+// no grant, keep their request up and are counted as conflicts of that bank.
+// Read data returns one cycle after the grant, writes also answer with rvalid.
+//
+//   access_cnt_o[b]    granted accesses of bank b
+//   conflict_cnt_o[b]  requests to bank b refused because of a collision
+module tcdm_banked #(
+    parameter int N_PORTS    = 3,
+    parameter int N_BANKS    = 4,
+    parameter int BANK_WORDS = 4096
+)(
+    input  logic                             clk,
+    input  logic                             rst_n,
+
+    input  logic [N_PORTS-1:0]               req,
+    input  logic [N_PORTS-1:0][31:0]         addr,    // byte offset into the TCDM
+    input  logic [N_PORTS-1:0]               we,
+    input  logic [N_PORTS-1:0][3:0]          be,
+    input  logic [N_PORTS-1:0][31:0]         wdata,
+    output logic [N_PORTS-1:0]               gnt,
+    output logic [N_PORTS-1:0]               rvalid,
+    output logic [N_PORTS-1:0][31:0]         rdata,
+
+    input  logic                             clear_counters_i,
+    output logic [N_BANKS-1:0][31:0]         access_cnt_o,
+    output logic [N_BANKS-1:0][31:0]         conflict_cnt_o
+);
+    localparam int BANK_W = (N_BANKS > 1) ? $clog2(N_BANKS) : 1;
+    localparam int ROW_W  = $clog2(BANK_WORDS);
+    localparam int PID_W  = (N_PORTS > 1) ? $clog2(N_PORTS) : 1;
+
+    logic [31:0] mem [N_BANKS][BANK_WORDS];
+
+    logic [N_PORTS-1:0][BANK_W-1:0] port_bank;
+    logic [N_PORTS-1:0][ROW_W-1:0]  port_row;
+    logic [N_BANKS-1:0][PID_W-1:0]  rr_last;
+    logic [N_BANKS-1:0][PID_W-1:0]  bank_winner;
+    logic [N_BANKS-1:0]             bank_busy;
+    logic [N_BANKS-1:0][31:0]       bank_losers;
+
+    always_comb begin
+        for (int p = 0; p < N_PORTS; p++) begin
+            port_bank[p] = (N_BANKS > 1) ? addr[p][2 +: BANK_W] : '0;
+            port_row[p]  = addr[p][2 + ((N_BANKS > 1) ? BANK_W : 0) +: ROW_W];
+        end
+    end
+
+    // Per-bank round-robin arbitration
+    always_comb begin
+        gnt = '0;
+        for (int b = 0; b < N_BANKS; b++) begin
+            bank_winner[b] = '0;
+            bank_busy[b]   = 1'b0;
+            bank_losers[b] = 32'h0;
+            for (int k = 0; k < N_PORTS; k++) begin
+                automatic int p = (int'(rr_last[b]) + 1 + k) % N_PORTS;
+                if (req[p] && port_bank[p] == BANK_W'(b)) begin
+                    if (!bank_busy[b]) begin
+                        bank_winner[b] = PID_W'(p);
+                        bank_busy[b]   = 1'b1;
+                        gnt[p]         = 1'b1;
+                    end else begin
+                        bank_losers[b] = bank_losers[b] + 32'h1;
+                    end
+                end
+            end
+        end
+    end
+
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            rr_last <= '0;
+            rvalid  <= '0;
+            rdata   <= '0;
+        end else begin
+            rvalid <= gnt;
+            for (int b = 0; b < N_BANKS; b++)
+                if (bank_busy[b]) rr_last[b] <= bank_winner[b];
+
+            for (int p = 0; p < N_PORTS; p++) begin
+                if (gnt[p]) begin
+                    if (we[p]) begin
+                        for (int i = 0; i < 4; i++)
+                            if (be[p][i]) mem[port_bank[p]][port_row[p]][i*8 +: 8] <= wdata[p][i*8 +: 8];
+                    end else begin
+                        rdata[p] <= mem[port_bank[p]][port_row[p]];
+                    end
+                end
+            end
+        end
+    end
+
+    // Statistics
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            access_cnt_o   <= '0;
+            conflict_cnt_o <= '0;
+        end else if (clear_counters_i) begin
+            access_cnt_o   <= '0;
+            conflict_cnt_o <= '0;
+        end else begin
+            for (int b = 0; b < N_BANKS; b++) begin
+                if (bank_busy[b]) access_cnt_o[b] <= access_cnt_o[b] + 32'h1;
+                conflict_cnt_o[b] <= conflict_cnt_o[b] + bank_losers[b];
+            end
+        end
+    end
+
+    initial begin
+        for (int b = 0; b < N_BANKS; b++)
+            for (int r = 0; r < BANK_WORDS; r++)
+                mem[b][r] = 32'h0;
+    end
+endmodule
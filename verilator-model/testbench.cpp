@@ -75,6 +75,7 @@ int main(int argc, char **argv) {
         last_uart_write = uart_write;
     }
     
+    top->final();   // closes the binary traces
     delete top;
     
     // Calculate and print performance
@@ -0,0 +1,99 @@
+// =============================================================
+// Timer Unit - 64-bit cycle counter with compare and prescaler
+// =============================================================
+// Register map (byte offsets):
+//   0x00 CNT_LO    counter bits [31:0]; the read also latches bits [63:32]
+//   0x04 CNT_HI    bits [63:32] latched by the last CNT_LO read, so a LO then
+//                  HI read pair is atomic (the latch is shared by all masters)
+//   0x08 CMP_LO    compare value bits [31:0], held until the CMP_HI write
+//   0x0C CMP_HI    compare value bits [63:32]; the write loads both halves
+//                  and arms the compare, so an armed compare never sees a
+//                  half-written value
+//   0x10 CTRL      [0] armed (write 0 to disarm)
+//   0x14 PERIOD    if non-zero, a match re-arms at compare + PERIOD
+//   0x18 PRESCALE  the counter advances every PRESCALE + 1 cycles
+//
+// Writing CNT_LO/CNT_HI sets the counter. irq_o pulses for one cycle when
+// the counter reaches the compare value while armed.
+module timer_unit (
+    input  logic        clk,
+    input  logic        rst_n,
+
+    input  logic        req,
+    input  logic        we,
+    input  logic [4:0]  addr,
+    input  logic [31:0] wdata,
+    output logic [31:0] rdata,
+    output logic        rvalid,
+
+    output logic        irq_o
+);
+    localparam REG_CNT_LO   = 5'h00;
+    localparam REG_CNT_HI   = 5'h04;
+    localparam REG_CMP_LO   = 5'h08;
+    localparam REG_CMP_HI   = 5'h0C;
+    localparam REG_CTRL     = 5'h10;
+    localparam REG_PERIOD   = 5'h14;
+    localparam REG_PRESCALE = 5'h18;
+
+    logic [63:0] cnt, cmp;
+    logic [31:0] cnt_hi_latch, cmp_lo_next, period, prescale, pre_cnt;
+    logic        armed;
+
+    logic tick, match;
+    assign tick  = (pre_cnt == prescale);
+    assign match = armed && (cnt >= cmp);
+
+    always_ff @(posedge clk or negedge rst_n) begin
+        if (!rst_n) begin
+            cnt          <= 64'h0;
+            cmp          <= 64'h0;
+            cmp_lo_next  <= 32'h0;
+            cnt_hi_latch <= 32'h0;
+            period       <= 32'h0;
+            prescale     <= 32'h0;
+            pre_cnt      <= 32'h0;
+            armed        <= 1'b0;
+            irq_o        <= 1'b0;
+            rvalid       <= 1'b0;
+            rdata        <= 32'h0;
+        end else begin
+            // Counter
+            pre_cnt <= tick ? 32'h0 : pre_cnt + 32'h1;
+            if (tick) cnt <= cnt + 64'h1;
+
+            // Compare
+            irq_o <= match;
+            if (match) begin
+                if (period != 32'h0) cmp   <= cmp + 64'(period);
+                else                 armed <= 1'b0;
+            end
+
+            // Register access
+            rvalid <= req;
+            if (req && we) begin
+                case (addr)
+                    REG_CNT_LO:   cnt[31:0]   <= wdata;
+                    REG_CNT_HI:   cnt[63:32]  <= wdata;
+                    REG_CMP_LO:   cmp_lo_next <= wdata;
+                    REG_CMP_HI:   begin cmp <= {wdata, cmp_lo_next}; armed <= 1'b1; end
+                    REG_CTRL:     armed       <= wdata[0];
+                    REG_PERIOD:   period      <= wdata;
+                    REG_PRESCALE: begin prescale <= wdata; pre_cnt <= 32'h0; end
+                    default: ;
+                endcase
+            end else if (req) begin
+                case (addr)
+                    REG_CNT_LO:   begin rdata <= cnt[31:0]; cnt_hi_latch <= cnt[63:32]; end
+                    REG_CNT_HI:   rdata <= cnt_hi_latch;
+                    REG_CMP_LO:   rdata <= cmp[31:0];
+                    REG_CMP_HI:   rdata <= cmp[63:32];
+                    REG_CTRL:     rdata <= {31'b0, armed};
+                    REG_PERIOD:   rdata <= period;
+                    REG_PRESCALE: rdata <= prescale;
+                    default:      rdata <= 32'h0;
+                endcase
+            end
+        end
+    end
+endmodule
@@ -1,6 +1,7 @@
 // top.sv - Final Fixed Version
 module top
 #(
+    parameter N_CORES           = 1,      // cores sharing the data memory
     parameter INSTR_RDATA_WIDTH = 128,
     parameter ADDR_WIDTH        = 22,
     parameter BOOT_ADDR         = 'h80,
@@ -9,7 +10,41 @@ module top
     parameter NPU_END           = 'h270,
     parameter CYCLE_ADDR        = 'h300,
     parameter IMC_BASE          = 'h400,
-    parameter IMC_END           = 'h430
+    parameter IMC_END           = 'h470,
+    parameter DMA_BASE          = 'h500,
+    parameter DMA_END           = 'h540,
+    parameter BUSSTAT_BASE      = 'h600,
+    parameter BUSSTAT_END       = 'h6C0,
+    parameter EU_BASE           = 'h700,
+    parameter EU_END            = 'h740,
+    parameter TCDM_BASE         = 'h200000,
+    parameter TCDM_BANKS        = 4,
+    parameter TCDM_BANK_WORDS   = 4096,   // 64 KiB with 4 banks
+    parameter IRQ_DMA           = 16,     // core irq lines of the event unit sources
+    parameter IRQ_NPU           = 17,
+    parameter IRQ_IMC           = 18,
+    parameter IRQ_TIMER         = 19,
+    parameter IRQ_PERF          = 20,     // core perf counter overflow (core internal)
+    parameter PERF_CNT64        = 1,      // 64 bit core performance counters
+    parameter FAST_DIV          = 1,      // radix-4 divider with zero skipping (0: radix-2)
+    parameter MULH_MODE         = 1,      // mulh latency: 0 iterative (5 cycles), 1 single cycle, 2 two cycles
+    parameter BRANCH_PREDICT    = 1,      // predict backward branches taken in ID
+    parameter BTB_ENTRIES       = 16,     // branch target buffer in IF (power of 2, 0: none)
+    parameter LOAD_FWD          = 1,      // load data forwarded into EX, no load-use stall
+    parameter BUS_ARB_MODE      = 0,      // 0: round-robin, 1: fixed priority (core first)
+    parameter IMC_CELL_MODEL    = 0,      // 0: ideal, 1: behavioral ReRAM
+    parameter IMC_ADC_BITS      = 0,      // 0: no ADC quantization
+    parameter RAM_INSTR_LATENCY = 1,      // RAM timing defaults, see ram.sv;
+    parameter RAM_DATA_LATENCY  = 1,      // plusargs override them at run time
+    parameter RAM_SLOW_BASE     = 0,
+    parameter RAM_SLOW_END      = 0,
+    parameter RAM_SLOW_LATENCY  = 1,
+    parameter RAM_WAIT_MODE     = 0,
+    parameter ICACHE_EN         = 1,      // 0: fetch straight from the RAM
+    parameter ICACHE_SIZE       = 4096,
+    parameter ICACHE_WAYS       = 2,
+    parameter ICACHE_LINE       = 32,
+    parameter ICACHE_REFILL_LAT = 0       // extra cycles before each refill
 )
 (
     input  logic        clk_i,
@@ -31,103 +66,423 @@ module top
     output logic [31:0] data_wdata_o
 );
 
+    // Data bus masters, cores 0..N_CORES-1 first
+    localparam N_MASTERS = N_CORES + 2;
+    localparam M_CORE    = 0;
+    localparam M_DMA     = N_CORES;
+    localparam M_IMC     = N_CORES + 1;
+
+    // Data bus slaves
+    localparam N_SLAVES  = 7;
+    localparam S_RAM     = 0;
+    localparam S_UART    = 1;
+    localparam S_NPU     = 2;
+    localparam S_CYCLE   = 3;
+    localparam S_IMC     = 4;
+    localparam S_DMA     = 5;
+    localparam S_BUSSTAT = 6;
+
+    // Core external performance counters (PCCR 13 and up, see cs_registers.sv,
+    // 11 and 12 count branch mispredictions and BTB misses).
+    // The accelerator events are cluster wide and count on every core, the bus
+    // events belong to the core itself.
+    localparam N_EXT_PERF  = 5;
+    localparam PERF_NPU    = 0;   // cycles the NPU is accessed (MMIO or instruction)
+    localparam PERF_IMC_PG = 1;   // cycles crossbar cells are programmed
+    localparam PERF_IMC_EV = 2;   // cycles inputs are applied to the crossbar
+    localparam PERF_STALL  = 3;   // data requests waiting for a grant
+    localparam PERF_MWAIT  = 4;   // granted data requests waiting for rvalid
+
+    localparam logic [N_SLAVES-1:0][31:0] SLAVE_BASE = {
+        32'(BUSSTAT_BASE), 32'(DMA_BASE), 32'(IMC_BASE), 32'(CYCLE_ADDR),
+        32'(NPU_BASE), 32'(UART_ADDR), 32'h0 };
+    localparam logic [N_SLAVES-1:0][31:0] SLAVE_END = {
+        32'(BUSSTAT_END), 32'(DMA_END), 32'(IMC_END), 32'(CYCLE_ADDR + 'h20),
+        32'(NPU_END), 32'(UART_ADDR + 4), 32'h0 };
+
     // Bus Signals
-    logic                  instr_req, instr_gnt, instr_rvalid;
-    logic [ADDR_WIDTH-1:0] instr_addr;
-    logic [127:0]          instr_rdata;
-    logic                  data_req, data_gnt, data_rvalid;
-    logic [ADDR_WIDTH-1:0] data_addr;
-    logic                  data_we;
-    logic [31:0]           data_wdata, data_rdata;
-    logic [3:0]            data_be;
-
-    // Address Decoding
-    logic is_uart, is_npu, is_cycle, is_ram, is_imc;
-    assign is_uart  = data_req && (data_addr == UART_ADDR);
-    assign is_npu   = data_req && ({10'b0,data_addr} >= NPU_BASE) && ({10'b0,data_addr} < NPU_END);
-    assign is_cycle = data_req && (data_addr == CYCLE_ADDR);
-    assign is_imc   = data_req && ({10'b0,data_addr} >= IMC_BASE) && ({10'b0,data_addr} < IMC_END);
-    assign is_ram   = data_req && !is_uart && !is_npu && !is_cycle && !is_imc;
+    logic [N_CORES-1:0]                 instr_req, instr_gnt, instr_rvalid;
+    logic [N_CORES-1:0][ADDR_WIDTH-1:0] instr_addr;
+    logic [N_CORES-1:0][127:0]          instr_rdata;
+    logic [N_CORES-1:0]                 fetch_req, fetch_gnt, fetch_rvalid;   // behind the I-caches
+    logic [N_CORES-1:0][ADDR_WIDTH-1:0] fetch_addr;
+    logic [127:0]                       fetch_rdata;
+    logic                               ram_fetch_req, ram_fetch_gnt, ram_fetch_rvalid;
+    logic [ADDR_WIDTH-1:0]              ram_fetch_addr;
+    logic [127:0]                       ram_fetch_rdata;
+    logic [N_CORES-1:0][31:0]           core_icache_hit, core_icache_miss, core_icache_refill;
+    logic [31:0]                        icache_hit_cnt, icache_miss_cnt, icache_refill_cnt;
+    logic [N_CORES-1:0]                 data_req, data_gnt, data_rvalid, data_we;
+    logic [N_CORES-1:0][ADDR_WIDTH-1:0] data_addr;
+    logic [N_CORES-1:0][31:0]           data_wdata, data_rdata;
+    logic [N_CORES-1:0][3:0]            data_be;
+    logic [N_CORES-1:0]                 core_busy;
+    logic [N_CORES-1:0][N_EXT_PERF-1:0] core_perf;
+    logic [N_CORES-1:0]                 data_outstanding;
+    logic                               imc_prog_busy, imc_eval_busy;
+
+    // Master ports, split between the TCDM, the event unit and the interconnect
+    logic [N_MASTERS-1:0]        mst_req, mst_we, mst_gnt, mst_rvalid, mst_tcdm, mst_eu;
+    logic [N_MASTERS-1:0][31:0]  mst_addr, mst_wdata, mst_rdata;
+    logic [N_MASTERS-1:0][3:0]   mst_be;
+
+    // TCDM ports
+    logic [N_MASTERS-1:0]        t_req, t_gnt, t_rvalid;
+    logic [N_MASTERS-1:0][31:0]  t_addr, t_rdata;
+    logic [TCDM_BANKS-1:0][31:0] tcdm_access_cnt, tcdm_conflict_cnt;
+
+    // Event unit ports, one per core
+    logic [N_CORES-1:0]          e_req, e_gnt, e_rvalid;
+    logic [N_CORES-1:0][31:0]    e_rdata;
+    logic [31:0]                 eu_src;
+    logic [N_CORES-1:0][31:0]    eu_irq;
+    logic [N_CORES-1:0]          eu_wake;
+
+    // Interconnect ports
+    logic [N_MASTERS-1:0]        m_req, m_we, m_gnt, m_rvalid;
+    logic [N_MASTERS-1:0][31:0]  m_addr, m_wdata, m_rdata;
+    logic [N_MASTERS-1:0][3:0]   m_be;
+    logic [N_SLAVES-1:0]         s_req, s_we, s_gnt, s_rvalid;
+    logic [N_SLAVES-1:0][31:0]   s_addr, s_wdata, s_rdata;
+    logic [N_SLAVES-1:0][3:0]    s_be;
+
+    // Bus statistics
+    logic                        busstat_clear;
+    logic [N_MASTERS-1:0]        bus_stall;
+    logic [N_MASTERS-1:0][31:0]  bus_stall_cnt;
+    logic [N_SLAVES-1:0][31:0]   bus_txn_cnt, bus_lat_cnt;
+
+    bus_interconnect #(
+        .N_MASTERS    (N_MASTERS),
+        .N_SLAVES     (N_SLAVES),
+        .ARB_MODE     (BUS_ARB_MODE),
+        .DEFAULT_SLAVE(S_RAM),
+        .SLAVE_BASE   (SLAVE_BASE),
+        .SLAVE_END    (SLAVE_END)
+    ) bus_i (
+        .clk(clk_i), .rst_n(rstn_i),
+        .m_req(m_req), .m_addr(m_addr), .m_we(m_we), .m_be(m_be), .m_wdata(m_wdata),
+        .m_gnt(m_gnt), .m_rvalid(m_rvalid), .m_rdata(m_rdata),
+        .s_req(s_req), .s_addr(s_addr), .s_we(s_we), .s_be(s_be), .s_wdata(s_wdata),
+        .s_gnt(s_gnt), .s_rvalid(s_rvalid), .s_rdata(s_rdata),
+        .clear_counters_i(busstat_clear), .stall_o(bus_stall),
+        .stall_cnt_o(bus_stall_cnt), .txn_cnt_o(bus_txn_cnt), .lat_cnt_o(bus_lat_cnt)
+    );
+
+    // Requests inside the TCDM window bypass the interconnect and go to the
+    // banked scratchpad, where masters on different banks proceed in parallel.
+    // Core requests to the event unit use the core's private port, so a core
+    // waiting at a barrier never blocks the shared bus.
+    localparam TCDM_END = TCDM_BASE + 4 * TCDM_BANKS * TCDM_BANK_WORDS;
+
+    always_comb begin
+        for (int m = 0; m < N_MASTERS; m++) begin
+            mst_tcdm[m]  = (mst_addr[m] >= 32'(TCDM_BASE)) && (mst_addr[m] < 32'(TCDM_END));
+            mst_eu[m]    = (m < N_CORES) && (mst_addr[m] >= 32'(EU_BASE)) && (mst_addr[m] < 32'(EU_END));
+            t_addr[m]    = mst_addr[m] - 32'(TCDM_BASE);
+            mst_rdata[m] = t_rvalid[m] ? t_rdata[m] : m_rdata[m];
+        end
+        for (int c = 0; c < N_CORES; c++)
+            if (e_rvalid[c]) mst_rdata[M_CORE+c] = e_rdata[c];
+    end
+
+    assign t_req      = mst_req &  mst_tcdm;
+    assign e_req      = mst_req[N_CORES-1:0] & mst_eu[N_CORES-1:0];
+    assign m_req      = mst_req & ~mst_tcdm & ~mst_eu;
+    assign m_addr     = mst_addr;
+    assign m_we       = mst_we;
+    assign m_be       = mst_be;
+    assign m_wdata    = mst_wdata;
+    assign mst_gnt    = m_gnt | t_gnt | N_MASTERS'(e_gnt);
+    assign mst_rvalid = m_rvalid | t_rvalid | N_MASTERS'(e_rvalid);
+
+    tcdm_banked #(
+        .N_PORTS   (N_MASTERS),
+        .N_BANKS   (TCDM_BANKS),
+        .BANK_WORDS(TCDM_BANK_WORDS)
+    ) tcdm_i (
+        .clk(clk_i), .rst_n(rstn_i),
+        .req(t_req), .addr(t_addr), .we(mst_we), .be(mst_be), .wdata(mst_wdata),
+        .gnt(t_gnt), .rvalid(t_rvalid), .rdata(t_rdata),
+        .clear_counters_i(busstat_clear),
+        .access_cnt_o(tcdm_access_cnt), .conflict_cnt_o(tcdm_conflict_cnt)
+    );
+
+    // Event unit: barrier, inter-core events, interrupts and sleep
+    logic npu_done, imc_done, dma_irq, timer_irq;
+    assign eu_src = (32'(dma_irq) << IRQ_DMA) | (32'(npu_done) << IRQ_NPU) |
+                    (32'(imc_done) << IRQ_IMC) | (32'(timer_irq) << IRQ_TIMER);
+
+    logic [N_CORES-1:0][5:0] e_addr;
+    always_comb
+        for (int c = 0; c < N_CORES; c++)
+            e_addr[c] = mst_addr[c][5:0];
+
+    event_unit #(.N_CORES(N_CORES)) eu_i (
+        .clk(clk_i), .rst_n(rstn_i),
+        .src_i(eu_src), .irq_o(eu_irq), .wake_o(eu_wake),
+        .req(e_req), .we(mst_we[N_CORES-1:0]), .addr(e_addr), .wdata(mst_wdata[N_CORES-1:0]),
+        .gnt(e_gnt), .rvalid(e_rvalid), .rdata(e_rdata)
+    );
+
+    // Core data ports
+    generate
+        for (genvar c = 0; c < N_CORES; c++) begin : core_data_gen
+            assign mst_req[M_CORE+c]   = data_req[c];
+            assign mst_addr[M_CORE+c]  = {{(32-ADDR_WIDTH){1'b0}}, data_addr[c]};
+            assign mst_we[M_CORE+c]    = data_we[c];
+            assign mst_be[M_CORE+c]    = data_be[c];
+            assign mst_wdata[M_CORE+c] = data_wdata[c];
+            assign data_gnt[c]         = mst_gnt[M_CORE+c];
+            assign data_rvalid[c]      = mst_rvalid[M_CORE+c];
+            assign data_rdata[c]       = mst_rdata[M_CORE+c];
+        end
+    endgenerate
+
+    // Slave responses. Peripherals grant immediately and answer one cycle
+    // later, the RAM follows its timing model.
+    logic        uart_rvalid, cycle_rvalid, npu_rvalid, imc_rvalid, dma_rvalid, busstat_rvalid, ram_rvalid;
+    logic [31:0] npu_rdata, imc_rdata, dma_rdata, busstat_rdata, ram_rdata, cycle_rdata;
+
+    logic        ram_gnt;
+    assign s_gnt    = {{(N_SLAVES-1){1'b1}}, ram_gnt};
+    assign s_rvalid = {busstat_rvalid, dma_rvalid, imc_rvalid, cycle_rvalid, npu_rvalid, uart_rvalid, ram_rvalid};
+    assign s_rdata  = {busstat_rdata, dma_rdata, imc_rdata, cycle_rdata, npu_rdata, 32'h0, ram_rdata};
 
     // UART
-    logic uart_rvalid;
     always_ff @(posedge clk_i or negedge rstn_i) begin
         if (!rstn_i) uart_rvalid <= 1'b0;
-        else         uart_rvalid <= is_uart;
+        else         uart_rvalid <= s_req[S_UART];
     end
 
-    // Cycle Counter
-    logic [31:0] cycle_ctr;
-    logic        cycle_rvalid;
-    always_ff @(posedge clk_i or negedge rstn_i) begin
-        if (!rstn_i) begin cycle_ctr <= 0; cycle_rvalid <= 0; end
-        else begin
-            cycle_ctr    <= cycle_ctr + 1;
-            cycle_rvalid <= is_cycle;
-        end
-    end
+    // Cycle Counter / Timer
+    timer_unit timer_i (
+        .clk(clk_i), .rst_n(rstn_i),
+        .req(s_req[S_CYCLE]), .we(s_we[S_CYCLE]), .addr(s_addr[S_CYCLE][4:0]),
+        .wdata(s_wdata[S_CYCLE]), .rdata(cycle_rdata), .rvalid(cycle_rvalid),
+        .irq_o(timer_irq)
+    );
+
+    // NPU, on the bus and on core 0's coprocessor port
+    logic        npu_cop_valid, npu_cop_ready;
+    logic [9:0]  npu_cop_op;
+    logic [31:0] npu_cop_operand_a, npu_cop_operand_b, npu_cop_result;
 
-    // NPU
-    logic [31:0] npu_rdata;
-    logic        npu_rvalid;
     npu_coprocessor npu_i (
         .clk(clk_i), .rst_n(rstn_i),
-        .cpu_write(is_npu && data_we), .cpu_byte_off(data_addr[6:0]), .cpu_wdata(data_wdata),
-        .cpu_read(is_npu && !data_we), .cpu_read_off(data_addr[6:0]), .cpu_rdata(npu_rdata)
+        .cpu_write(s_req[S_NPU] && s_we[S_NPU]), .cpu_byte_off(s_addr[S_NPU][6:0]), .cpu_wdata(s_wdata[S_NPU]),
+        .cpu_read(s_req[S_NPU] && !s_we[S_NPU]), .cpu_read_off(s_addr[S_NPU][6:0]), .cpu_rdata(npu_rdata),
+        .done_o(npu_done),
+        .cop_valid(npu_cop_valid), .cop_ready(npu_cop_ready), .cop_op(npu_cop_op),
+        .cop_operand_a(npu_cop_operand_a), .cop_operand_b(npu_cop_operand_b), .cop_result(npu_cop_result)
     );
     always_ff @(posedge clk_i or negedge rstn_i) begin
         if (!rstn_i) npu_rvalid <= 1'b0;
-        else         npu_rvalid <= is_npu;
+        else         npu_rvalid <= s_req[S_NPU];
     end
 
-    // IMC (ReRAM)
-    logic [31:0] imc_rdata;
-    logic        imc_rvalid;
-    imc_controller imc_i (
+    // IMC (ReRAM), configuration slave plus tile loader master
+    assign mst_we[M_IMC]    = 1'b0;
+    assign mst_be[M_IMC]    = 4'b1111;
+    assign mst_wdata[M_IMC] = 32'h0;
+    imc_controller #(
+        .CELL_MODEL(IMC_CELL_MODEL), .ADC_BITS(IMC_ADC_BITS)
+    ) imc_i (
+        .clk(clk_i), .rst_n(rstn_i),
+        .req(s_req[S_IMC]), .we(s_we[S_IMC]), .addr(s_addr[S_IMC]),
+        .wdata(s_wdata[S_IMC]), .rdata(imc_rdata), .gnt(), .rvalid(imc_rvalid),
+        .m_req(mst_req[M_IMC]), .m_addr(mst_addr[M_IMC]), .m_gnt(mst_gnt[M_IMC]),
+        .m_rvalid(mst_rvalid[M_IMC]), .m_rdata(mst_rdata[M_IMC]),
+        .done_o(imc_done), .prog_busy_o(imc_prog_busy), .eval_busy_o(imc_eval_busy)
+    );
+
+    // DMA Engine
+    dma_engine dma_i (
         .clk(clk_i), .rst_n(rstn_i),
-        .req(is_imc), .we(data_we), .addr({10'b0, data_addr}),
-        .wdata(data_wdata), .rdata(imc_rdata), .gnt(), .rvalid(imc_rvalid)
+        .req(s_req[S_DMA]), .we(s_we[S_DMA]), .addr(s_addr[S_DMA][5:0]),
+        .wdata(s_wdata[S_DMA]), .rdata(dma_rdata), .rvalid(dma_rvalid),
+        .m_req(mst_req[M_DMA]), .m_we(mst_we[M_DMA]), .m_addr(mst_addr[M_DMA]), .m_be(mst_be[M_DMA]),
+        .m_wdata(mst_wdata[M_DMA]), .m_gnt(mst_gnt[M_DMA]), .m_rvalid(mst_rvalid[M_DMA]), .m_rdata(mst_rdata[M_DMA]),
+        .irq_o(dma_irq)
+    );
+
+    // Bus statistics registers (read only, any write clears them)
+    //   0x00 + 4*m  master m stall cycles
+    //   0x20 + 4*s  slave s granted requests
+    //   0x40 + 4*s  slave s accumulated latency cycles
+    //   0x60 + 4*b  TCDM bank b conflicts
+    //   0x80 + 4*b  TCDM bank b accesses
+    //   0xA0        I-cache hits, 0xA4 misses, 0xA8 refill cycles
+    assign busstat_clear = s_req[S_BUSSTAT] && s_we[S_BUSSTAT];
+    always_ff @(posedge clk_i or negedge rstn_i) begin
+        if (!rstn_i) begin
+            busstat_rvalid <= 1'b0;
+            busstat_rdata  <= 32'h0;
+        end else begin
+            busstat_rvalid <= s_req[S_BUSSTAT];
+            if (s_req[S_BUSSTAT] && !s_we[S_BUSSTAT]) begin
+                automatic int idx = s_addr[S_BUSSTAT][4:2];
+                case (s_addr[S_BUSSTAT][7:5])
+                    3'd0:    busstat_rdata <= (idx < N_MASTERS)  ? bus_stall_cnt[idx]     : 32'h0;
+                    3'd1:    busstat_rdata <= (idx < N_SLAVES)   ? bus_txn_cnt[idx]       : 32'h0;
+                    3'd2:    busstat_rdata <= (idx < N_SLAVES)   ? bus_lat_cnt[idx]       : 32'h0;
+                    3'd3:    busstat_rdata <= (idx < TCDM_BANKS) ? tcdm_conflict_cnt[idx] : 32'h0;
+                    3'd4:    busstat_rdata <= (idx < TCDM_BANKS) ? tcdm_access_cnt[idx]   : 32'h0;
+                    3'd5:    case (idx)
+                                 0:       busstat_rdata <= icache_hit_cnt;
+                                 1:       busstat_rdata <= icache_miss_cnt;
+                                 2:       busstat_rdata <= icache_refill_cnt;
+                                 default: busstat_rdata <= 32'h0;
+                             endcase
+                    default: busstat_rdata <= 32'h0;
+                endcase
+            end
+        end
+    end
+
+    // Instruction caches, one per core, and the shared fetch port
+    generate
+        for (genvar c = 0; c < N_CORES; c++) begin : fetch_gen
+            if (ICACHE_EN) begin : icache_gen
+                icache #(
+                    .ADDR_WIDTH(ADDR_WIDTH), .SIZE_BYTES(ICACHE_SIZE), .WAYS(ICACHE_WAYS),
+                    .LINE_BYTES(ICACHE_LINE), .REFILL_LATENCY(ICACHE_REFILL_LAT)
+                ) icache_i (
+                    .clk(clk_i), .rst_n(rstn_i),
+                    .req_i(instr_req[c]), .addr_i(instr_addr[c]), .gnt_o(instr_gnt[c]),
+                    .rvalid_o(instr_rvalid[c]), .rdata_o(instr_rdata[c]),
+                    .mem_req_o(fetch_req[c]), .mem_addr_o(fetch_addr[c]), .mem_gnt_i(fetch_gnt[c]),
+                    .mem_rvalid_i(fetch_rvalid[c]), .mem_rdata_i(fetch_rdata),
+                    .clear_counters_i(busstat_clear),
+                    .hit_cnt_o(core_icache_hit[c]), .miss_cnt_o(core_icache_miss[c]),
+                    .refill_cnt_o(core_icache_refill[c])
+                );
+            end else begin : icache_bypass_gen
+                assign fetch_req[c]          = instr_req[c];
+                assign fetch_addr[c]         = instr_addr[c];
+                assign instr_gnt[c]          = fetch_gnt[c];
+                assign instr_rvalid[c]       = fetch_rvalid[c];
+                assign instr_rdata[c]        = fetch_rdata;
+                assign core_icache_hit[c]    = 32'h0;
+                assign core_icache_miss[c]   = 32'h0;
+                assign core_icache_refill[c] = 32'h0;
+            end
+        end
+    endgenerate
+
+    always_comb begin
+        icache_hit_cnt    = 32'h0;
+        icache_miss_cnt   = 32'h0;
+        icache_refill_cnt = 32'h0;
+        for (int c = 0; c < N_CORES; c++) begin
+            icache_hit_cnt    += core_icache_hit[c];
+            icache_miss_cnt   += core_icache_miss[c];
+            icache_refill_cnt += core_icache_refill[c];
+        end
+    end
+
+    fetch_arbiter #(.N_PORTS(N_CORES), .ADDR_WIDTH(ADDR_WIDTH)) fetch_arb_i (
+        .clk(clk_i), .rst_n(rstn_i),
+        .req_i(fetch_req), .addr_i(fetch_addr), .gnt_o(fetch_gnt),
+        .rvalid_o(fetch_rvalid), .rdata_o(fetch_rdata),
+        .mem_req_o(ram_fetch_req), .mem_addr_o(ram_fetch_addr), .mem_gnt_i(ram_fetch_gnt),
+        .mem_rvalid_i(ram_fetch_rvalid), .mem_rdata_i(ram_fetch_rdata)
     );
 
     // RAM
-    logic [31:0] ram_rdata;
-    logic        ram_rvalid;
-    ram #(.ADDR_WIDTH(ADDR_WIDTH-2)) ram_i (
+    ram #(
+        .ADDR_WIDTH(ADDR_WIDTH-2),
+        .INSTR_LATENCY(RAM_INSTR_LATENCY), .DATA_LATENCY(RAM_DATA_LATENCY),
+        .SLOW_BASE(RAM_SLOW_BASE), .SLOW_END(RAM_SLOW_END), .SLOW_LATENCY(RAM_SLOW_LATENCY),
+        .WAIT_MODE(RAM_WAIT_MODE)
+    ) ram_i (
         .clk(clk_i), .rst_n(rstn_i),
-        .instr_req_i(instr_req), .instr_addr_i(instr_addr), .instr_rdata_o(instr_rdata),
-        .instr_rvalid_o(instr_rvalid), .instr_gnt_o(instr_gnt),
-        .data_req_i(is_ram), .data_addr_i(data_addr), .data_we_i(data_we), .data_be_i(data_be),
-        .data_wdata_i(data_wdata), .data_rdata_o(ram_rdata), .data_rvalid_o(ram_rvalid), .data_gnt_o()
+        .instr_req_i(ram_fetch_req), .instr_addr_i(ram_fetch_addr), .instr_rdata_o(ram_fetch_rdata),
+        .instr_rvalid_o(ram_fetch_rvalid), .instr_gnt_o(ram_fetch_gnt),
+        .data_req_i(s_req[S_RAM]), .data_addr_i(s_addr[S_RAM][ADDR_WIDTH-1:0]), .data_we_i(s_we[S_RAM]),
+        .data_be_i(s_be[S_RAM]), .data_wdata_i(s_wdata[S_RAM]), .data_rdata_o(ram_rdata),
+        .data_rvalid_o(ram_rvalid), .data_gnt_o(ram_gnt)
     );
 
-    // Bus Mux
-    assign data_gnt = is_uart | is_npu | is_cycle | is_ram | is_imc;
-    assign data_rvalid = uart_rvalid | npu_rvalid | cycle_rvalid | ram_rvalid | imc_rvalid;
-    assign data_rdata = npu_rvalid ? npu_rdata : 
-                        cycle_rvalid ? cycle_ctr : 
-                        imc_rvalid ? imc_rdata : 
-                        ram_rdata;
+    // Performance counter events. A response in the cycle after the grant is
+    // not a wait, every further cycle (RAM latency and wait states, blocking
+    // event unit reads) is.
+    always_ff @(posedge clk_i or negedge rstn_i) begin
+        if (!rstn_i) data_outstanding <= '0;
+        else         data_outstanding <= data_gnt | (data_outstanding & ~data_rvalid);
+    end
+
+    always_comb begin
+        for (int c = 0; c < N_CORES; c++) begin
+            core_perf[c][PERF_NPU]    = s_req[S_NPU] || npu_cop_valid;
+            core_perf[c][PERF_IMC_PG] = imc_prog_busy;
+            core_perf[c][PERF_IMC_EV] = imc_eval_busy;
+            core_perf[c][PERF_STALL]  = data_req[c] && !data_gnt[c];
+            core_perf[c][PERF_MWAIT]  = data_outstanding[c] && !data_rvalid[c];
+        end
+    end
 
     // TB Output
-    assign data_req_o = is_uart;
-    assign data_we_o = data_we;
-    assign data_addr_o = {10'b0, data_addr};
-    assign data_wdata_o = data_wdata;
-
-    // RI5CY Core
-    riscv_core #(.INSTR_RDATA_WIDTH(INSTR_RDATA_WIDTH)) riscv_core_i (
-        .clk_i(clk_i), .rst_ni(rstn_i), .clock_en_i(1'b1), .test_en_i(1'b1),
-        .boot_addr_i(BOOT_ADDR), .core_id_i(4'h0), .cluster_id_i(6'h0),
-        .instr_addr_o(instr_addr), .instr_req_o(instr_req), .instr_rdata_i(instr_rdata),
-        .instr_gnt_i(instr_gnt), .instr_rvalid_i(instr_rvalid),
-        .data_addr_o(data_addr), .data_wdata_o(data_wdata), .data_we_o(data_we),
-        .data_req_o(data_req), .data_be_o(data_be), .data_rdata_i(data_rdata),
-        .data_gnt_i(data_gnt), .data_rvalid_i(data_rvalid), .data_err_i(1'b0),
-        .irq_i(irq_i), .debug_req_i(debug_req_i), .debug_gnt_o(debug_gnt_o),
-        .debug_rvalid_o(debug_rvalid_o), .debug_addr_i(debug_addr_i),
-        .debug_we_i(debug_we_i), .debug_wdata_i(debug_wdata_i), .debug_rdata_o(debug_rdata_o),
-        .debug_halted_o(debug_halted_o), .debug_halt_i(1'b0), .debug_resume_i(1'b0),
-        .fetch_enable_i(fetch_enable_i), .core_busy_o(core_busy_o), .ext_perf_counters_i()
-    );
+    assign data_req_o = s_req[S_UART];
+    assign data_we_o = s_we[S_UART];
+    assign data_addr_o = s_addr[S_UART];
+    assign data_wdata_o = s_wdata[S_UART];
+
+    // RI5CY Cores. All boot at BOOT_ADDR and tell themselves apart by
+    // mhartid; irq_i, the debug port and the NPU instructions go to core 0,
+    // they are illegal instructions on the others. The event unit gates
+    // fetch and clock of a core sleeping in WFI.
+    assign core_busy_o = |core_busy;
+
+    generate
+        for (genvar c = 0; c < N_CORES; c++) begin : core_gen
+            if (c == 0) begin : core0_gen
+                riscv_core #(
+                    .INSTR_RDATA_WIDTH(INSTR_RDATA_WIDTH), .N_EXT_PERF_COUNTERS(N_EXT_PERF),
+                    .PERF_CNT64(PERF_CNT64), .PERF_IRQ_ID(IRQ_PERF), .FAST_DIV(FAST_DIV),
+                    .MULH_MODE(MULH_MODE), .BRANCH_PREDICT(BRANCH_PREDICT), .BTB_ENTRIES(BTB_ENTRIES),
+                    .LOAD_FWD(LOAD_FWD), .COPROC(1)
+                ) riscv_core_i (
+                    .clk_i(clk_i), .rst_ni(rstn_i), .clock_en_i(eu_wake[c]), .test_en_i(1'b1),
+                    .boot_addr_i(BOOT_ADDR), .core_id_i(4'(c)), .cluster_id_i(6'h0),
+                    .instr_addr_o(instr_addr[c]), .instr_req_o(instr_req[c]), .instr_rdata_i(instr_rdata[c]),
+                    .instr_gnt_i(instr_gnt[c]), .instr_rvalid_i(instr_rvalid[c]),
+                    .data_addr_o(data_addr[c]), .data_wdata_o(data_wdata[c]), .data_we_o(data_we[c]),
+                    .data_req_o(data_req[c]), .data_be_o(data_be[c]), .data_rdata_i(data_rdata[c]),
+                    .data_gnt_i(data_gnt[c]), .data_rvalid_i(data_rvalid[c]), .data_err_i(1'b0),
+                    .cop_valid_o(npu_cop_valid), .cop_ready_i(npu_cop_ready), .cop_op_o(npu_cop_op),
+                    .cop_operand_a_o(npu_cop_operand_a), .cop_operand_b_o(npu_cop_operand_b),
+                    .cop_result_i(npu_cop_result),
+                    .irq_i(irq_i | eu_irq[c]), .debug_req_i(debug_req_i), .debug_gnt_o(debug_gnt_o),
+                    .debug_rvalid_o(debug_rvalid_o), .debug_addr_i(debug_addr_i),
+                    .debug_we_i(debug_we_i), .debug_wdata_i(debug_wdata_i), .debug_rdata_o(debug_rdata_o),
+                    .debug_halted_o(debug_halted_o), .debug_halt_i(1'b0), .debug_resume_i(1'b0),
+                    .fetch_enable_i(fetch_enable_i && eu_wake[c]), .core_busy_o(core_busy[c]), .ext_perf_counters_i(core_perf[c])
+                );
+            end else begin : worker_gen
+                riscv_core #(
+                    .INSTR_RDATA_WIDTH(INSTR_RDATA_WIDTH), .N_EXT_PERF_COUNTERS(N_EXT_PERF),
+                    .PERF_CNT64(PERF_CNT64), .PERF_IRQ_ID(IRQ_PERF), .FAST_DIV(FAST_DIV),
+                    .MULH_MODE(MULH_MODE), .BRANCH_PREDICT(BRANCH_PREDICT), .BTB_ENTRIES(BTB_ENTRIES),
+                    .LOAD_FWD(LOAD_FWD), .COPROC(0)
+                ) riscv_core_i (
+                    .clk_i(clk_i), .rst_ni(rstn_i), .clock_en_i(eu_wake[c]), .test_en_i(1'b1),
+                    .boot_addr_i(BOOT_ADDR), .core_id_i(4'(c)), .cluster_id_i(6'h0),
+                    .instr_addr_o(instr_addr[c]), .instr_req_o(instr_req[c]), .instr_rdata_i(instr_rdata[c]),
+                    .instr_gnt_i(instr_gnt[c]), .instr_rvalid_i(instr_rvalid[c]),
+                    .data_addr_o(data_addr[c]), .data_wdata_o(data_wdata[c]), .data_we_o(data_we[c]),
+                    .data_req_o(data_req[c]), .data_be_o(data_be[c]), .data_rdata_i(data_rdata[c]),
+                    .data_gnt_i(data_gnt[c]), .data_rvalid_i(data_rvalid[c]), .data_err_i(1'b0),
+                    .cop_valid_o(), .cop_ready_i(1'b1), .cop_op_o(), .cop_operand_a_o(), .cop_operand_b_o(),
+                    .cop_result_i(32'h0),
+                    .irq_i(eu_irq[c]), .debug_req_i(1'b0), .debug_gnt_o(),
+                    .debug_rvalid_o(), .debug_addr_i(15'h0),
+                    .debug_we_i(1'b0), .debug_wdata_i(32'h0), .debug_rdata_o(),
+                    .debug_halted_o(), .debug_halt_i(1'b0), .debug_resume_i(1'b0),
+                    .fetch_enable_i(fetch_enable_i && eu_wake[c]), .core_busy_o(core_busy[c]), .ext_perf_counters_i(core_perf[c])
+                );
+            end
+        end
+    endgenerate
 
 endmodule
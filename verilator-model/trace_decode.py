@@ -0,0 +1,322 @@
+#!/usr/bin/env python3
+"""
+Formats the binary instruction traces of riscv_tracer_bin.sv (written with
++trace_bin, see trace_dpi.cpp) as riscv_tracer text logs.
+
+  ./trace_decode.py trace_core_00_0.bin > trace_core_00_0.log
+
+The mnemonics come from the casex table of riscv_tracer.sv and the patterns
+of riscv_tracer_defines.sv, which are read at start-up so both tracers stay
+in step. A record carries rd and the first data address but no source
+register values, so the register reads (" x5:...") are not printed and a
+post-increment only shows its loaded rd. The Time column is cycle * --period;
+Verilator never advances $time, so the text tracer printed 0 there as well.
+"""
+
+import argparse
+import os
+import re
+import struct
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+RTL = os.path.join(HERE, '..')
+
+HEADER = struct.Struct('<8sII')
+RECORD = struct.Struct('<IIIIII')
+MAGIC = b'RVTRACE1'
+
+REG_WRITTEN = 1 << 8
+MEM_ACCESS = 1 << 9
+
+
+# ------------------------------------------------------------------
+# Mnemonic table from the RTL sources
+# ------------------------------------------------------------------
+def read_params(path):
+    params = {}
+    with open(path) as f:
+        for line in f:
+            line = line.split('//')[0]
+            m = re.match(r'\s*parameter\s+(\w+)\s*=\s*(.+?);', line)
+            if m:
+                params[m.group(1)] = m.group(2).strip()
+    return params
+
+
+def literal_bits(lit):
+    """N'bxxx / N'hxx literal as a string of 0, 1 and ? (MSB first)."""
+    m = re.match(r"(\d+)'([bh])([0-9a-fA-F?_]+)$", lit.replace(' ', ''))
+    if not m:
+        raise ValueError('unsupported literal ' + lit)
+    width, base, digits = int(m.group(1)), m.group(2), m.group(3).replace('_', '')
+    if base == 'h':
+        bits = ''.join('????' if d == '?' else format(int(d, 16), '04b') for d in digits)
+    else:
+        bits = digits
+    if len(bits) < width:
+        bits = ('?' if bits[0] == '?' else '0') * (width - len(bits)) + bits
+    return bits[-width:]
+
+
+def expr_bits(expr, params):
+    expr = expr.strip()
+    if expr.startswith('{'):
+        return ''.join(expr_bits(p, params) for p in expr.strip('{}').split(','))
+    if "'" in expr:
+        return literal_bits(expr)
+    return expr_bits(params[expr], params)
+
+
+def load_table():
+    params = read_params(os.path.join(RTL, 'include', 'riscv_defines.sv'))
+    params.update(read_params(os.path.join(RTL, 'include', 'riscv_tracer_defines.sv')))
+
+    table = []
+    in_case = False
+    with open(os.path.join(RTL, 'riscv_tracer.sv')) as f:
+        for line in f:
+            if 'casex (instr)' in line:
+                in_case = True
+                continue
+            if not in_case:
+                continue
+            if 'endcase' in line:
+                break
+            line = line.split('//')[0]
+            m = re.match(r'\s*(.+?):\s*trace\.(\w+)\((?:"([^"]*)")?\);', line)
+            if not m:
+                continue
+            sel, func, mnemonic = m.group(1).strip(), m.group(2), m.group(3)
+            bits = '?' * 32 if sel == 'default' else expr_bits(sel, params)
+            mask = int(''.join('0' if b == '?' else '1' for b in bits), 2)
+            value = int(''.join('1' if b == '1' else '0' for b in bits), 2)
+            table.append((mask, value, func, mnemonic))
+    return table, params
+
+
+# ------------------------------------------------------------------
+# riscv_tracer print functions
+# ------------------------------------------------------------------
+def bits(x, hi, lo):
+    return (x >> lo) & ((1 << (hi - lo + 1)) - 1)
+
+
+def sext(x, width):
+    return x - (1 << width) if x & (1 << (width - 1)) else x
+
+
+class Instr:
+    def __init__(self, instr, params):
+        i = instr
+        self.i = i
+        self.opcode = bits(i, 6, 0)
+        self.rd, self.rs1, self.rs2, self.rs3 = bits(i, 11, 7), bits(i, 19, 15), bits(i, 24, 20), bits(i, 29, 25)
+        self.imm_i = sext(bits(i, 31, 20), 12)
+        self.imm_iz = bits(i, 31, 20)
+        self.imm_s = sext((bits(i, 31, 25) << 5) | bits(i, 11, 7), 12)
+        self.imm_sb = sext((bits(i, 31, 31) << 12) | (bits(i, 7, 7) << 11) |
+                           (bits(i, 30, 25) << 5) | (bits(i, 11, 8) << 1), 13)
+        self.imm_u = i & 0xFFFFF000
+        self.imm_uj = sext((bits(i, 31, 31) << 20) | (bits(i, 19, 12) << 12) |
+                           (bits(i, 20, 20) << 11) | (bits(i, 30, 21) << 1), 21)
+        self.imm_z = self.rs1
+        self.imm_s2 = bits(i, 24, 20)
+        self.imm_s3 = bits(i, 29, 25)
+        self.imm_vs = (sext((bits(i, 24, 20) << 1) | bits(i, 25, 25), 6)) & 0xFFFFFFFF
+        self.imm_vu = (bits(i, 24, 20) << 1) | bits(i, 25, 25)
+        self.imm_clip = self.rd     # riscv_core connects instr_rdata_i[11:7]
+        self.op_load_post = int(expr_bits(params['OPCODE_LOAD_POST'], params), 2)
+        self.op_store_post = int(expr_bits(params['OPCODE_STORE_POST'], params), 2)
+
+
+def fmt(mnemonic, args):
+    return '%-16s %s' % (mnemonic, args)
+
+
+def p_mnemonic(d, m):      return m
+def p_r(d, m):             return fmt(m, 'x%d, x%d, x%d' % (d.rd, d.rs1, d.rs2))
+def p_addn(d, m):          return fmt(m, 'x%d, x%d, x%d, 0x%d' % (d.rd, d.rs1, d.rs2, d.imm_s3))
+def p_r1(d, m):            return fmt(m, 'x%d, x%d' % (d.rd, d.rs1))
+def p_clip(d, m):          return fmt(m, 'x%d, x%d, %d' % (d.rd, d.rs1, d.imm_clip))
+def p_i(d, m):             return fmt(m, 'x%d, x%d, %d' % (d.rd, d.rs1, d.imm_i))
+def p_iu(d, m):            return fmt(m, 'x%d, x%d, 0x%x' % (d.rd, d.rs1, d.imm_i & 0xFFFFFFFF))
+def p_u(d, m):             return fmt(m, 'x%d, 0x%x' % (d.rd, d.imm_u))
+def p_uj(d, m):            return fmt(m, 'x%d, %d' % (d.rd, d.imm_uj))
+def p_sb(d, m):            return fmt(m, 'x%d, x%d, %d' % (d.rs1, d.rs2, d.imm_sb))
+def p_sball(d, m):         return fmt(m, 'x%d, %d' % (d.rs1, d.imm_sb))
+def p_bit(d, m):           return fmt(m, 'x%d, x%d, %d, %d' % (d.rd, d.rs1, d.imm_s3, d.imm_s2))
+
+
+def p_csr(d, m):
+    csr = bits(d.i, 31, 20)
+    if not bits(d.i, 14, 14):
+        return fmt(m, 'x%d, x%d, 0x%03x' % (d.rd, d.rs1, csr))
+    return fmt(m, 'x%d, 0x%08x, 0x%03x' % (d.rd, d.imm_z, csr))
+
+
+def p_load(d, m):
+    size = bits(d.i, 14, 12)
+    if size == 0b111:
+        size = bits(d.i, 30, 28)
+    names = {0: 'lb', 1: 'lh', 2: 'lw', 4: 'lbu', 5: 'lhu', 6: 'p.elw'}
+    if size not in names:
+        return 'INVALID'
+    mn = names[size]
+    post = d.opcode == d.op_load_post
+    if bits(d.i, 14, 12) != 0b111:
+        if not post:
+            return fmt(mn, 'x%d, %d(x%d)' % (d.rd, d.imm_i, d.rs1))
+        return 'p.%-14s x%d, %d(x%d!)' % (mn, d.rd, d.imm_i, d.rs1)
+    if not post:
+        return fmt(mn, 'x%d, x%d(x%d)' % (d.rd, d.rs2, d.rs1))
+    return 'p.%-14s x%d, x%d(x%d!)' % (mn, d.rd, d.rs2, d.rs1)
+
+
+def p_store(d, m):
+    names = {0: 'sb', 1: 'sh', 2: 'sw'}
+    if bits(d.i, 13, 12) not in names:
+        return 'INVALID'
+    mn = names[bits(d.i, 13, 12)]
+    post = d.opcode == d.op_store_post
+    if not bits(d.i, 14, 14):
+        if not post:
+            return fmt(mn, 'x%d, %d(x%d)' % (d.rs2, d.imm_s, d.rs1))
+        return 'p.%-14s x%d, %d(x%d!)' % (mn, d.rs2, d.imm_s, d.rs1)
+    return 'p.%-14s x%d, x%d(x%d%s)' % (mn, d.rs2, d.rs3, d.rs1, '!' if post else '')
+
+
+def p_hwloop(d, m):
+    f3 = bits(d.i, 14, 12)
+    names = {0: 'lp.starti', 1: 'lp.endi', 2: 'lp.count', 3: 'lp.counti', 4: 'lp.setup', 5: 'lp.setupi'}
+    if f3 not in names:
+        return 'INVALID'
+    mn = names[f3]
+    if f3 in (0, 1):
+        return fmt(mn, '0x%d, 0x%x' % (d.rd, d.imm_iz))
+    if f3 == 2:
+        return fmt(mn, '0x%d, x%d' % (d.rd, d.rs1))
+    if f3 == 3:
+        return fmt(mn, 'x%d, 0x%x' % (d.rd, d.imm_iz))
+    if f3 == 4:
+        return fmt(mn, '0x%d, x%d, 0x%x' % (d.rd, d.rs1, d.imm_iz))
+    return fmt(mn, '0x%d, 0x%x, 0x%x' % (d.rd, d.imm_iz, d.rs1))
+
+
+def p_mul(d, m):
+    suf = ['u', 'uR', 'hhu', 'hhuR', 's', 'sR', 'hhs', 'hhsR'][(bits(d.i, 31, 30) << 1) | bits(d.i, 14, 14)]
+    mn = ('p.mac' if bits(d.i, 12, 12) else 'p.mul') + suf + ('N' if d.imm_s3 else '')
+    if bits(d.i, 29, 25):
+        return fmt(mn, 'x%d, x%d, x%d, %d' % (d.rd, d.rs1, d.rs2, d.imm_s3))
+    return fmt(mn, 'x%d, x%d, x%d' % (d.rd, d.rs1, d.rs2))
+
+
+VEC_OPS = {
+    0b000000: ('pv.add', 's'), 0b000010: ('pv.sub', 's'), 0b000100: ('pv.avg', 's'),
+    0b000110: ('pv.avgu', 'u'), 0b001000: ('pv.min', 's'), 0b001010: ('pv.minu', 'u'),
+    0b001100: ('pv.max', 's'), 0b001110: ('pv.maxu', 'u'), 0b010000: ('pv.srl', 's'),
+    0b010010: ('pv.sra', 's'), 0b010100: ('pv.sll', 's'), 0b010110: ('pv.or', 's'),
+    0b011000: ('pv.xor', 's'), 0b011010: ('pv.and', 's'), 0b011100: ('pv.abs', 's'),
+    0b011110: ('pv.extract', 's'), 0b100000: ('pv.extractu', 'u'), 0b100010: ('pv.insert', 's'),
+    0b110000: ('pv.shuffle', None), 0b110010: ('pv.shuffle2', None), 0b110100: ('pv.pack', None),
+    0b110110: ('pv.packhi', None), 0b111000: ('pv.packlo', None),
+    0b000001: ('pv.cmpeq', 's'), 0b000011: ('pv.cmpne', 's'), 0b000101: ('pv.cmpgt', 's'),
+    0b000111: ('pv.cmpge', 's'), 0b001001: ('pv.cmplt', 's'), 0b001011: ('pv.cmple', 's'),
+    0b001101: ('pv.cmpgtu', 'u'), 0b001111: ('pv.cmpgeu', 'u'), 0b010001: ('pv.cmpltu', 'u'),
+    0b010011: ('pv.cmpleu', 'u'),
+}
+
+
+def p_vec(d, m):
+    op = bits(d.i, 31, 26)
+    if op not in VEC_OPS:
+        return 'INVALID'
+    mn, imm_kind = VEC_OPS[op]
+    sci = {0b00: '', 0b10: '.sc', 0b11: '.sci'}.get(bits(d.i, 14, 13), '')
+    if mn in ('pv.extract', 'pv.extractu'):
+        sci = ''
+    if op == 0b110000:
+        imm = 'N/A'
+    elif imm_kind is None:
+        imm = ''
+    else:
+        imm = '0x%d' % (d.imm_vs if imm_kind == 's' else d.imm_vu)
+    hb = '.b' if bits(d.i, 12, 12) else '.h'
+    if sci == '.sci':
+        args = 'x%d, x%d, %s' % (d.rd, d.rs1, imm)
+    else:
+        args = 'x%d, x%d, x%d' % (d.rd, d.rs1, d.rs2)
+    return fmt(mn + sci + hb, args)
+
+
+PRINTERS = {
+    'printMnemonic': p_mnemonic, 'printRInstr': p_r, 'printAddNInstr': p_addn,
+    'printR1Instr': p_r1, 'printR3Instr': p_r, 'printClipInstr': p_clip,
+    'printIInstr': p_i, 'printIuInstr': p_iu, 'printUInstr': p_u, 'printUJInstr': p_uj,
+    'printSBInstr': p_sb, 'printSBallInstr': p_sball, 'printCSRInstr': p_csr,
+    'printBit1Instr': p_bit, 'printBit2Instr': p_bit, 'printLoadInstr': p_load,
+    'printStoreInstr': p_store, 'printHwloopInstr': p_hwloop, 'printMulInstr': p_mul,
+    'printVecInstr': p_vec,
+}
+
+
+def disasm(instr, table, params, cache):
+    s = cache.get(instr)
+    if s is None:
+        s = 'INVALID'
+        for mask, value, func, mnemonic in table:
+            if instr & mask == value:
+                s = PRINTERS[func](Instr(instr, params), mnemonic)
+                break
+        cache[instr] = s
+    return s
+
+
+# ------------------------------------------------------------------
+def decode(path, out, table, params, period):
+    cache = {}
+    with open(path, 'rb') as f:
+        magic, cluster_id, core_id = HEADER.unpack(f.read(HEADER.size))
+        if magic != MAGIC:
+            sys.exit('%s: not a binary trace' % path)
+        out.write('                Time          Cycles PC       Instr    Mnemonic\n')
+        wrap, last = 0, 0
+        while True:
+            chunk = f.read(RECORD.size * 65536)
+            if not chunk:
+                break
+            for cycle, pc, instr, wdata, addr, rd_flags in RECORD.iter_unpack(chunk):
+                if cycle < last:
+                    wrap += 1 << 32
+                last = cycle
+                cycles = wrap + cycle
+                line = '%20d %15d %08x %08x %-36s' % (cycles * period, cycles, pc, instr,
+                                                      disasm(instr, table, params, cache))
+                rd = rd_flags & 0x1F
+                if rd_flags & REG_WRITTEN and rd != 0:
+                    line += ' %s=%08x' % ((' x%d' if rd < 10 else 'x%d') % rd, wdata)
+                if rd_flags & MEM_ACCESS:
+                    line += '  PA:%08x' % addr
+                out.write(line + '\n')
+
+
+def main():
+    ap = argparse.ArgumentParser(description=__doc__.strip().splitlines()[0])
+    ap.add_argument('traces', nargs='+', help='trace_core_*.bin files')
+    ap.add_argument('-o', '--output', help='output file (one trace only), default stdout')
+    ap.add_argument('--period', type=int, default=0, help='time units per cycle for the Time column')
+    args = ap.parse_args()
+
+    table, params = load_table()
+    if args.output:
+        if len(args.traces) != 1:
+            sys.exit('-o takes a single trace')
+        with open(args.output, 'w') as out:
+            decode(args.traces[0], out, table, params, args.period)
+    else:
+        for path in args.traces:
+            decode(path, sys.stdout, table, params, args.period)
+
+
+if __name__ == '__main__':
+    main()